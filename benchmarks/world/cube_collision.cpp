@@ -2,9 +2,81 @@
 
 #include <inexor/vulkan-renderer/world/collision_query.hpp>
 #include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/indentation.hpp>
+
+#include <glm/gtx/intersect.hpp>
+#include <glm/gtx/norm.hpp>
+
+#include <limits>
+#include <random>
+#include <vector>
 
 namespace inexor::vulkan_renderer {
 
+namespace {
+
+/// The recursive ray cube collision check which was replaced by the parametric traversal, as a reference.
+/// Every child whose bounding sphere and bounding box are hit is descended into, and the hit whose center is the
+/// nearest one to the position is chosen.
+std::optional<world::RayCubeCollision<world::Cube>> recursive_collision_check(const world::Cube &cube,
+                                                                            const glm::vec3 pos, const glm::vec3 dir) {
+    if (cube.type() == world::Cube::Type::EMPTY) {
+        return std::nullopt;
+    }
+    auto intersection_distance{0.0f};
+    const auto bounding_sphere_radius = static_cast<float>(glm::sqrt(3) * cube.size()) / 2.0f;
+    if (!glm::intersectRaySphere(pos, dir, cube.center(), bounding_sphere_radius * bounding_sphere_radius,
+                                 intersection_distance) ||
+        !world::ray_box_collision(cube.bounding_box(), pos, dir)) {
+        return std::nullopt;
+    }
+    if (cube.type() == world::Cube::Type::SOLID) {
+        return std::make_optional<world::RayCubeCollision<world::Cube>>(cube, pos, dir);
+    }
+    if (cube.type() != world::Cube::Type::OCTANT) {
+        return std::nullopt;
+    }
+    std::size_t hit_candidate_count{0};
+    std::size_t collision_subcube_index{0};
+    float nearest_square_distance = std::numeric_limits<float>::max();
+    const auto &subcubes = cube.children();
+    for (std::size_t i = 0; i < subcubes.size() && hit_candidate_count < 4; i++) {
+        if (subcubes[i]->type() != world::Cube::Type::EMPTY && recursive_collision_check(*subcubes[i], pos, dir)) {
+            hit_candidate_count++;
+            const auto squared_distance = glm::distance2(subcubes[i]->center(), pos);
+            if (squared_distance < nearest_square_distance) {
+                collision_subcube_index = i;
+                nearest_square_distance = squared_distance;
+            }
+        }
+    }
+    if (hit_candidate_count > 0) {
+        return std::make_optional<world::RayCubeCollision<world::Cube>>(*subcubes[collision_subcube_index], pos, dir);
+    }
+    return std::nullopt;
+}
+
+struct Ray {
+    glm::vec3 position;
+    glm::vec3 direction;
+};
+
+/// Rays from random positions around the world towards random points inside of it.
+std::vector<Ray> random_rays(const world::Cube &world, const std::size_t count) {
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> outside(-2.0f * world.size(), 3.0f * world.size());
+    std::uniform_real_distribution<float> inside(0.0f, world.size());
+    std::vector<Ray> rays(count);
+    for (auto &ray : rays) {
+        ray.position = glm::vec3(outside(generator), outside(generator), outside(generator)) + world.position();
+        const glm::vec3 target = glm::vec3(inside(generator), inside(generator), inside(generator)) + world.position();
+        ray.direction = glm::normalize(target - ray.position);
+    }
+    return rays;
+}
+
+} // namespace
+
 void CubeCollision(benchmark::State &state) {
     for (auto _ : state) {
         const glm::vec3 world_pos{0, 0, 0};
@@ -20,4 +92,49 @@ void CubeCollision(benchmark::State &state) {
 
 BENCHMARK(CubeCollision);
 
+void RayCubeCollisionCheck(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    const auto rays = random_rays(*world, 1024);
+    for (auto _ : state) {
+        for (const auto &ray : rays) {
+            benchmark::DoNotOptimize(ray_cube_collision_check(*world, ray.position, ray.direction));
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * rays.size()));
+}
+
+BENCHMARK(RayCubeCollisionCheck)->DenseRange(3, 6)->Unit(benchmark::kMicrosecond);
+
+void RecursiveRayCubeCollisionCheck(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    const auto rays = random_rays(*world, 1024);
+    for (auto _ : state) {
+        for (const auto &ray : rays) {
+            benchmark::DoNotOptimize(recursive_collision_check(*world, ray.position, ray.direction));
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * rays.size()));
+}
+
+BENCHMARK(RecursiveRayCubeCollisionCheck)->DenseRange(3, 6)->Unit(benchmark::kMicrosecond);
+
+void RayNormalCubeCollision(benchmark::State &state) {
+    world::Cube cube(1.0f, {0, 0, 0});
+    cube.set_type(world::Cube::Type::NORMAL);
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<std::uint32_t> indent(0, 44);
+    for (std::uint8_t edge = 0; edge < world::Cube::EDGES; edge++) {
+        cube.set_indent(edge, world::Indentation(static_cast<std::uint8_t>(indent(generator))));
+    }
+    const auto rays = random_rays(cube, 1024);
+    for (auto _ : state) {
+        for (const auto &ray : rays) {
+            benchmark::DoNotOptimize(world::ray_normal_cube_collision(cube, ray.position, ray.direction));
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * rays.size()));
+}
+
+BENCHMARK(RayNormalCubeCollision)->Unit(benchmark::kMicrosecond);
+
 } // namespace inexor::vulkan_renderer
@@ -0,0 +1,40 @@
+#include <benchmark/benchmark.h>
+
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/greedy_mesher.hpp>
+
+namespace inexor::vulkan_renderer {
+
+void PolygonCacheMesher(benchmark::State &state) {
+    std::shared_ptr<world::Cube> world;
+    std::size_t triangles = 0;
+    for (auto _ : state) {
+        // Start with a new world in every iteration, so all polygon caches have to be built.
+        state.PauseTiming();
+        world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+        state.ResumeTiming();
+        const auto polygons = world->visible_polygons(true);
+        triangles = polygons.size();
+        benchmark::DoNotOptimize(polygons);
+    }
+    state.counters["triangles"] = static_cast<double>(triangles);
+}
+
+void GreedyMesher(benchmark::State &state) {
+    std::shared_ptr<world::Cube> world;
+    std::size_t triangles = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+        state.ResumeTiming();
+        const auto polygons = world::greedy_mesh(*world, true);
+        triangles = polygons.size();
+        benchmark::DoNotOptimize(polygons);
+    }
+    state.counters["triangles"] = static_cast<double>(triangles);
+}
+
+BENCHMARK(PolygonCacheMesher)->DenseRange(3, 5)->Unit(benchmark::kMillisecond);
+BENCHMARK(GreedyMesher)->DenseRange(3, 5)->Unit(benchmark::kMillisecond);
+
+} // namespace inexor::vulkan_renderer
@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+
+#include <inexor/vulkan-renderer/world/cube.hpp>
+
+namespace inexor::vulkan_renderer {
+
+namespace {
+
+std::size_t count_triangles(const std::vector<std::span<const world::Polygon>> &polygons) {
+    std::size_t triangles = 0;
+    for (const auto &range : polygons) {
+        triangles += range.size();
+    }
+    return triangles;
+}
+
+} // namespace
+
+// All polygons of the octree, whose number grows with the depth.
+void FullDetailPolygons(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    world->update_polygon_caches();
+    std::size_t triangles = 0;
+    for (auto _ : state) {
+        const auto polygons = world->polygons();
+        triangles = polygons.size();
+        benchmark::DoNotOptimize(polygons);
+    }
+    state.counters["triangles"] = static_cast<double>(triangles);
+}
+
+// The polygons seen from a camera next to the octree, whose number levels off with the depth.
+void LevelOfDetailPolygons(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    world->update_polygon_caches();
+    const glm::vec3 camera{-2.0f, 1.0f, 1.0f};
+    std::size_t triangles = 0;
+    for (auto _ : state) {
+        const auto polygons = world->lod_polygons(camera, 0.2f);
+        triangles = count_triangles(polygons);
+        benchmark::DoNotOptimize(polygons);
+    }
+    state.counters["triangles"] = static_cast<double>(triangles);
+}
+
+BENCHMARK(FullDetailPolygons)->DenseRange(3, 5)->Unit(benchmark::kMicrosecond);
+BENCHMARK(LevelOfDetailPolygons)->DenseRange(3, 5)->Unit(benchmark::kMicrosecond);
+
+} // namespace inexor::vulkan_renderer
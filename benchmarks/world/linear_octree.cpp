@@ -0,0 +1,126 @@
+#include <benchmark/benchmark.h>
+
+#include <inexor/vulkan-renderer/io/byte_stream.hpp>
+#include <inexor/vulkan-renderer/io/nxoc_parser.hpp>
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/linear_octree.hpp>
+#include <inexor/vulkan-renderer/world/octree_traversal.hpp>
+
+#include <utility>
+
+namespace inexor::vulkan_renderer {
+
+namespace {
+
+/// Estimate the heap memory of a pointer-based octree: every node is created by std::make_shared, which places a
+/// control block (a vtable pointer and two reference counters) in front of the cube.
+std::size_t cube_memory_usage(const world::Cube &cube) {
+    std::size_t bytes = sizeof(world::Cube) + sizeof(void *) + 2 * sizeof(std::uint32_t);
+    if (cube.type() == world::Cube::Type::OCTANT) {
+        for (const auto &child : cube.children()) {
+            bytes += cube_memory_usage(*child);
+        }
+    }
+    return bytes;
+}
+
+std::size_t cube_node_count(const world::Cube &cube) {
+    std::size_t count = 1;
+    if (cube.type() == world::Cube::Type::OCTANT) {
+        for (const auto &child : cube.children()) {
+            count += cube_node_count(*child);
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+void CubeOctreeMemory(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cube_memory_usage(*world));
+    }
+    const auto bytes = static_cast<double>(cube_memory_usage(*world));
+    state.counters["bytes"] = bytes;
+    state.counters["bytes_per_node"] = bytes / static_cast<double>(cube_node_count(*world));
+}
+
+void LinearOctreeMemory(benchmark::State &state) {
+    const world::LinearOctree octree(
+        *world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(octree.memory_usage());
+    }
+    const auto bytes = static_cast<double>(octree.memory_usage());
+    state.counters["bytes"] = bytes;
+    state.counters["bytes_per_node"] = bytes / static_cast<double>(octree.node_count());
+}
+
+void CubeOctreeTraversal(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    for (auto _ : state) {
+        // Cube::count_geometry_cubes() only reads the cached statistics, so walk the octree like LinearOctree does.
+        std::size_t count = 0;
+        world::traverse_pre_order(std::as_const(*world), [&](const world::Cube &cube) {
+            if (cube.type() == world::Cube::Type::SOLID || cube.type() == world::Cube::Type::NORMAL) {
+                count++;
+            }
+        });
+        benchmark::DoNotOptimize(count);
+    }
+}
+
+void LinearOctreeTraversal(benchmark::State &state) {
+    const world::LinearOctree octree(
+        *world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(octree.count_geometry_cubes());
+    }
+}
+
+void CubeOctreePolygons(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    for (auto _ : state) {
+        // Copy the polygon arena into a vector. The arena is only built in the first iteration, while the linear
+        // octree triangulates every time.
+        const auto arena = world->polygons(true);
+        std::vector<world::Polygon> polygons(arena.begin(), arena.end());
+        benchmark::DoNotOptimize(polygons);
+    }
+}
+
+void LinearOctreePolygons(benchmark::State &state) {
+    const world::LinearOctree octree(
+        *world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(octree.polygons());
+    }
+}
+
+void CubeOctreeDeserialize(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    const auto stream = io::NXOCParser().serialize(world, 0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(io::NXOCParser().deserialize(stream, world->size(), world->position()));
+    }
+}
+
+void LinearOctreeDeserialize(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    const auto stream = io::NXOCParser().serialize(world, 0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(io::NXOCParser().deserialize_linear(stream, world->size(), world->position()));
+    }
+}
+
+BENCHMARK(CubeOctreeMemory)->DenseRange(4, 5);
+BENCHMARK(LinearOctreeMemory)->DenseRange(4, 5);
+BENCHMARK(CubeOctreeTraversal)->DenseRange(4, 5);
+BENCHMARK(LinearOctreeTraversal)->DenseRange(4, 5);
+BENCHMARK(CubeOctreePolygons)->DenseRange(4, 5);
+BENCHMARK(LinearOctreePolygons)->DenseRange(4, 5);
+BENCHMARK(CubeOctreeDeserialize)->DenseRange(4, 5);
+BENCHMARK(LinearOctreeDeserialize)->DenseRange(4, 5);
+
+} // namespace inexor::vulkan_renderer
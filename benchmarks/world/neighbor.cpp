@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/linear_octree.hpp>
+
+namespace inexor::vulkan_renderer {
+
+namespace {
+
+constexpr std::array AXES{world::Cube::NeighborAxis::X, world::Cube::NeighborAxis::Y, world::Cube::NeighborAxis::Z};
+constexpr std::array DIRECTIONS{world::Cube::NeighborDirection::POSITIVE, world::Cube::NeighborDirection::NEGATIVE};
+
+std::vector<std::shared_ptr<world::Cube>> collect_cubes(const std::shared_ptr<world::Cube> &root) {
+    std::vector<std::shared_ptr<world::Cube>> cubes;
+    std::vector<std::shared_ptr<world::Cube>> stack{root};
+    while (!stack.empty()) {
+        auto cube = stack.back();
+        stack.pop_back();
+        if (cube->type() == world::Cube::Type::OCTANT) {
+            stack.insert(stack.end(), cube->children().begin(), cube->children().end());
+        }
+        cubes.push_back(std::move(cube));
+    }
+    return cubes;
+}
+
+} // namespace
+
+void CubeNeighbor(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    const auto cubes = collect_cubes(world);
+    for (auto _ : state) {
+        for (const auto &cube : cubes) {
+            for (const auto axis : AXES) {
+                for (const auto direction : DIRECTIONS) {
+                    benchmark::DoNotOptimize(cube->neighbor(axis, direction));
+                }
+            }
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * cubes.size() * 6));
+}
+
+void LinearOctreeNeighbor(benchmark::State &state) {
+    const world::LinearOctree octree(
+        *world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42));
+    std::vector<world::LinearOctree::NodeId> nodes{world::LinearOctree::ROOT};
+    for (std::size_t idx = 0; idx < nodes.size(); idx++) {
+        for (std::size_t child = 0; child < world::Cube::SUB_CUBES; child++) {
+            if (octree.type(nodes[idx]) == world::Cube::Type::OCTANT) {
+                nodes.push_back(octree.child(nodes[idx], child));
+            }
+        }
+    }
+    for (auto _ : state) {
+        for (const auto node : nodes) {
+            for (const auto axis : AXES) {
+                for (const auto direction : DIRECTIONS) {
+                    benchmark::DoNotOptimize(octree.neighbor(node, axis, direction));
+                }
+            }
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * nodes.size() * 6));
+}
+
+BENCHMARK(CubeNeighbor)->DenseRange(3, 4);
+BENCHMARK(LinearOctreeNeighbor)->DenseRange(3, 4);
+
+} // namespace inexor::vulkan_renderer
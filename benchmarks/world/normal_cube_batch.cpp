@@ -0,0 +1,75 @@
+#include <benchmark/benchmark.h>
+
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/normal_cube_batch.hpp>
+#include <inexor/vulkan-renderer/world/octree_traversal.hpp>
+
+#include <algorithm>
+
+namespace inexor::vulkan_renderer {
+
+namespace {
+
+std::vector<const world::Cube *> normal_cubes(const world::Cube &world) {
+    std::vector<const world::Cube *> cubes;
+    world::traverse_pre_order(world, [&](const world::Cube &cube) {
+        if (cube.type() == world::Cube::Type::NORMAL) {
+            cubes.push_back(&cube);
+        }
+    });
+    return cubes;
+}
+
+} // namespace
+
+// Triangulate the normal cubes one at a time.
+void TriangulateNormalCubes(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    const auto cubes = normal_cubes(*world);
+    for (auto _ : state) {
+        for (const auto *cube : cubes) {
+            cube->update_polygon_cache();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(cubes.size()));
+}
+
+// Triangulate the normal cubes like the polygon caches are updated, including the copy into the polygon arena.
+void TriangulateNormalCubeBatch(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    const auto cubes = normal_cubes(*world);
+    world::NormalCubeBatch batch;
+    world::PolygonArena arena(cubes.size() * std::tuple_size_v<world::CubePolygons>);
+    for (auto _ : state) {
+        batch.clear();
+        batch.add(cubes);
+        batch.compute();
+        for (std::size_t idx = 0; idx < cubes.size(); idx++) {
+            const world::CubePolygons polygons = batch.polygons(idx);
+            std::copy(polygons.begin(), polygons.end(),
+                      arena.begin() + static_cast<std::ptrdiff_t>(idx * std::tuple_size_v<world::CubePolygons>));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(cubes.size()));
+    state.SetLabel(std::to_string(world::NormalCubeBatch::lanes()) + " lanes");
+}
+
+// Only the corners and the face splits, without gathering the cubes and building the triangles.
+void ComputeNormalCubeBatch(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    const auto cubes = normal_cubes(*world);
+    world::NormalCubeBatch batch;
+    batch.add(cubes);
+    for (auto _ : state) {
+        batch.compute();
+        benchmark::DoNotOptimize(batch.face_splits(0));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(cubes.size()));
+    state.SetLabel(std::to_string(world::NormalCubeBatch::lanes()) + " lanes");
+}
+
+BENCHMARK(TriangulateNormalCubes)->DenseRange(3, 5)->Unit(benchmark::kMicrosecond);
+BENCHMARK(TriangulateNormalCubeBatch)->DenseRange(3, 5)->Unit(benchmark::kMicrosecond);
+BENCHMARK(ComputeNormalCubeBatch)->DenseRange(3, 5)->Unit(benchmark::kMicrosecond);
+
+} // namespace inexor::vulkan_renderer
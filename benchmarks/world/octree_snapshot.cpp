@@ -0,0 +1,36 @@
+#include <benchmark/benchmark.h>
+
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/octree_snapshot.hpp>
+
+namespace inexor::vulkan_renderer {
+
+void CloneWorld(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    world->update_polygon_caches();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(world->clone());
+    }
+}
+
+// A snapshot after every edit, which only copies the path to the edited cube.
+void SnapshotAfterEdit(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    world->update_polygon_caches();
+    benchmark::DoNotOptimize(world->snapshot());
+    auto cube = world;
+    while (cube->type() == world::Cube::Type::OCTANT) {
+        cube = cube->children()[5];
+    }
+    bool solid = false;
+    for (auto _ : state) {
+        solid = !solid;
+        cube->set_type(solid ? world::Cube::Type::SOLID : world::Cube::Type::EMPTY);
+        benchmark::DoNotOptimize(world->snapshot());
+    }
+}
+
+BENCHMARK(CloneWorld)->DenseRange(3, 5)->Unit(benchmark::kMicrosecond);
+BENCHMARK(SnapshotAfterEdit)->DenseRange(3, 5)->Unit(benchmark::kMicrosecond);
+
+} // namespace inexor::vulkan_renderer
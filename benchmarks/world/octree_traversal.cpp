@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/octree_traversal.hpp>
+
+#include <functional>
+
+namespace inexor::vulkan_renderer {
+
+// The recursive std::function traversal, which was used by Cube::polygons, NXOCParser and create_random_world.
+void RecursiveTraversal(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    for (auto _ : state) {
+        std::size_t geometry_cubes = 0;
+        std::function<void(const world::Cube &)> visit = [&visit, &geometry_cubes](const world::Cube &cube) {
+            if (cube.type() == world::Cube::Type::OCTANT) {
+                for (const auto &child : cube.children()) {
+                    visit(*child);
+                }
+                return;
+            }
+            geometry_cubes += cube.type() != world::Cube::Type::EMPTY ? 1 : 0;
+        };
+        visit(*world);
+        benchmark::DoNotOptimize(geometry_cubes);
+    }
+}
+
+void TemplateTraversal(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    for (auto _ : state) {
+        std::size_t geometry_cubes = 0;
+        world::traverse_pre_order(std::as_const(*world), [&geometry_cubes](const world::Cube &cube) {
+            const auto type = cube.type();
+            geometry_cubes += type == world::Cube::Type::SOLID || type == world::Cube::Type::NORMAL ? 1 : 0;
+        });
+        benchmark::DoNotOptimize(geometry_cubes);
+    }
+}
+
+void CollectPolygons(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    world->update_polygon_caches();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(world->polygons());
+    }
+}
+
+// Leaves are at grid level max_depth + 1, so 5 is a tree of depth 6.
+BENCHMARK(RecursiveTraversal)->DenseRange(4, 5)->Unit(benchmark::kMillisecond);
+BENCHMARK(TemplateTraversal)->DenseRange(4, 5)->Unit(benchmark::kMillisecond);
+BENCHMARK(CollectPolygons)->DenseRange(4, 5)->Unit(benchmark::kMillisecond);
+
+} // namespace inexor::vulkan_renderer
@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+
+#include <inexor/vulkan-renderer/tools/thread_pool.hpp>
+#include <inexor/vulkan-renderer/world/collision_query.hpp>
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/ray_packet.hpp>
+
+#include <glm/geometric.hpp>
+
+#include <vector>
+
+namespace inexor::vulkan_renderer {
+
+namespace {
+
+/// The rays of a camera in front of a world of size 1, one per pixel of a square image.
+void camera_rays(const std::size_t resolution, std::vector<glm::vec3> &positions, std::vector<glm::vec3> &directions) {
+    const glm::vec3 camera{0.5f, 0.5f, -1.0f};
+    for (std::size_t y = 0; y < resolution; y++) {
+        for (std::size_t x = 0; x < resolution; x++) {
+            const glm::vec3 target{static_cast<float>(x) / static_cast<float>(resolution - 1),
+                                   static_cast<float>(y) / static_cast<float>(resolution - 1), 0.0f};
+            positions.push_back(camera);
+            directions.push_back(glm::normalize(target - camera));
+        }
+    }
+}
+
+} // namespace
+
+void RayPacketCollisionCheck(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> directions;
+    camera_rays(64, positions, directions);
+    world::RayHits hits;
+    for (auto _ : state) {
+        world::ray_packet_collision_check(*world, positions, directions, hits);
+        benchmark::DoNotOptimize(hits.cubes.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * positions.size()));
+}
+
+BENCHMARK(RayPacketCollisionCheck)->DenseRange(3, 6)->Unit(benchmark::kMicrosecond);
+
+void RayPacketCollisionCheckParallel(benchmark::State &state) {
+    tools::ThreadPool thread_pool;
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> directions;
+    camera_rays(256, positions, directions);
+    world::RayHits hits;
+    for (auto _ : state) {
+        world::ray_packet_collision_check(thread_pool, *world, positions, directions, hits);
+        benchmark::DoNotOptimize(hits.cubes.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * positions.size()));
+}
+
+BENCHMARK(RayPacketCollisionCheckParallel)->DenseRange(3, 6)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+void SingleRayCollisionCheck(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> directions;
+    camera_rays(64, positions, directions);
+    for (auto _ : state) {
+        for (std::size_t idx = 0; idx < positions.size(); idx++) {
+            benchmark::DoNotOptimize(world::ray_cube_collision_check(*world, positions[idx], directions[idx]));
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * positions.size()));
+}
+
+BENCHMARK(SingleRayCollisionCheck)->DenseRange(3, 6)->Unit(benchmark::kMicrosecond);
+
+} // namespace inexor::vulkan_renderer
@@ -0,0 +1,40 @@
+#include <benchmark/benchmark.h>
+
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/sparse_voxel_dag.hpp>
+
+namespace inexor::vulkan_renderer {
+
+void SparseVoxelDagMemory(benchmark::State &state) {
+    const world::SparseVoxelDag dag(
+        *world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dag.memory_usage());
+    }
+    const auto bytes = static_cast<double>(dag.memory_usage());
+    state.counters["bytes"] = bytes;
+    state.counters["bytes_per_tree_node"] = bytes / static_cast<double>(dag.tree_node_count());
+    state.counters["unique_nodes"] = static_cast<double>(dag.node_count());
+}
+
+void SparseVoxelDagBuild(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    for (auto _ : state) {
+        const world::SparseVoxelDag dag(*world);
+        benchmark::DoNotOptimize(dag.node_count());
+    }
+}
+
+void SparseVoxelDagRayCollision(benchmark::State &state) {
+    const world::SparseVoxelDag dag(
+        *world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dag.ray_collision({-1.0f, 1.1f, 2.3f}, {1.0f, 0.2f, -0.1f}));
+    }
+}
+
+BENCHMARK(SparseVoxelDagMemory)->DenseRange(4, 5);
+BENCHMARK(SparseVoxelDagBuild)->DenseRange(4, 5);
+BENCHMARK(SparseVoxelDagRayCollision)->DenseRange(4, 5);
+
+} // namespace inexor::vulkan_renderer
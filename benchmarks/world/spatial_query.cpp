@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/spatial_query.hpp>
+
+#include <random>
+
+namespace inexor::vulkan_renderer {
+
+namespace {
+
+std::vector<glm::vec3> random_points(const std::size_t count) {
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> distribution(0.0f, 32.0f);
+    std::vector<glm::vec3> points(count);
+    for (auto &point : points) {
+        point = {distribution(generator), distribution(generator), distribution(generator)};
+    }
+    return points;
+}
+
+} // namespace
+
+void FindLeaf(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    const auto points = random_points(1024);
+    for (auto _ : state) {
+        for (const auto &point : points) {
+            benchmark::DoNotOptimize(world::find_leaf(std::as_const(*world), point));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(points.size()));
+}
+
+// Boxes of the size of a leaf at the maximum depth.
+void QueryBox(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    const auto points = random_points(1024);
+    const float size = world->size() / static_cast<float>(1u << (state.range(0) + 1));
+    std::vector<const world::Cube *> leaves;
+    for (auto _ : state) {
+        for (const auto &point : points) {
+            leaves.clear();
+            world::query_box(*world, {point, point + size}, leaves);
+            benchmark::DoNotOptimize(leaves.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(points.size()));
+}
+
+void QuerySphere(benchmark::State &state) {
+    const auto world = world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42);
+    const auto points = random_points(1024);
+    const float radius = world->size() / static_cast<float>(1u << (state.range(0) + 1));
+    std::vector<const world::Cube *> leaves;
+    for (auto _ : state) {
+        for (const auto &point : points) {
+            leaves.clear();
+            world::query_sphere(*world, point, radius, leaves);
+            benchmark::DoNotOptimize(leaves.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(points.size()));
+}
+
+BENCHMARK(FindLeaf)->DenseRange(3, 5)->Unit(benchmark::kMicrosecond);
+BENCHMARK(QueryBox)->DenseRange(3, 5)->Unit(benchmark::kMicrosecond);
+BENCHMARK(QuerySphere)->DenseRange(3, 5)->Unit(benchmark::kMicrosecond);
+
+} // namespace inexor::vulkan_renderer
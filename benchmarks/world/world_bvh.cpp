@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+
+#include <inexor/vulkan-renderer/world/collision_query.hpp>
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/world_bvh.hpp>
+
+#include <glm/geometric.hpp>
+
+#include <limits>
+#include <vector>
+
+namespace inexor::vulkan_renderer {
+
+namespace {
+
+/// Random worlds of size 1 in a row along the x axis.
+std::vector<std::shared_ptr<world::Cube>> row_of_worlds(const std::size_t count) {
+    std::vector<std::shared_ptr<world::Cube>> worlds;
+    for (std::size_t idx = 0; idx < count; idx++) {
+        worlds.push_back(world::create_random_world(3, {static_cast<float>(idx) * 1.5f, 0, 0}, idx));
+    }
+    return worlds;
+}
+
+/// A ray along the row of worlds, which hits one of the first worlds.
+const glm::vec3 RAY_POSITION{-1.0f, 0.5f, 0.5f};
+const glm::vec3 RAY_DIRECTION = glm::normalize(glm::vec3{1.0f, 0.01f, 0.02f});
+
+} // namespace
+
+void WorldBvhCollisionCheck(benchmark::State &state) {
+    const world::WorldBvh bvh(row_of_worlds(static_cast<std::size_t>(state.range(0))));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bvh.ray_cube_collision_check(RAY_POSITION, RAY_DIRECTION));
+    }
+}
+
+BENCHMARK(WorldBvhCollisionCheck)->RangeMultiplier(4)->Range(1, 256)->Unit(benchmark::kMicrosecond);
+
+/// The nearest hit of all worlds without a hierarchy, every world is checked.
+void LinearWorldsCollisionCheck(benchmark::State &state) {
+    const auto worlds = row_of_worlds(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        float nearest = std::numeric_limits<float>::infinity();
+        for (const auto &world : worlds) {
+            if (const auto collision = world::ray_cube_collision_check(*world, RAY_POSITION, RAY_DIRECTION)) {
+                nearest = std::min(nearest, glm::distance(collision->intersection(), RAY_POSITION));
+            }
+        }
+        benchmark::DoNotOptimize(nearest);
+    }
+}
+
+BENCHMARK(LinearWorldsCollisionCheck)->RangeMultiplier(4)->Range(1, 256)->Unit(benchmark::kMicrosecond);
+
+} // namespace inexor::vulkan_renderer
@@ -0,0 +1,34 @@
+#include <benchmark/benchmark.h>
+
+#include <inexor/vulkan-renderer/tools/thread_pool.hpp>
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/world_generator.hpp>
+
+namespace inexor::vulkan_renderer {
+
+void CreateRandomWorld(benchmark::State &state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(world::create_random_world(static_cast<std::uint32_t>(state.range(0)), {0, 0, 0}, 42));
+    }
+}
+
+void GenerateWorld(benchmark::State &state) {
+    const world::WorldGenerator generator(42, static_cast<std::uint32_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(generator.generate({0, 0, 0}));
+    }
+}
+
+void GenerateWorldParallel(benchmark::State &state) {
+    tools::ThreadPool thread_pool;
+    const world::WorldGenerator generator(42, static_cast<std::uint32_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(generator.generate(thread_pool, 2, {0, 0, 0}));
+    }
+}
+
+BENCHMARK(CreateRandomWorld)->DenseRange(3, 5)->Unit(benchmark::kMillisecond);
+BENCHMARK(GenerateWorld)->DenseRange(3, 5)->Unit(benchmark::kMillisecond);
+BENCHMARK(GenerateWorldParallel)->DenseRange(3, 5)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+} // namespace inexor::vulkan_renderer
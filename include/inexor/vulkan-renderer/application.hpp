@@ -2,8 +2,15 @@
 
 #include "inexor/vulkan-renderer/input/keyboard_mouse_data.hpp"
 #include "inexor/vulkan-renderer/renderer.hpp"
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
+#include "inexor/vulkan-renderer/world/chunk_manager.hpp"
 #include "inexor/vulkan-renderer/world/collision_query.hpp"
 #include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/greedy_mesher.hpp"
+#include "inexor/vulkan-renderer/world/world_bvh.hpp"
+#include "inexor/vulkan-renderer/world/world_generator.hpp"
+
+#include <unordered_map>
 
 // Forward declarations
 namespace inexor::vulkan_renderer::input {
@@ -23,6 +30,47 @@ class Application : public VulkanRenderer {
     bool m_enable_validation_layers{true};
     /// Inexor engine supports a variable number of octrees.
     std::vector<std::shared_ptr<world::Cube>> m_worlds;
+    /// The bounding volume hierarchy over m_worlds for the camera ray, rebuilt whenever m_worlds changes.
+    world::WorldBvh m_world_bvh;
+    /// Worker threads for octree processing, such as rebuilding the polygon caches.
+    tools::ThreadPool m_thread_pool;
+    /// Pages the octrees of a map in and out around the camera, nullptr if random worlds are used instead.
+    std::unique_ptr<world::ChunkManager> m_chunk_manager;
+    /// The size of the octree of each chunk of the map.
+    float m_chunk_size{8.0f};
+    /// The maximum number of chunks which are kept in memory.
+    std::size_t m_chunk_budget{256};
+    /// The distance up to which the chunks around the camera are loaded.
+    float m_view_distance{48.0f};
+    /// The terrain of the generated worlds, std::nullopt for randomly filled worlds.
+    std::optional<world::Heightfield> m_heightfield;
+    /// Depth at which the octrees are split into subtrees for the parallel polygon cache rebuild.
+    std::size_t m_polygon_split_depth{2};
+    /// Leave out the faces of octree geometry which are covered by solid neighbors.
+    bool m_cull_hidden_faces{true};
+    /// The way the octree geometry is turned into polygons.
+    world::Mesher m_mesher{world::Mesher::POLYGON_CACHE};
+    /// Depth of the subtrees of the octrees which are culled and drawn separately.
+    std::size_t m_octree_chunk_depth{2};
+    /// Draw far away octants as boxes, ignored by the greedy mesher.
+    bool m_level_of_detail{false};
+    /// The camera position for which the level of detail of the octree geometry was selected.
+    glm::vec3 m_lod_position{0.0f};
+    /// Octants whose size divided by their distance to the camera is smaller are drawn as boxes.
+    float m_lod_size_ratio{0.1f};
+    /// How far the camera has to move until the level of detail is selected again.
+    float m_lod_update_distance{1.0f};
+    /// The indices of the geometry of each subtree, which are consecutive because every vertex gets its own index.
+    std::unordered_map<const world::Cube *, IndexRange> m_octree_chunks;
+    /// The geometry of one world, whose indices start at its first vertex.
+    struct OctreeMesh {
+        std::vector<OctreeGpuVertex> vertices;
+        std::vector<std::uint32_t> indices;
+        /// The index ranges of the subtrees, relative to the first index of the mesh.
+        std::unordered_map<const world::Cube *, IndexRange> chunks;
+    };
+    /// The meshes of m_worlds, which are kept so only added worlds have to be meshed when the chunks are paged.
+    std::unordered_map<std::shared_ptr<const world::Cube>, OctreeMesh> m_octree_meshes;
 
     // If the user specified command line argument "--stop-on-validation-message", the program will call
     // std::abort(); after reporting a validation layer (error) message.
@@ -36,11 +84,28 @@ class Application : public VulkanRenderer {
     void load_shaders();
     /// @param initialize Initialize worlds with a fixed seed, which is useful for benchmarking and testing
     void load_octree_geometry(bool initialize);
+    /// Append the vertices of a subtree of a world, with the mesher and level of detail which are selected.
+    void mesh_chunk(const world::Cube &chunk, std::vector<OctreeGpuVertex> &vertices);
+    /// Generate the vertices and indices of a world and the index ranges of its subtrees.
+    void mesh_world(const world::Cube &world, OctreeMesh &mesh);
+    /// @brief Mesh the subtrees of the worlds again whose level of detail changed since the previous position.
+    /// The other subtrees keep their vertices. Call update_octree_vertices() afterwards to gather the meshes.
+    /// @param previous_lod_position The position for which the level of detail of the meshes was selected.
+    /// @return Whether any mesh changed.
+    [[nodiscard]] bool remesh_octree_lod(const glm::vec3 &previous_lod_position);
+    /// @brief Gather the meshes of all worlds into the octree vertices and indices.
+    /// @param remesh_all Mesh all worlds again, otherwise only the worlds which have no mesh yet are meshed.
+    void update_octree_vertices(bool remesh_all);
     void setup_vulkan_debug_callback();
     void setup_window_and_input_callbacks();
     void update_imgui_overlay();
     void update_uniform_buffers();
-    /// Use the camera's position and view direction vector to check for ray-octree collisions with all octrees.
+    /// Depth of the subtrees of the octrees which are culled and drawn separately.
+    /// The greedy mesher merges faces across the whole octree, so then it is drawn as a whole.
+    [[nodiscard]] std::size_t octree_chunk_depth() const;
+    /// Collect the index ranges of the octree subtrees which intersect the view frustum of the camera.
+    void cull_octree_chunks();
+    /// Use the camera's position and view direction vector to find the nearest ray-octree collision of all octrees.
     void check_octree_collisions();
     void process_mouse_input();
 
@@ -2,11 +2,14 @@
 
 #include "inexor/vulkan-renderer/io/octree_parser.hpp"
 
+#include <glm/vec3.hpp>
+
 #include <memory>
 
 // Forward declaration
 namespace inexor::vulkan_renderer::world {
 class Cube;
+class LinearOctree;
 } // namespace inexor::vulkan_renderer::world
 
 // Forward declaration
@@ -25,12 +28,28 @@ private:
     [[nodiscard]] ByteStream serialize_impl(std::shared_ptr<const world::Cube> cube);
     /// Specific version deserialization.
     template <std::size_t version>
-    [[nodiscard]] std::shared_ptr<world::Cube> deserialize_impl(const ByteStream &stream);
+    [[nodiscard]] std::shared_ptr<world::Cube> deserialize_impl(const ByteStream &stream, float size,
+                                                                const glm::vec3 &position);
+    /// Specific version serialization of a linear octree.
+    template <std::size_t version>
+    [[nodiscard]] ByteStream serialize_linear_impl(const world::LinearOctree &octree);
+    /// Specific version deserialization into a linear octree.
+    template <std::size_t version>
+    [[nodiscard]] world::LinearOctree deserialize_linear_impl(const ByteStream &stream, float size,
+                                                              const glm::vec3 &position);
 
 public:
     /// Serialization of an octree.
     [[nodiscard]] ByteStream serialize(std::shared_ptr<const world::Cube> cube, std::uint32_t version) final;
     /// Deserialization of an octree.
     [[nodiscard]] std::shared_ptr<world::Cube> deserialize(const ByteStream &stream) final;
+    /// Deserialization of an octree whose root cube is placed at the given position.
+    [[nodiscard]] std::shared_ptr<world::Cube> deserialize(const ByteStream &stream, float size,
+                                                           const glm::vec3 &position);
+    /// Serialization of a linear octree, the stream is the same as the one of the pointer-based octree.
+    [[nodiscard]] ByteStream serialize(const world::LinearOctree &octree, std::uint32_t version);
+    /// Deserialization of an octree into a linear octree, without creating a pointer-based octree first.
+    [[nodiscard]] world::LinearOctree deserialize_linear(const ByteStream &stream, float size,
+                                                         const glm::vec3 &position);
 };
 } // namespace inexor::vulkan_renderer::io
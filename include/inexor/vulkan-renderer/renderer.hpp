@@ -50,6 +50,14 @@ protected:
     std::vector<OctreeGpuVertex> m_octree_vertices;
     std::vector<std::uint32_t> m_octree_indices;
 
+    /// A range of m_octree_indices.
+    struct IndexRange {
+        std::uint32_t first_index{0};
+        std::uint32_t index_count{0};
+    };
+    /// The ranges of m_octree_indices which are drawn by the main stage, one draw call each.
+    std::vector<IndexRange> m_octree_draw_ranges;
+
     TextureResource *m_back_buffer{nullptr};
 
     // Render graph buffers for octree geometry.
@@ -57,7 +65,8 @@ protected:
     BufferResource *m_vertex_buffer{nullptr};
 
     void setup_render_graph();
-    void generate_octree_indices();
+    /// Merge the equal vertices and generate the indices, one per original vertex and in the same order.
+    static void generate_octree_indices(std::vector<OctreeGpuVertex> &vertices, std::vector<std::uint32_t> &indices);
     void recreate_swapchain();
     void render_frame();
 
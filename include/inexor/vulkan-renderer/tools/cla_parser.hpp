@@ -48,9 +48,24 @@ public:
 class CommandLineArgumentParser {
     // TODO: Allow runtime addition of argument templates.
     const std::vector<CommandLineArgumentTemplate> m_accepted_args{
+        // Loads the chunks of the map around the camera from a directory.
+        {"--chunk-directory", true},
+
         // Specifies which GPU to use (by array index).
         {"--gpu", true},
 
+        // Merges coplanar faces of solid octree cubes into larger rectangles.
+        {"--greedy-meshing", false},
+
+        // Generates the worlds as terrain from noise instead of filling them randomly.
+        {"--heightfield", false},
+
+        // Draws far away octants of the octree as boxes.
+        {"--level-of-detail", false},
+
+        // Keeps the faces of octree cubes which are covered by solid neighbors.
+        {"--no-hidden-face-culling", false},
+
         // Disables the use of the special data transfer queue (forces use of the graphics queue).
         {"--no-separate-data-queue", false},
 
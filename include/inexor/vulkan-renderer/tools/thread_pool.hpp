@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace inexor::vulkan_renderer::tools {
+
+/// @brief A work-stealing thread pool.
+/// Every worker owns a task queue. A worker takes the newest task from its own queue and steals the oldest task of
+/// another worker once its own queue is empty. Tasks which are submitted from inside a worker go to its own queue.
+class ThreadPool {
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<TaskQueue>> m_queues;
+    std::vector<std::thread> m_workers;
+    /// The queue which receives the next task submitted from outside of the pool.
+    std::atomic<std::size_t> m_next_queue{0};
+    /// Number of tasks which were submitted, but not taken from a queue yet.
+    std::atomic<std::size_t> m_pending_tasks{0};
+    std::mutex m_wake_mutex;
+    std::condition_variable m_wake;
+    bool m_stop{false};
+
+    void push(std::function<void()> task);
+    /// Take a task from the given queue first and steal from the other queues otherwise.
+    [[nodiscard]] bool try_pop(std::size_t queue_index, std::function<void()> &task);
+    void worker_loop(std::size_t queue_index);
+
+public:
+    /// @param thread_count The number of worker threads, at least one worker is created.
+    explicit ThreadPool(std::size_t thread_count = std::thread::hardware_concurrency());
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool(ThreadPool &&) = delete;
+    /// Finishes all pending tasks before the workers are joined.
+    ~ThreadPool();
+
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    ThreadPool &operator=(ThreadPool &&) = delete;
+
+    [[nodiscard]] std::size_t thread_count() const noexcept {
+        return m_workers.size();
+    }
+
+    /// @brief Submit a task.
+    /// @param function The task, which must not take any arguments.
+    /// @return A future which receives the result or the exception of the task.
+    template <typename Function>
+    [[nodiscard]] std::future<std::invoke_result_t<Function>> submit(Function &&function);
+
+    /// @brief Run one pending task on the calling thread.
+    /// @return ``True`` if a task was run, ``false`` if there was nothing to do.
+    bool run_pending_task();
+
+    /// @brief Block until the future is ready.
+    /// The calling thread runs pending tasks meanwhile and only blocks once none is left, so this can also be called
+    /// from inside a task. The task of the future is running on another thread then, which runs whatever it submits
+    /// itself if no worker is free.
+    /// @param future The future of a task which was submitted to this pool.
+    template <typename Result>
+    void wait(const std::future<Result> &future);
+
+    /// @brief Call ``function(index)`` for every index in [0, count) and block until all calls returned.
+    /// The calling thread helps with the work, so this can also be called from inside a task.
+    /// @note The first exception thrown by one of the calls is rethrown after all calls finished.
+    template <typename Function>
+    void parallel_for(std::size_t count, const Function &function);
+};
+
+template <typename Function>
+std::future<std::invoke_result_t<Function>> ThreadPool::submit(Function &&function) {
+    using Result = std::invoke_result_t<Function>;
+    // std::function needs a copyable callable, so the packaged task is shared.
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+    auto future = task->get_future();
+    push([task] { (*task)(); });
+    return future;
+}
+
+template <typename Result>
+void ThreadPool::wait(const std::future<Result> &future) {
+    while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        if (!run_pending_task()) {
+            // Nothing is queued, so the task was already taken by another thread and there is nothing to help with.
+            future.wait();
+            return;
+        }
+    }
+}
+
+template <typename Function>
+void ThreadPool::parallel_for(const std::size_t count, const Function &function) {
+    std::vector<std::future<void>> futures;
+    futures.reserve(count);
+    for (std::size_t index = 0; index < count; index++) {
+        futures.push_back(submit([&function, index] { function(index); }));
+    }
+    // Wait for all calls before rethrowing anything, as the tasks reference the function.
+    for (const auto &future : futures) {
+        wait(future);
+    }
+    for (auto &future : futures) {
+        future.get();
+    }
+}
+
+} // namespace inexor::vulkan_renderer::tools
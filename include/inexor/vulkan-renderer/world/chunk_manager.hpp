@@ -0,0 +1,100 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/io/byte_stream.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// Forward declaration
+namespace inexor::vulkan_renderer::tools {
+class ThreadPool;
+} // namespace inexor::vulkan_renderer::tools
+
+namespace inexor::vulkan_renderer::world {
+
+// Forward declaration
+class Cube;
+
+/// @brief Pages the chunks of a large map in and out around the camera.
+/// The map is a regular grid of octrees with the same size, which are keyed by their grid position. Only the chunks
+/// within the view distance are requested, and at most a fixed number of chunks is kept, so memory and load times
+/// depend on the view distance instead of the size of the map. The chunks are read and deserialized with the
+/// NXOCParser on the thread pool, which also builds their polygon caches.
+class ChunkManager {
+public:
+    /// The position of a chunk in units of the chunk size.
+    using GridPosition = std::array<std::int32_t, 3>;
+    /// Read the serialized octree of a chunk, std::nullopt if there is no chunk at this position.
+    /// It is called on the threads of the thread pool.
+    using ChunkLoader = std::function<std::optional<io::ByteStream>(const GridPosition &)>;
+
+private:
+    struct Chunk {
+        /// nullptr while loading or if there is no chunk at this position.
+        std::shared_ptr<Cube> cube;
+        /// Only valid while loading.
+        std::future<std::shared_ptr<Cube>> pending;
+        /// Distance of the chunk to the camera at the last update.
+        float distance{0.0f};
+    };
+
+    tools::ThreadPool &m_thread_pool;
+    ChunkLoader m_loader;
+    float m_chunk_size;
+    std::size_t m_resident_budget;
+    std::map<GridPosition, Chunk> m_chunks;
+
+    /// Start loading a chunk on the thread pool.
+    [[nodiscard]] std::future<std::shared_ptr<Cube>> load(const GridPosition &grid_position);
+
+public:
+    /// @param thread_pool The thread pool which loads the chunks, it must outlive the chunk manager.
+    /// @param loader The source of the serialized chunks.
+    /// @param chunk_size The size of the root cube of every chunk.
+    /// @param resident_budget The maximum number of chunks which are loaded or being loaded, at least one. Positions
+    /// without a chunk do not count.
+    ChunkManager(tools::ThreadPool &thread_pool, ChunkLoader loader, float chunk_size, std::size_t resident_budget);
+
+    /// @brief Read the chunks from files which are named after their grid position, e.g. "-1_0_2.nxoc".
+    /// @param directory The directory of the chunk files.
+    [[nodiscard]] static ChunkLoader file_loader(std::filesystem::path directory);
+
+    [[nodiscard]] float chunk_size() const noexcept {
+        return m_chunk_size;
+    }
+
+    /// The grid position of the chunk which contains the given position.
+    [[nodiscard]] GridPosition grid_position(const glm::vec3 &position) const;
+
+    /// @brief Take over the chunks which finished loading, request the missing chunks within the view distance and
+    /// evict the chunks which are the farthest away from the camera as long as there are more than the budget.
+    /// The chunks closest to the camera are requested first, and no more are requested once the loaded and loading
+    /// ones within the view distance fill the budget, so the budget limits the view distance if it is too small.
+    /// Positions without a chunk are remembered while they are within the view distance. Chunks which are still
+    /// loading count against the budget like loaded ones, and evicted ones are discarded once their task is done.
+    /// @param camera_position The position of the camera.
+    /// @param view_distance The distance up to which chunks are requested.
+    /// @return ``True`` if the set of resident_chunks() changed.
+    bool update(const glm::vec3 &camera_position, float view_distance);
+
+    /// Block until all pending chunks are loaded and take them over.
+    /// @return ``True`` if the set of resident_chunks() changed.
+    bool wait();
+
+    /// The loaded chunks ordered by their grid position.
+    [[nodiscard]] std::vector<std::shared_ptr<Cube>> resident_chunks() const;
+
+    /// The number of chunks which are still loading.
+    [[nodiscard]] std::size_t pending_chunks() const;
+};
+
+} // namespace inexor::vulkan_renderer::world
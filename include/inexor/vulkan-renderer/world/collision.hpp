@@ -2,22 +2,43 @@
 
 #include <glm/vec3.hpp>
 
+#include <cstddef>
+#include <optional>
 #include <string>
 #include <tuple>
+#include <type_traits>
 
 namespace inexor::vulkan_renderer::world {
 
+/// @brief A hit of a ray on one of the triangles of a cube.
+struct RayTriangleHit {
+    /// The index of the triangle in the polygon cache of the cube.
+    std::size_t triangle{0};
+    /// The parameter along the direction at which the ray hits the triangle, so the intersection is position +
+    /// distance * direction.
+    float distance{0.0f};
+    /// The barycentric coordinates of the intersection, the weights of the second and the third vertex of the
+    /// triangle. The weight of the first vertex is 1 - u - v.
+    float u{0.0f};
+    float v{0.0f};
+};
+
 /// @brief A wrapper for collisions between a ray and octree geometry.
 /// This class is used for octree collision, but it can be used for every cube-like data structure
-/// @tparam T A template type which offers a size() and center() method.
+/// @tparam T A template type which offers a size() and center() method. Types which can be copied trivially, like
+/// LinearOctree::NodeView, are stored by value, all others by reference.
 template <typename T>
 class RayCubeCollision {
-    const T &m_cube;
+    std::conditional_t<std::is_trivially_copyable_v<T>, T, const T &> m_cube;
 
     glm::vec3 m_intersection;
     glm::vec3 m_selected_face;
     glm::vec3 m_nearest_corner;
     glm::vec3 m_nearest_edge;
+    std::optional<RayTriangleHit> m_triangle_hit;
+
+    /// Calculate the members above, on the face of the hit triangle if there is one.
+    void calculate(glm::vec3 ray_pos, glm::vec3 ray_dir);
 
 public:
     /// @brief Calculate point of intersection, selected face,
@@ -27,6 +48,14 @@ public:
     /// @param ray_dir The direction of the ray.
     RayCubeCollision(const T &cube, glm::vec3 ray_pos, glm::vec3 ray_dir);
 
+    /// @brief Like the constructor above, but the intersection is the exact point on a triangle of the cube and the
+    /// selected face is the face of the cube which the triangle belongs to.
+    /// @param cube The cube to check for collision.
+    /// @param ray_pos The start point of the ray.
+    /// @param ray_dir The direction of the ray.
+    /// @param triangle_hit The triangle of the cube which the ray hits.
+    RayCubeCollision(const T &cube, glm::vec3 ray_pos, glm::vec3 ray_dir, const RayTriangleHit &triangle_hit);
+
     RayCubeCollision(const RayCubeCollision &) = delete;
 
     RayCubeCollision(RayCubeCollision &&other) noexcept;
@@ -55,6 +84,11 @@ public:
     [[nodiscard]] const glm::vec3 &edge() const noexcept {
         return m_nearest_edge;
     }
+
+    /// The triangle which the ray hits, only set for cubes whose triangles were tested.
+    [[nodiscard]] const std::optional<RayTriangleHit> &triangle() const noexcept {
+        return m_triangle_hit;
+    }
 };
 
 } // namespace inexor::vulkan_renderer::world
@@ -1,16 +1,15 @@
 #pragma once
 
 #include "inexor/vulkan-renderer/world/collision.hpp"
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/linear_octree.hpp"
 
 #include <glm/vec3.hpp>
 
+#include <array>
+#include <cstdint>
 #include <optional>
 
-// Forward declaration
-namespace inexor::vulkan_renderer::world {
-class Cube;
-} // namespace inexor::vulkan_renderer::world
-
 namespace inexor::vulkan_renderer::world {
 
 // TODO: Implement PointCubeCollision
@@ -18,22 +17,68 @@ namespace inexor::vulkan_renderer::world {
 /// @brief ``True`` of the ray build from the two vectors collides with the cube's bounding box.
 /// @note There is no such function as glm::intersectRayBox.
 /// @param box_bounds An array of two vectors which represent the edges of the bounding box.
-/// @param pos The start position of the ray.
-/// @param dir The direction of the ray.
+/// @param position The start position of the ray.
+/// @param direction The direction of the ray, components which are zero are handled without dividing by zero.
 /// @return ``True`` if the ray collides with the octree cube's bounding box.
-[[nodiscard]] bool ray_box_collision(std::array<glm::vec3, 2> &box_bounds, glm::vec3 &pos, glm::vec3 &dir);
+[[nodiscard]] bool ray_box_collision(const std::array<glm::vec3, 2> &box_bounds, const glm::vec3 &position,
+                                     const glm::vec3 &direction);
+
+/// @brief The distance at which a ray enters a box.
+/// @param box_bounds An array of two vectors which represent the edges of the bounding box.
+/// @param position The start position of the ray.
+/// @param direction The direction of the ray.
+/// @return The parameter along the direction at which the ray enters the box, 0 if it starts inside of the box and
+/// std::nullopt if it misses the box.
+[[nodiscard]] std::optional<float> ray_box_entry_distance(const std::array<glm::vec3, 2> &box_bounds,
+                                                          const glm::vec3 &position, const glm::vec3 &direction);
+
+/// @brief Find the nearest triangle of a cube which a ray hits, with the algorithm of Moeller and Trumbore.
+/// Moeller, T., & Trumbore, B. (1997). Fast, Minimum Storage Ray-Triangle Intersection.
+/// The triangles are stored as a structure of arrays, so all 12 triangles are tested by the same branch free loop,
+/// which the compiler vectorises. Both sides of the triangles are hit, degenerate triangles are never hit.
+/// @param triangles The triangles, usually the polygon cache of a cube.
+/// @param position The start position of the ray.
+/// @param direction The direction of the ray.
+/// @return The nearest hit in front of the start position, std::nullopt if no triangle is hit.
+[[nodiscard]] std::optional<RayTriangleHit>
+ray_triangles_collision(const CubePolygons &triangles, const glm::vec3 &position, const glm::vec3 &direction);
+
+/// @brief Find the nearest triangle of a Type::NORMAL cube which a ray hits.
+/// The bounding box of the cube is tested first, so rays which miss the cube skip the triangles.
+/// @param cube A Type::NORMAL cube.
+/// @param position The start position of the ray.
+/// @param direction The direction of the ray.
+/// @return The nearest hit, std::nullopt if no triangle is hit.
+[[nodiscard]] std::optional<RayTriangleHit> ray_normal_cube_collision(const Cube &cube, const glm::vec3 &position,
+                                                                      const glm::vec3 &direction);
 
 /// @brief Check for a collision between a camera ray and octree geometry.
+/// The octree is traversed front to back with the parametric algorithm of Revelles et al., so the children of every
+/// octant are visited in the order the ray passes them and the traversal stops at the first leaf which is hit. Only
+/// the children which the ray passes are visited and the parameters of the children are derived from the ones of the
+/// parent with one addition per axis. Type::NORMAL cubes are hit on their triangles, see ray_triangles_collision().
+/// The triangles lie inside of their cube, so the first hit is still the nearest one.
+/// @note See the thread safety of Cube for reading the octree from several threads.
 /// @param cube The cube to check collisions with.
 /// @param pos The camera position.
 /// @param dir The camera view direction.
 /// @param max_depth The maximum subcube iteration depth. If this depth is reached and the cube is an octant, it
 /// will be treated as if it was a solid cube. This is the foundation for the implementation of grid size in octree
 /// editor.
-/// @note This does not account yet for octree indentation!
 /// @return A std::optional which contains the collision data (if any found).
 [[nodiscard]] std::optional<RayCubeCollision<Cube>>
 ray_cube_collision_check(const Cube &cube, glm::vec3 pos, glm::vec3 dir,
                          std::optional<std::uint32_t> max_depth = std::nullopt);
 
+/// @brief Check for a collision between a camera ray and the geometry of a linear octree.
+/// The octree is traversed like by the overload for Cube, so both find the same cube and intersection.
+/// @param octree The octree to check collisions with.
+/// @param pos The camera position.
+/// @param dir The camera view direction.
+/// @param max_depth The maximum subcube iteration depth, see the overload for Cube.
+/// @return A std::optional which contains the collision data (if any found), with the node which is hit.
+[[nodiscard]] std::optional<RayCubeCollision<LinearOctree::NodeView>>
+ray_cube_collision_check(const LinearOctree &octree, glm::vec3 pos, glm::vec3 dir,
+                         std::optional<std::uint32_t> max_depth = std::nullopt);
+
 } // namespace inexor::vulkan_renderer::world
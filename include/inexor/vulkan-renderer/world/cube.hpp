@@ -9,11 +9,16 @@
 #include <functional>
 #include <memory>
 #include <optional>
+#include <span>
+#include <tuple>
+#include <utility>
 #include <vector>
 
-// Forward declaration
+// Forward declarations
 namespace inexor::vulkan_renderer::world {
 class Cube;
+class OctreeSnapshot;
+struct SnapshotNode;
 } // namespace inexor::vulkan_renderer::world
 
 // Forward declarations
@@ -22,26 +27,74 @@ class ByteStream;
 class NXOCParser;
 } // namespace inexor::vulkan_renderer::io
 
+// Forward declaration
+namespace inexor::vulkan_renderer::tools {
+class ThreadPool;
+} // namespace inexor::vulkan_renderer::tools
+
 void swap(inexor::vulkan_renderer::world::Cube &lhs, inexor::vulkan_renderer::world::Cube &rhs) noexcept;
 
 namespace inexor::vulkan_renderer::world {
 
-/// std::vector<Polygon> can probably replaced with an array.
 using Polygon = std::array<glm::vec3, 3>;
+/// The triangles of a geometry cube, two per face.
+using CubePolygons = std::array<Polygon, 12>;
+
+/// Immutable, so it is shared by clones and snapshots instead of being copied.
+using PolygonCache = std::shared_ptr<const CubePolygons>;
+
+/// The polygons of all geometry cubes of an octree, owned by its root. Every geometry cube has a slot of 12 triangles
+/// and the slots are in the order of Cube::polygons(), so the polygons of every subtree are one contiguous range.
+using PolygonArena = std::vector<Polygon>;
+
+/// Aggregates over the cubes of a subtree, see Cube::statistics().
+struct SubtreeStatistics {
+    std::size_t empty_cubes{0};
+    std::size_t solid_cubes{0};
+    std::size_t normal_cubes{0};
+    std::size_t octants{0};
+    /// The number of levels below the root of the subtree, 0 for a leaf.
+    std::size_t depth{0};
+
+    /// The number of Type::SOLID and Type::NORMAL cubes.
+    [[nodiscard]] std::size_t geometry_cubes() const noexcept {
+        return solid_cubes + normal_cubes;
+    }
 
-using PolygonCache = std::shared_ptr<std::vector<Polygon>>;
+    /// The number of triangles in the polygon caches of the subtree.
+    [[nodiscard]] std::size_t triangles() const noexcept {
+        return geometry_cubes() * std::tuple_size_v<CubePolygons>;
+    }
+};
 
+/// @brief A node of an octree, the root of a world or one of its subcubes.
+/// Thread safety: rotations of octants are applied lazily by children(), operator[]() and neighbor(), even through
+/// const references. An octree can therefore only be read by several threads at once, e.g. by spatial queries,
+/// collision checks or meshing, after apply_pending_rotations() was called. Edits must not run concurrently with any
+/// reads, take a snapshot() for that. Only edits of different subtrees can run concurrently, while each of them is
+/// detached by a DetachedSubtree.
 class Cube : public std::enable_shared_from_this<Cube> {
     friend void ::swap(Cube &lhs, Cube &rhs) noexcept;
     friend class io::NXOCParser;
+    friend class EditTransaction;
+    friend class OctreeSnapshot;
+    friend class LinearOctree;
+    friend class NormalCubeBatch;
+    friend class SparseVoxelDag;
+    friend std::vector<Polygon> greedy_mesh(const Cube &cube, bool update_invalid);
 
 public:
     /// Maximum of sub cubes (children)
     static constexpr std::size_t SUB_CUBES{8};
     /// Cube edges.
     static constexpr std::size_t EDGES{12};
+    /// Maximum grid level of a cube, limited by the 64 bit locational code.
+    static constexpr std::size_t MAX_DEPTH{21};
+    /// Cube faces, in the order of the polygon cache (x = 0, x = 1, y = 0, y = 1, z = 0, z = 1).
+    /// Every face is made of two consecutive triangles.
+    static constexpr std::size_t FACES{6};
     /// Cube Type.
-    enum class Type { EMPTY = 0b00u, SOLID = 0b01u, NORMAL = 0b10u, OCTANT = 0b11u };
+    enum class Type : std::uint8_t { EMPTY = 0b00u, SOLID = 0b01u, NORMAL = 0b10u, OCTANT = 0b11u };
     enum class NeighborAxis { X = 2, Y = 1, Z = 0 };
     enum class NeighborDirection { POSITIVE, NEGATIVE };
 
@@ -60,37 +113,204 @@ public:
     };
 
 private:
+    /// The edge whose indentation takes the place of an edge after a rotation, to record rotations.
+    struct RotatedEdge {
+        std::uint8_t edge;
+        bool mirrored{false};
+
+        void mirror() noexcept {
+            mirrored = !mirrored;
+        }
+    };
+
+    /// A rotation of the subtree of an octant which is not applied to its children yet.
+    struct PendingRotation {
+        /// The child in slot i moves from slot children[i].
+        std::array<std::uint8_t, SUB_CUBES> children{0, 1, 2, 3, 4, 5, 6, 7};
+        /// The indentation of edge i of a Type::NORMAL cube is taken from edges[i].
+        std::array<RotatedEdge, EDGES> edges{{{0}, {1}, {2}, {3}, {4}, {5}, {6}, {7}, {8}, {9}, {10}, {11}}};
+
+        /// Rotate the indentations of a Type::NORMAL cube.
+        void apply(std::array<Indentation, EDGES> &indentations) const;
+        /// Append this rotation to one which was recorded before.
+        void apply(PendingRotation &rotation) const;
+    };
+
     Type m_type{Type::EMPTY};
     float m_size{32};
     glm::vec3 m_position{0.0f, 0.0f, 0.0f};
 
     /// Root cube is empty.
     std::weak_ptr<Cube> m_parent{};
+    /// Non-owning pointer to m_parent for traversals without reference counting, nullptr if root.
+    /// It is reset as soon as the parent releases this cube.
+    Cube *m_parent_node{nullptr};
 
     /// Index of this in m_parent.m_children; undefined behavior if root.
     std::uint8_t m_index_in_parent{};
+    /// A leading one bit followed by the indices of the cubes on the path from the root to this, three bits each.
+    std::uint64_t m_locational_code{1};
 
     /// Indentations, should only be used if it is a geometry cube.
     std::array<Indentation, Cube::EDGES> m_indentations;
-    std::array<std::shared_ptr<Cube>, Cube::SUB_CUBES> m_children;
-
-    /// Only geometry cube (Type::SOLID and Type::Normal) have a polygon cache.
-    mutable PolygonCache m_polygon_cache;
+    /// Mutable, as the pending rotation of an octant is applied to its children when they are read.
+    mutable std::array<std::shared_ptr<Cube>, Cube::SUB_CUBES> m_children;
+    /// The rotation of an octant which is not applied to its children yet. If it is set, the children are in their
+    /// slots from before the rotation and their positions and locational codes may be outdated.
+    mutable std::optional<PendingRotation> m_pending_rotation;
+
+    /// Index of the first triangle of the subtree of this cube in the polygon arena, relative to the one of the parent.
+    /// Only geometry cubes (Type::SOLID and Type::Normal) have a polygon cache, the 12 triangles at this offset.
+    mutable std::size_t m_polygon_offset{0};
     mutable bool m_polygon_cache_valid{false};
-
+    /// The polygon arena of the octree, only used if this is the root. nullptr until the polygons are updated.
+    mutable std::unique_ptr<PolygonArena> m_polygon_arena;
+    /// Whether any polygon cache in the subtree of this cube is invalid.
+    /// If a cube is dirty, all its parents are dirty too.
+    mutable bool m_subtree_dirty{true};
+    /// Whether octants collapse into a single leaf as soon as an edit makes all their children Type::EMPTY or all
+    /// Type::SOLID. Inherited by new children.
+    bool m_auto_compaction{false};
+    /// Aggregates of the subtree, updated together with the ones of the parents whenever a type changes.
+    SubtreeStatistics m_statistics{.empty_cubes = 1};
+    /// Simplified geometry of an octant for rendering it from far away: its bounding box as a Type::SOLID cube.
+    /// nullptr if it has to be rebuilt, then the ones of the parents are too.
+    mutable PolygonCache m_lod_proxy;
+    /// Fraction of the volume of an octant which is filled by geometry cubes, valid together with m_lod_proxy.
+    mutable float m_occupancy{0.0f};
+    /// The node of the last snapshot, which is shared by all snapshots until this cube or one of its children is
+    /// changed. If it is nullptr, the ones of the parents are too.
+    mutable std::shared_ptr<const SnapshotNode> m_snapshot;
+
+    /// Mark this cube and its parents as dirty, stops at the first parent which is already dirty.
+    /// The snapshot nodes and level of detail proxies of this cube and its parents are released.
+    void mark_subtree_dirty() const;
+    /// Mark the parents as dirty and release their snapshot nodes and level of detail proxies, like
+    /// mark_subtree_dirty() does.
+    void mark_parents_dirty() const;
+    /// Update the invalid polygon caches of all dirty subtrees and clear their dirty flags.
+    /// The slots of the polygon arena are assigned first, see update_polygon_arena().
+    /// @param changed If not nullptr, the leaves whose polygon cache was updated are appended in traversal order.
+    /// @return True if this is a leaf whose polygon cache was updated.
+    bool update_dirty_polygon_caches(std::vector<std::shared_ptr<const Cube>> *changed) const;
+    /// Like update_dirty_polygon_caches(), but the slots must be assigned already.
+    /// The caches of Type::NORMAL cubes are computed together by a NormalCubeBatch.
+    /// @param arena The polygon arena of the octree.
+    /// @param offset The index of the first triangle of this subtree in the arena.
+    bool update_dirty_polygon_caches(std::vector<std::shared_ptr<const Cube>> *changed, PolygonArena &arena,
+                                     std::size_t offset) const;
+    /// Like update_dirty_polygon_caches(), but the Type::NORMAL cubes with an invalid polygon cache are only
+    /// appended to normal_cubes and their offsets to normal_offsets, their caches are left for the caller.
+    bool collect_dirty_polygon_caches(std::vector<std::shared_ptr<const Cube>> *changed, PolygonArena &arena,
+                                      std::size_t offset, std::vector<const Cube *> &normal_cubes,
+                                      std::vector<std::size_t> &normal_offsets) const;
+    /// Write the triangles of this cube into its slot of the arena and mark the polygon cache as valid.
+    void update_polygon_cache(PolygonArena &arena, std::size_t offset) const;
+    /// @brief Assign the slots of all geometry cubes in the polygon arena of the octree.
+    /// The slots only move if cubes were added, removed or rotated since the last time. Then the arena is copied in
+    /// the new order, where every unchanged subtree is one block. Without an arena, e.g. after this subtree was
+    /// removed from its octree, all polygon caches are invalidated and a new arena is created.
+    /// @return The arena and the index of the first triangle of this subtree in it.
+    std::pair<PolygonArena *, std::size_t> update_polygon_arena() const;
+    /// Whether the offsets in a dirty subtree differ from the number of triangles of the cubes before them.
+    [[nodiscard]] bool polygon_layout_changed() const;
+    /// Copy the polygons of this subtree from their slots in the old arena to the ones in the new arena and update
+    /// the offsets. Only valid polygon caches are copied.
+    void relayout_polygons(const PolygonArena &old_arena, std::size_t old_offset, PolygonArena &new_arena,
+                           std::size_t new_offset) const;
+    /// The root which owns the polygon arena and the index of the first triangle of this subtree in it.
+    [[nodiscard]] std::pair<const Cube *, std::size_t> polygon_arena_offset() const noexcept;
+    /// Append the given triangles of this geometry cube, without the ones which lie flat on a hidden face.
+    void append_visible_polygons(std::span<const Polygon> triangles, std::vector<Polygon> &polygons) const;
+
+    /// Move the children of an octant into the slots of its pending rotation and rotate them. Octants among the
+    /// children get the rotation as their own pending rotation, so only one level of the subtree is touched.
+    void apply_pending_rotation() const;
+
+    /// Set a new type like set_type(), but without auto compaction.
+    /// @exception InexorException Type::OCTANT is set on a cube at MAX_DEPTH
+    /// @return False if the cube already had that type.
+    bool change_type(Type new_type);
+    /// Set the statistics of this cube from its type and its children, and apply the difference to the parents.
+    void update_statistics();
+    /// Apply the difference between the previous and the current statistics of this cube to the parents.
+    /// Only the octants on the path to the root are touched and the children of one of them are only read if the
+    /// depth of its deepest subtree shrinks.
+    void propagate_statistics(SubtreeStatistics previous);
+    /// Rebuild the level of detail proxy and the occupancy of an octant.
+    void update_lod_proxy() const;
+    /// Whether lod_polygons() draws this octant in full detail for the position, instead of its proxy.
+    [[nodiscard]] bool lod_detailed(const glm::vec3 &position, float min_size_ratio) const;
+    /// Clone the cubes of the subtree like clone(), but without the polygon arena.
+    [[nodiscard]] std::shared_ptr<Cube> clone_nodes() const;
     /// Removes all children recursive.
     void remove_children();
+    /// Set the locational code of this cube and update the ones of its children.
+    void set_locational_code(std::uint64_t code);
+    /// Get the type of the children, if all of them are Type::EMPTY or all of them are Type::SOLID.
+    [[nodiscard]] std::optional<Type> uniform_children_type() const;
+    /// Replace the children of an octant by a single leaf of the given type.
+    void collapse(Type type);
+    /// Collapse the given octant and its parents as long as their children are uniform.
+    static void collapse_uniform_octants(Cube *octant);
 
     /// Get the root to this cube.
     [[nodiscard]] std::shared_ptr<Cube> root();
     /// Get the vertices of this cube. Use only on geometry cubes.
     [[nodiscard]] std::array<glm::vec3, 8> vertices() const noexcept;
+    /// Get the vertices of a geometry cube from its type, position, size and indentations.
+    [[nodiscard]] static std::array<glm::vec3, 8> vertices(Type type, const glm::vec3 &position, float size,
+                                                           const std::array<Indentation, Cube::EDGES> &ind) noexcept;
+    /// Get the faces of a Type::NORMAL cube whose diagonal is flipped to keep them convex, one bit per face.
+    [[nodiscard]] static std::uint8_t face_splits(const std::array<Indentation, Cube::EDGES> &ind) noexcept;
+    /// Get the 12 triangles of a geometry cube from its vertices and the faces whose diagonal is flipped.
+    [[nodiscard]] static CubePolygons triangulate(const std::array<glm::vec3, 8> &v, std::uint8_t face_splits) noexcept;
+    /// Get the 12 triangles of a geometry cube from its type, position, size and indentations.
+    [[nodiscard]] static CubePolygons triangulate(Type type, const glm::vec3 &position, float size,
+                                                  const std::array<Indentation, Cube::EDGES> &ind) noexcept;
 
     /// Optimized implementations of 90°, 180° and 270° rotations.
     template <int Rotations>
     void rotate(const RotationAxis::Type &axis);
+    /// Optimized implementations of 90°, 180° and 270° rotations of the indentations of a Type::NORMAL cube.
+    /// @tparam Edge Indentation, or anything else which can be mirrored like RotatedEdge.
+    template <int Rotations, typename Edge>
+    static void rotate_indentations(std::array<Edge, Cube::EDGES> &indentations, const RotationAxis::Type &axis);
+    /// Optimized implementations of 90°, 180° and 270° rotations of the children of a Type::OCTANT cube.
+    template <int Rotations, typename Child>
+    static void rotate_children(std::array<Child, Cube::SUB_CUBES> &children, const RotationAxis::Type &axis);
 
 public:
+    /// @brief Detaches the subtree of a cube from the cubes above it, until it is destroyed.
+    /// Edits of a detached subtree neither read nor write the cubes above it, so several detached subtrees of an
+    /// octree can be edited by different threads at once. Meanwhile the cube is_root(), so auto compaction does not
+    /// collapse the parents and neighbor() does not leave the subtree. When the subtree is attached again, its
+    /// statistics are applied to the parents and they are marked as dirty. Polygon caches which were updated while
+    /// detached are invalidated, as they are not in the polygon arena of the octree. The subtree must not be removed
+    /// from the octree while it is detached.
+    class DetachedSubtree {
+    private:
+        Cube *m_cube;
+        Cube *m_parent;
+        /// The statistics of the subtree when it was detached.
+        SubtreeStatistics m_statistics;
+
+    public:
+        explicit DetachedSubtree(Cube &cube);
+        DetachedSubtree(const DetachedSubtree &) = delete;
+        DetachedSubtree(DetachedSubtree &&other) noexcept;
+        ~DetachedSubtree();
+        DetachedSubtree &operator=(const DetachedSubtree &) = delete;
+        DetachedSubtree &operator=(DetachedSubtree &&) = delete;
+    };
+
+    /// Offset of a child relative to its parent's position, in units of the child size.
+    /// Look into octree documentation to find information about the order of subcubes in space.
+    [[nodiscard]] static glm::vec3 child_offset(const std::size_t index) noexcept {
+        return {static_cast<float>((index >> 2u) & 1u), static_cast<float>((index >> 1u) & 1u),
+                static_cast<float>(index & 1u)};
+    }
+
     /// Create an empty cube.
     Cube() = default;
     /// Create an empty cube.
@@ -100,26 +320,60 @@ public:
     /// Use clone() to create an independent copy of a cube.
     Cube(const Cube &rhs) = delete;
     Cube(Cube &&rhs) noexcept;
-    ~Cube() = default;
+    ~Cube();
     Cube &operator=(Cube rhs);
     Cube &operator=(Cube &&) = delete;
 
     /// Get child.
     std::shared_ptr<Cube> operator[](std::size_t idx);
     /// Get child.
+    /// @note Applies the pending rotation of this octant, see children().
     std::shared_ptr<const Cube> operator[](std::size_t idx) const; // NOLINT
 
     /// Clone a cube, which has no relations to the current one or its children.
     /// It will be a root cube.
     [[nodiscard]] std::shared_ptr<Cube> clone() const;
+    /// Take an immutable snapshot of this cube and its children, which can be read by other threads while this cube
+    /// is edited. Subtrees which did not change since the last snapshot are shared with it, so this only costs
+    /// O(changed cubes) and the first snapshot O(cubes).
+    /// @note Must not be called concurrently with edits of the octree.
+    [[nodiscard]] OctreeSnapshot snapshot() const;
 
     /// Is the current cube root.
     [[nodiscard]] bool is_root() const noexcept;
-    /// At which child level this cube is.
+    /// The locational code of this cube: a leading one bit followed by the child indices on the path from the root,
+    /// three bits per level. The root has the code 1.
+    [[nodiscard]] std::uint64_t locational_code() const noexcept {
+        return m_locational_code;
+    }
+    /// At which child level this cube is, derived from the locational code.
     /// root cube = 0
     [[nodiscard]] std::size_t grid_level() const noexcept;
-    /// Count the number of Type::SOLID and Type::NORMAL cubes.
+    /// Count the number of Type::SOLID and Type::NORMAL cubes, see statistics().
     [[nodiscard]] std::size_t count_geometry_cubes() const noexcept;
+    /// @brief The number of cubes of each type and the depth of the subtree.
+    /// The statistics of all parents are updated when the type of a cube changes, so this is O(1) and does not
+    /// modify anything.
+    [[nodiscard]] const SubtreeStatistics &statistics() const noexcept {
+        return m_statistics;
+    }
+    /// Merge all octants whose children are all Type::EMPTY or all Type::SOLID into a single leaf of that type.
+    /// Works bottom-up, so octants which become uniform through the merge of their children are merged too.
+    /// @return The number of removed cubes.
+    std::size_t compact();
+    /// Enable or disable auto compaction for this cube and all its children.
+    /// If enabled, every edit which makes all children of an octant Type::EMPTY or all Type::SOLID collapses the
+    /// octant, like compact() does.
+    void set_auto_compaction(bool enabled);
+    [[nodiscard]] bool auto_compaction() const noexcept {
+        return m_auto_compaction;
+    }
+    /// Fraction of the volume of this cube which is filled by geometry cubes, where Type::NORMAL cubes count as filled.
+    /// It is cached for octants until their subtree changes.
+    [[nodiscard]] float occupancy() const;
+    /// Bit mask of the faces which touch a Type::SOLID neighbor of equal or larger size. Use only on geometry cubes.
+    /// Bit n stands for the n-th face in the order of the polygon cache.
+    [[nodiscard]] std::uint8_t hidden_faces() const;
 
     [[nodiscard]] glm::vec3 center() const noexcept {
         return m_position + 0.5f * m_size;
@@ -138,14 +392,24 @@ public:
     }
 
     /// Set a new type.
+    /// @note With auto compaction enabled this can collapse the parent, which removes this cube from the octree.
+    /// @exception InexorException Type::OCTANT is set on a cube at MAX_DEPTH
     void set_type(Type new_type);
     /// Get type.
     [[nodiscard]] Type type() const noexcept;
 
     /// Get children.
+    /// @note Applies the pending rotation of this octant, which moves the children, see the thread safety of Cube.
     [[nodiscard]] const std::array<std::shared_ptr<Cube>, Cube::SUB_CUBES> &children() const;
+    /// @brief Apply the pending rotations of all octants in the subtree, so children() does not modify anything
+    /// afterwards and the subtree can be read by several threads at once, see the thread safety of Cube.
+    /// Only dirty subtrees can have pending rotations, the others are skipped.
+    void apply_pending_rotations() const;
     /// Get indentations.
     [[nodiscard]] std::array<Indentation, Cube::EDGES> indentations() const noexcept;
+    /// Get the 12 triangles of this cube, from the polygon cache if it is valid. Use only on geometry cubes.
+    /// The polygon cache is not updated, so this can be called while other threads read the octree.
+    [[nodiscard]] CubePolygons triangles() const;
 
     /// Set an indent by the edge id.
     void set_indent(std::uint8_t edge_id, Indentation indentation);
@@ -154,20 +418,71 @@ public:
     void indent(std::uint8_t edge_id, bool positive_direction, std::uint8_t steps);
 
     /// Rotate the cube 90° clockwise around the given axis. Repeats with the given rotations.
+    /// The rotation of an octant is only recorded, it takes O(1). Every level of the subtree is rotated once it is
+    /// read through children(), traversed, meshed or serialized, so descendants which were taken before the rotation
+    /// keep their old position until then. Like other edits, this must not happen while other threads read the
+    /// subtree.
     /// @param axis Only one index should be one.
     /// @param rotations Value does not need to be adjusted beforehand. (e.g. mod 4)
     void rotate(const RotationAxis::Type &axis, int rotations);
 
-    /// TODO: in special cases some polygons have no surface, if completely surrounded by others
+    /// Rebuild the polygon cache, which holds all 12 triangles. Hidden faces are left out by visible_polygons().
     /// \warning Will update the cache even if it is considered as valid.
     void update_polygon_cache() const;
     /// Invalidate polygon cache.
     void invalidate_polygon_cache() const;
-    /// Recursive way to collect all the caches.
+    /// Whether any polygon cache in the subtree of this cube is invalid.
+    [[nodiscard]] bool subtree_dirty() const noexcept {
+        return m_subtree_dirty;
+    }
+    /// Update all invalid polygon caches, without visiting subtrees which did not change.
+    /// An edit therefore costs O(depth + changed leaves) instead of O(world). Only if geometry cubes were added,
+    /// removed or rotated, the polygon arena is copied once to move the slots, one block per unchanged subtree.
+    /// @note The cube must be owned by a std::shared_ptr.
+    /// @return The leaves whose polygon cache was updated, in the order of polygons().
+    std::vector<std::shared_ptr<const Cube>> update_polygon_caches() const;
+    /// @brief The polygon caches of all geometry cubes in the subtree, 12 triangles each.
+    /// They are one range of the polygon arena of the octree, which stays valid until the polygons are updated.
+    /// Without an update, the slots are the ones of the last update, which do not include the cubes changed since.
+    /// @param update_invalid If true it will update invalid polygon caches, skipping subtrees which did not change.
+    /// If cubes were added or removed, the slots of the whole octree are moved, which copies the arena once.
+    [[nodiscard]] std::span<const Polygon> polygons(bool update_invalid = false) const;
+    /// Update the invalid polygon caches in parallel and return all of them.
+    /// The octree is split into independent subtrees at the given depth, which are processed by the thread pool.
+    /// The result is identical to polygons(true).
+    /// @param thread_pool The thread pool which processes the subtrees.
+    /// @param split_depth Depth of the subtree roots, relative to this cube.
+    [[nodiscard]] std::span<const Polygon> polygons(tools::ThreadPool &thread_pool, std::size_t split_depth) const;
+    /// @brief Collect the polygons like polygons(), but with less detail far away from the given position.
+    /// Octants whose size divided by their distance to the position is below min_size_ratio are not descended into.
+    /// They are replaced by a proxy, their bounding box as a Type::SOLID cube if their occupancy() reaches the
+    /// occupancy_threshold, nothing otherwise. So the number of polygons depends on min_size_ratio, not on the depth
+    /// of the octree. The proxies are cached like the polygon caches.
+    /// @param position The position of the camera.
+    /// @param min_size_ratio Smallest ratio of size and distance of an octant which is drawn in full detail.
+    /// @param occupancy_threshold Smallest occupancy of an octant which is drawn as a box.
+    /// @param update_invalid If true it will update invalid polygon caches.
+    /// @return Ranges of the polygon arena and of the proxies, consecutive slots are merged into one range. They stay
+    /// valid until the octree is changed or its polygons are updated.
+    [[nodiscard]] std::vector<std::span<const Polygon>> lod_polygons(const glm::vec3 &position, float min_size_ratio,
+                                                                     float occupancy_threshold = 0.5f,
+                                                                     bool update_invalid = false) const;
+    /// Whether lod_polygons() selects other octants for the new position than for the old one, i.e. an octant is drawn
+    /// in full detail for one position and replaced by its proxy for the other. Only the octants which are drawn in
+    /// full detail for both positions are descended into.
+    /// @param old_position The position of the camera for which the level of detail was selected before.
+    /// @param new_position The new position of the camera.
+    /// @param min_size_ratio Smallest ratio of size and distance of an octant which is drawn in full detail.
+    [[nodiscard]] bool lod_selection_changed(const glm::vec3 &old_position, const glm::vec3 &new_position,
+                                             float min_size_ratio) const;
+    /// Collect the polygons of all geometry cubes like polygons(), but leave out the triangles which can't be seen,
+    /// because they lie on a face which is covered by a Type::SOLID neighbor of equal or larger size.
     /// @param update_invalid If true it will update invalid polygon caches.
-    [[nodiscard]] std::vector<PolygonCache> polygons(bool update_invalid = false) const;
+    [[nodiscard]] std::vector<Polygon> visible_polygons(bool update_invalid = false) const;
 
     /// Get the (face) neighbor of this cube by using a similar implementation to Samets "OT_GTEQ_FACE_NEIGHBOR(P,I)".
+    /// The path to the neighbor is computed from the locational code with bit arithmetic, so the search does not
+    /// allocate memory and only touches reference counters for the returned cube.
     /// @brief Get the (face) neighbor of this cube.
     /// @param axis The axis on which to get the neighboring cube
     /// @param direction Whether to get the cube which is above or below this cube on the selected axis
@@ -177,8 +492,66 @@ public:
     /// (https://web.archive.org/web/20190712063957/http://www.cs.umd.edu/~hjs/pubs/SameCVGIP89.pdf)
     /// Computer Vision, Graphics, and Image Processing. 46 (3), 367-386.
     [[nodiscard]] std::shared_ptr<Cube> neighbor(NeighborAxis axis, NeighborDirection direction);
+    /// Get the (face) neighbor of this cube.
+    /// @note Applies the pending rotations on the path to the neighbor, see the thread safety of Cube.
+    [[nodiscard]] std::shared_ptr<const Cube> neighbor(NeighborAxis axis, NeighborDirection direction) const;
 };
 
+template <int Rotations, typename Child>
+void Cube::rotate_children(std::array<Child, Cube::SUB_CUBES> &children, const RotationAxis::Type &axis) {
+    static_assert(Rotations >= 1 && Rotations <= 3);
+    for (const auto &order : std::get<0>(axis)) {
+        if constexpr (Rotations == 1) {
+            std::swap(children[order[0]], children[order[1]]);
+            std::swap(children[order[1]], children[order[2]]);
+            std::swap(children[order[2]], children[order[3]]);
+        } else if constexpr (Rotations == 2) {
+            std::swap(children[order[0]], children[order[2]]);
+            std::swap(children[order[1]], children[order[3]]);
+        } else {
+            std::swap(children[order[0]], children[order[3]]);
+            std::swap(children[order[3]], children[order[2]]);
+            std::swap(children[order[2]], children[order[1]]);
+        }
+    }
+}
+
+template <int Rotations, typename Edge>
+void Cube::rotate_indentations(std::array<Edge, Cube::EDGES> &indentations, const RotationAxis::Type &axis) {
+    static_assert(Rotations >= 1 && Rotations <= 3);
+    const RotationAxis::EdgeType &edge_rotation = std::get<1>(axis);
+    for (const auto &order : edge_rotation) {
+        if constexpr (Rotations == 1) {
+            std::swap(indentations[order[0]], indentations[order[1]]);
+            std::swap(indentations[order[1]], indentations[order[2]]);
+            std::swap(indentations[order[2]], indentations[order[3]]);
+        } else if constexpr (Rotations == 2) {
+            std::swap(indentations[order[0]], indentations[order[2]]);
+            std::swap(indentations[order[1]], indentations[order[3]]);
+        } else {
+            std::swap(indentations[order[0]], indentations[order[3]]);
+            std::swap(indentations[order[3]], indentations[order[2]]);
+            std::swap(indentations[order[2]], indentations[order[1]]);
+        }
+    }
+    // Some indentations need to be mirrored, as the direction has changed.
+    // not the last array, as it contains the edges parallel to the axis around which we rotate
+    for (std::size_t idx = 0; idx < edge_rotation.size() - 1; idx++) {
+        if constexpr (Rotations == 1) {
+            indentations[edge_rotation[idx][0]].mirror();
+            indentations[edge_rotation[idx][2]].mirror();
+        } else if constexpr (Rotations == 2) {
+            indentations[edge_rotation[idx][0]].mirror();
+            indentations[edge_rotation[idx][1]].mirror();
+            indentations[edge_rotation[idx][2]].mirror();
+            indentations[edge_rotation[idx][3]].mirror();
+        } else {
+            indentations[edge_rotation[idx][1]].mirror();
+            indentations[edge_rotation[idx][3]].mirror();
+        }
+    }
+}
+
 /// @brief Construct a randomly generated cube world.
 /// Using the following probabilities:
 /// empty: 30%
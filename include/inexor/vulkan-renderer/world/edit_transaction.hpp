@@ -0,0 +1,106 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// The part of an octree which was changed by an EditTransaction.
+struct ChangedRegion {
+    /// The topmost cubes which were changed, none of them lies inside of another one.
+    /// Their polygon caches and the ones of their descendants are invalid, all other caches are untouched.
+    /// @note The faces of the neighbors which touch these cubes can become visible or hidden.
+    std::vector<std::shared_ptr<Cube>> subtrees;
+    /// Axis aligned box around all changed subtrees, only valid if there are any.
+    std::array<glm::vec3, 2> bounding_box{};
+    /// Number of edits which were queued.
+    std::size_t queued_edits{0};
+    /// Number of edits which were applied to the octree, the others were redundant.
+    std::size_t applied_edits{0};
+
+    [[nodiscard]] bool empty() const noexcept {
+        return subtrees.empty();
+    }
+};
+
+/// @brief Collects many edits of an octree and applies them at once.
+/// Cubes are addressed by their locational code, so an edit can target cubes which only exist after earlier edits of
+/// the same transaction, e.g. the children of a cube which is turned into an octant.
+/// Edits which have no effect on the result are dropped when they are queued: a type change overwrites the earlier
+/// type change and the indentations of the cube, and removes all edits of its children if it is not Type::OCTANT.
+/// Rotations reorder cubes, so edits are never coalesced across them, but consecutive rotations are merged.
+/// Auto compaction only runs once, after all edits were applied.
+class EditTransaction {
+private:
+    struct Edit {
+        enum class Kind : std::uint8_t { TYPE, SET_INDENT, INDENT, ROTATE };
+        Kind kind{Kind::TYPE};
+        /// Whether the edit was coalesced with a later one.
+        bool dropped{false};
+        /// The locational code of the edited cube.
+        std::uint64_t code{1};
+        /// Kind::TYPE: Start from a fresh cube, even if it already has the new type.
+        bool reset{false};
+        Cube::Type type{Cube::Type::EMPTY};
+        /// Kind::SET_INDENT and Kind::INDENT.
+        std::uint8_t edge_id{0};
+        Indentation indentation;
+        bool positive_direction{false};
+        std::uint8_t steps{0};
+        /// Kind::ROTATE.
+        Cube::RotationAxis::Type axis{};
+        int rotations{0};
+    };
+
+    std::shared_ptr<Cube> m_root;
+    std::vector<Edit> m_edits;
+    /// Number of edits which were queued, including the dropped ones.
+    std::size_t m_queued_edits{0};
+    /// The edits queued since the last rotation by cube, ordered like a depth-first traversal, so the edits of a
+    /// subtree form a contiguous range.
+    std::map<std::pair<std::uint64_t, std::size_t>, std::vector<std::size_t>> m_edits_by_cube;
+
+    /// The key of a cube in m_edits_by_cube.
+    [[nodiscard]] static std::pair<std::uint64_t, std::size_t> key(std::uint64_t code) noexcept;
+    /// Queue an edit and index it.
+    void push(Edit edit);
+    /// Drop the given edits, which must have been queued since the last rotation.
+    void drop(std::vector<std::size_t> &edits);
+    /// Find the cube with the given locational code.
+    /// @return The cube, or if it does not exist the leaf which covers its space, together with whether it exists.
+    [[nodiscard]] std::pair<Cube *, bool> find(std::uint64_t code) const;
+
+public:
+    /// @param root The root of the edited octree or of one of its subtrees, all edited cubes must lie inside of it.
+    explicit EditTransaction(std::shared_ptr<Cube> root);
+
+    /// Queue Cube::set_type.
+    /// @exception InexorException Type::OCTANT is set on a cube at Cube::MAX_DEPTH
+    void set_type(std::uint64_t code, Cube::Type type);
+    /// Queue Cube::set_indent.
+    void set_indent(std::uint64_t code, std::uint8_t edge_id, Indentation indentation);
+    /// Queue Cube::indent.
+    void indent(std::uint64_t code, std::uint8_t edge_id, bool positive_direction, std::uint8_t steps);
+    /// Queue Cube::rotate.
+    void rotate(std::uint64_t code, const Cube::RotationAxis::Type &axis, int rotations);
+
+    /// Number of queued edits which will be applied by commit().
+    [[nodiscard]] std::size_t pending_edits() const noexcept;
+
+    /// Apply all queued edits in order and clear the queue.
+    /// Edits of cubes which do not exist at that point are ignored, like Cube ignores indentations of cubes which are
+    /// not Type::NORMAL.
+    /// @return The changed part of the octree, which has to be remeshed.
+    ChangedRegion commit();
+};
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Forward declaration
+namespace inexor::vulkan_renderer::world {
+class Cube;
+} // namespace inexor::vulkan_renderer::world
+
+namespace inexor::vulkan_renderer::world {
+
+/// @brief The volume which is seen by a camera, bounded by six planes.
+class Frustum {
+public:
+    /// Where a bounding box lies relative to the frustum.
+    enum class Containment : std::uint8_t { OUTSIDE, INTERSECTING, INSIDE };
+
+private:
+    /// Left, right, bottom, top, near and far plane as (normal, distance), the normals point inside.
+    std::array<glm::vec4, 6> m_planes{};
+
+public:
+    /// @brief Extract the planes from the view and perspective matrix of a camera (Gribb/Hartmann).
+    /// The perspective matrix is expected to map the depth to [0, 1], like the renderer configures glm.
+    /// @param view The view matrix.
+    /// @param perspective The perspective matrix.
+    Frustum(const glm::mat4 &view, const glm::mat4 &perspective);
+
+    /// @brief Check where an axis aligned bounding box lies.
+    /// The check is conservative: boxes close to the corners of the frustum can be reported as intersecting, although
+    /// they are outside.
+    /// @param box_bounds An array of two vectors which represent the edges of the bounding box.
+    [[nodiscard]] Containment classify(const std::array<glm::vec3, 2> &box_bounds) const;
+};
+
+/// @brief Collect the subtrees which intersect the frustum, testing the bounding boxes from the top down.
+/// The octree is split into subtrees at the given depth, like Cube::polygons(thread_pool, split_depth) does, and
+/// Type::EMPTY leaves are left out. Octants which lie completely inside the frustum are not tested any further.
+/// @param cube The cube to start with.
+/// @param frustum The frustum.
+/// @param split_depth Depth of the subtree roots, relative to the cube.
+/// @return The roots of the visible subtrees, in the order of Cube::polygons().
+[[nodiscard]] std::vector<const Cube *> visible_subtrees(const Cube &cube, const Frustum &frustum,
+                                                         std::size_t split_depth);
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// The way the polygons of an octree are generated.
+enum class Mesher : std::uint8_t {
+    /// Two triangles per face, taken from the polygon cache of every geometry cube.
+    POLYGON_CACHE,
+    /// Coplanar faces of Type::SOLID cubes are merged into rectangles, see greedy_mesh().
+    GREEDY,
+};
+
+/// @brief Generate the polygons of an octree with greedy face merging.
+/// The faces of all Type::SOLID cubes are projected onto a grid with the size of the smallest solid cube. Faces
+/// which touch another solid cube are removed and the remaining faces of every axis slice are merged into as few
+/// rectangles as possible: each rectangle takes the widest run of faces in its row and grows along the next rows as
+/// long as they are covered too. Every rectangle becomes two triangles, in the same winding as the polygon cache.
+/// Type::NORMAL cubes keep their polygons from the polygon cache, leaving out the ones hidden by solid neighbors.
+/// @note Faces of large cubes are split into rows of the smallest solid cube, so very deep octrees with large solid
+/// cubes cost more memory than the polygon cache.
+/// @param cube The cube to generate the polygons of, usually the root of a world.
+/// @param update_invalid If true it will update invalid polygon caches.
+/// @return The triangles of the merged solid faces, followed by the ones of the normal cubes.
+[[nodiscard]] std::vector<Polygon> greedy_mesh(const Cube &cube, bool update_invalid = false);
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// @brief A pointer-free octree which keeps all nodes in one flat pool and addresses them by 32 bit ids.
+/// The eight children of an octant are stored next to each other, so a node only needs the id of its first child.
+/// Every node stores its locational code like Cube, so its level, position and size follow in constant time.
+/// Apart from the node ids, the interface follows the one of Cube, which can be converted in both directions.
+/// io::NXOCParser reads and writes it directly, so maps can be loaded without allocating a Cube per node.
+class LinearOctree {
+public:
+    /// Index of a node in the node pool.
+    using NodeId = std::uint32_t;
+    /// The root node always has the id 0.
+    static constexpr NodeId ROOT{0};
+    /// Marks a missing parent, child or neighbor.
+    static constexpr NodeId INVALID_NODE{std::numeric_limits<NodeId>::max()};
+    /// Maximum grid level of a node, the same as for Cube so both can be converted into each other.
+    static constexpr std::size_t MAX_DEPTH{Cube::MAX_DEPTH};
+
+    struct Node {
+        /// A leading one bit followed by the child indices on the path from the root, see Cube::locational_code.
+        std::uint64_t locational_code{1};
+        /// Id of the first of the eight consecutive children, only valid for Cube::Type::OCTANT.
+        NodeId children{INVALID_NODE};
+        /// Id of the parent, INVALID_NODE for the root.
+        NodeId parent{INVALID_NODE};
+        Cube::Type type{Cube::Type::EMPTY};
+        /// Indentations, should only be used if it is a geometry cube.
+        std::array<Indentation, Cube::EDGES> indentations;
+    };
+
+    /// @brief A node together with its octree, which offers the position, size and center like Cube.
+    /// It is used as the cube of a RayCubeCollision and is only valid as long as the octree is not changed.
+    class NodeView {
+        const LinearOctree *m_octree;
+        NodeId m_id;
+
+    public:
+        NodeView(const LinearOctree &octree, const NodeId id) : m_octree(&octree), m_id(id) {}
+
+        [[nodiscard]] NodeId id() const noexcept {
+            return m_id;
+        }
+        [[nodiscard]] Cube::Type type() const {
+            return m_octree->type(m_id);
+        }
+        [[nodiscard]] glm::vec3 position() const {
+            return m_octree->position(m_id);
+        }
+        [[nodiscard]] float size() const {
+            return m_octree->size(m_id);
+        }
+        [[nodiscard]] glm::vec3 center() const {
+            return m_octree->center(m_id);
+        }
+    };
+
+private:
+    float m_size{32};
+    glm::vec3 m_position{0.0f, 0.0f, 0.0f};
+
+    /// The root is the first node, followed by the blocks of eight children.
+    std::vector<Node> m_nodes{1};
+    /// Ids of the first child of released blocks, which will be reused by the next subdivision.
+    std::vector<NodeId> m_free_blocks;
+
+    /// Get a block of eight empty children, reusing a released block if possible.
+    [[nodiscard]] NodeId allocate_children(NodeId parent);
+    /// Release the children recursive.
+    void release_children(NodeId id);
+
+    /// Optimized implementations of 90°, 180° and 270° rotations.
+    template <int Rotations>
+    void rotate(NodeId id, const Cube::RotationAxis::Type &axis);
+
+public:
+    /// Create an empty octree.
+    LinearOctree() = default;
+    /// Create an empty octree.
+    LinearOctree(float size, const glm::vec3 &position);
+    /// Convert a pointer-based octree.
+    explicit LinearOctree(const Cube &cube);
+
+    /// Convert the octree back to a pointer-based octree.
+    [[nodiscard]] std::shared_ptr<Cube> to_cube() const;
+
+    /// Get the raw node data.
+    [[nodiscard]] const Node &node(NodeId id) const {
+        return m_nodes[id];
+    }
+
+    /// Number of nodes which are in use.
+    [[nodiscard]] std::size_t node_count() const noexcept;
+    /// Number of bytes allocated by the octree.
+    [[nodiscard]] std::size_t memory_usage() const noexcept;
+
+    /// Get child.
+    [[nodiscard]] NodeId child(NodeId id, std::size_t idx) const;
+    /// Get parent, INVALID_NODE for the root.
+    [[nodiscard]] NodeId parent(NodeId id) const;
+    /// Index of the node in its parent's children; undefined behavior if root.
+    [[nodiscard]] std::uint8_t index_in_parent(NodeId id) const noexcept;
+
+    /// Is the node the root.
+    [[nodiscard]] bool is_root(NodeId id) const noexcept;
+    /// At which child level the node is, derived from the locational code.
+    /// root cube = 0
+    [[nodiscard]] std::size_t grid_level(NodeId id) const;
+    /// Get the locational code of the node, see Cube::locational_code.
+    [[nodiscard]] std::uint64_t locational_code(NodeId id) const;
+    /// Count the number of Type::SOLID and Type::NORMAL cubes.
+    [[nodiscard]] std::size_t count_geometry_cubes(NodeId id = ROOT) const;
+
+    /// Position and size are computed from the locational code, without visiting the parents.
+    [[nodiscard]] glm::vec3 position(NodeId id) const;
+    [[nodiscard]] float size(NodeId id) const;
+    [[nodiscard]] glm::vec3 center(NodeId id) const;
+    [[nodiscard]] std::array<glm::vec3, 2> bounding_box(NodeId id) const;
+
+    /// Set a new type.
+    /// @exception InexorException Type::OCTANT is set on a node at MAX_DEPTH
+    void set_type(NodeId id, Cube::Type new_type);
+    /// Get type.
+    [[nodiscard]] Cube::Type type(NodeId id) const;
+
+    /// Get indentations.
+    [[nodiscard]] const std::array<Indentation, Cube::EDGES> &indentations(NodeId id) const;
+    /// Set an indent by the edge id.
+    void set_indent(NodeId id, std::uint8_t edge_id, Indentation indentation);
+    /// Indent a specific edge by steps.
+    /// @param positive_direction Indent in positive axis direction.
+    void indent(NodeId id, std::uint8_t edge_id, bool positive_direction, std::uint8_t steps);
+
+    /// Rotate the node 90° clockwise around the given axis. Repeats with the given rotations.
+    /// @param axis Only one index should be one.
+    /// @param rotations Value does not need to be adjusted beforehand. (e.g. mod 4)
+    void rotate(NodeId id, const Cube::RotationAxis::Type &axis, int rotations);
+
+    /// Get the 12 triangles of a geometry node, see Cube::triangles.
+    [[nodiscard]] CubePolygons triangles(NodeId id) const;
+
+    /// Collect the polygons of all geometry cubes below the node in the same order as Cube::polygons.
+    [[nodiscard]] std::vector<Polygon> polygons(NodeId id = ROOT) const;
+
+    /// Get the (face) neighbor of the node, see Cube::neighbor.
+    /// @returns Same-sized neighbor if existent, else larger neighbor if exists, otherwise INVALID_NODE.
+    [[nodiscard]] NodeId neighbor(NodeId id, Cube::NeighborAxis axis, Cube::NeighborDirection direction) const;
+};
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// @brief Computes the corners and the face diagonals of many Type::NORMAL cubes at once.
+/// The cubes are stored as a structure of arrays, one array per coordinate and per indentation, so the corners of 8
+/// cubes are computed with one AVX instruction per coordinate, or of 4 cubes with SSE. Without either, the same arrays
+/// are processed by a scalar loop. The operations are the same as the ones of Cube::vertices() and the convexity
+/// checks of the polygon cache, so the polygons are the same bit for bit, independent of the instruction set.
+class NormalCubeBatch {
+public:
+    /// The number of coordinates of the corners of a cube.
+    static constexpr std::size_t CORNER_COORDINATES{8 * 3};
+
+private:
+    std::array<std::vector<float>, 3> m_positions;
+    std::vector<float> m_sizes;
+    /// The size of one indentation step.
+    std::vector<float> m_steps;
+    /// Indentation::start() and Indentation::end() of every edge, as float to be processed with the coordinates.
+    std::array<std::vector<float>, Cube::EDGES> m_starts;
+    std::array<std::vector<float>, Cube::EDGES> m_ends;
+
+    /// The coordinates of the corners, index corner * 3 + axis. Only valid after compute().
+    std::array<std::vector<float>, CORNER_COORDINATES> m_corners;
+    /// One bit per face whose diagonal is flipped to keep it convex. Only valid after compute().
+    std::vector<std::uint8_t> m_face_splits;
+
+public:
+    /// The number of cubes which are processed at once by compute().
+    [[nodiscard]] static std::size_t lanes() noexcept;
+
+    /// Reserve the memory for the given number of cubes.
+    void reserve(std::size_t size);
+    /// Remove all cubes.
+    void clear() noexcept;
+
+    /// @brief Append a cube, it is processed by the next compute().
+    /// @param cube A Type::NORMAL cube.
+    void add(const Cube &cube);
+    /// @brief Append many cubes, which is faster than adding them one at a time.
+    /// @param cubes Type::NORMAL cubes.
+    void add(std::span<const Cube *const> cubes);
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return m_sizes.size();
+    }
+
+    /// Compute the corners and the face splits of all cubes.
+    void compute();
+
+    /// @brief The corners of a cube in the order of Cube::vertices(). Only valid after compute().
+    /// @param idx The index of the cube, in the order the cubes were added.
+    [[nodiscard]] std::array<glm::vec3, 8> vertices(std::size_t idx) const;
+
+    /// @brief The faces of a cube whose diagonal is flipped, bit i is face i in the order x = 0, x = 1, y = 0, ...
+    /// Only valid after compute().
+    /// @param idx The index of the cube, in the order the cubes were added.
+    [[nodiscard]] std::uint8_t face_splits(std::size_t idx) const {
+        return m_face_splits[idx];
+    }
+
+    /// @brief The triangles of a cube, the same as the polygon cache of the cube. Only valid after compute().
+    /// @param idx The index of the cube, in the order the cubes were added.
+    [[nodiscard]] CubePolygons polygons(std::size_t idx) const;
+};
+
+} // namespace inexor::vulkan_renderer::world
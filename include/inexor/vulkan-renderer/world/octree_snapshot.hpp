@@ -0,0 +1,61 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// An immutable cube of an OctreeSnapshot.
+struct SnapshotNode {
+    Cube::Type type{Cube::Type::EMPTY};
+    /// Only valid for Cube::Type::NORMAL.
+    std::array<Indentation, Cube::EDGES> indentations;
+    /// Only valid for Cube::Type::OCTANT.
+    std::array<std::shared_ptr<const SnapshotNode>, Cube::SUB_CUBES> children;
+    /// The triangles of a geometry cube, like Cube::polygons().
+    PolygonCache polygons;
+};
+
+/// @brief A persistent, read-only copy of an octree, created by Cube::snapshot().
+/// Consecutive snapshots share the nodes of all subtrees which were not changed in between, so only the changed
+/// paths are copied. As no node is ever modified, snapshots can be read by any number of threads while the octree
+/// is edited, e.g. for meshing or collision checks.
+class OctreeSnapshot {
+private:
+    std::shared_ptr<const SnapshotNode> m_root;
+    float m_size{32};
+    glm::vec3 m_position{0.0f, 0.0f, 0.0f};
+
+    /// Rebuild the cube from the node, recursive. The polygons are appended to the polygon arena of the new octree.
+    static void restore(const std::shared_ptr<const SnapshotNode> &node, Cube &cube, PolygonArena &arena);
+
+public:
+    OctreeSnapshot(std::shared_ptr<const SnapshotNode> root, float size, const glm::vec3 &position);
+
+    [[nodiscard]] const std::shared_ptr<const SnapshotNode> &root() const noexcept {
+        return m_root;
+    }
+
+    [[nodiscard]] glm::vec3 position() const noexcept {
+        return m_position;
+    }
+
+    [[nodiscard]] float size() const noexcept {
+        return m_size;
+    }
+
+    /// Count the number of Type::SOLID and Type::NORMAL cubes.
+    [[nodiscard]] std::size_t count_geometry_cubes() const;
+    /// Collect the polygons of all geometry cubes in the same order as Cube::polygons().
+    [[nodiscard]] std::vector<PolygonCache> polygons() const;
+    /// Create an independent octree from the snapshot, whose later snapshots share the nodes of this one.
+    [[nodiscard]] std::shared_ptr<Cube> to_cube() const;
+};
+
+} // namespace inexor::vulkan_renderer::world
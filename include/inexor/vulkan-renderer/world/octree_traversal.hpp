@@ -0,0 +1,119 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace inexor::vulkan_renderer::world {
+
+/// What happens after a cube was visited.
+enum class TraversalAction {
+    /// Visit the children of the cube, if it is an octant.
+    CONTINUE,
+    /// Do not visit the children of the cube.
+    SKIP_CHILDREN,
+    /// Stop the traversal.
+    STOP,
+};
+
+namespace detail {
+
+/// Call a visitor with the cube and, if it accepts it, the depth of the cube relative to the traversal root.
+/// Visitors which return nothing always continue.
+template <typename Visitor, typename CubeType>
+TraversalAction visit(Visitor &visitor, CubeType &cube, const std::size_t depth) {
+    if constexpr (std::is_invocable_v<Visitor &, CubeType &, std::size_t>) {
+        if constexpr (std::is_void_v<std::invoke_result_t<Visitor &, CubeType &, std::size_t>>) {
+            visitor(cube, depth);
+            return TraversalAction::CONTINUE;
+        } else {
+            return visitor(cube, depth);
+        }
+    } else {
+        if constexpr (std::is_void_v<std::invoke_result_t<Visitor &, CubeType &>>) {
+            visitor(cube);
+            return TraversalAction::CONTINUE;
+        } else {
+            return visitor(cube);
+        }
+    }
+}
+
+} // namespace detail
+
+/// @brief Visit a cube and all its descendants depth-first, the children of an octant in ascending order.
+/// The traversal keeps its own stack of Cube::MAX_DEPTH + 1 entries, which is enough as Cube::set_type() rejects deeper
+/// octants, so it neither recurses nor allocates, and the visitors are called directly, which allows the compiler to
+/// inline them.
+/// A visitor is called with ``(cube)`` or ``(cube, depth)``, where depth is 0 for the cube the traversal starts with.
+/// It either returns nothing or a TraversalAction.
+/// @param cube The cube to start with, which may be const.
+/// @param pre_visit Called before the children of a cube are visited. It may change the type of the cube, the
+/// children are only visited if the cube is an octant afterwards. SKIP_CHILDREN prunes the subtree.
+/// @param post_visit Called after the children of a cube were visited, or right after pre_visit if there are none.
+/// Only STOP has an effect.
+/// @return ``False`` if the traversal was stopped by a visitor.
+template <typename CubeType, typename PreVisitor, typename PostVisitor>
+bool traverse(CubeType &cube, PreVisitor &&pre_visit, PostVisitor &&post_visit) {
+    static_assert(std::is_same_v<std::remove_const_t<CubeType>, Cube>);
+    struct Frame {
+        CubeType *cube;
+        // Cube::children() is not inlined, so the range of children is fetched once per octant.
+        const std::shared_ptr<Cube> *next_child;
+        const std::shared_ptr<Cube> *end;
+    };
+    std::array<Frame, Cube::MAX_DEPTH + 1> stack;
+    std::size_t stack_size = 0;
+
+    // Cubes without children to visit are finished right away, only octants are put on the stack.
+    const auto enter = [&](CubeType &current) {
+        const TraversalAction action = detail::visit(pre_visit, current, stack_size);
+        if (action == TraversalAction::STOP) {
+            return false;
+        }
+        if (action == TraversalAction::CONTINUE && current.type() == Cube::Type::OCTANT) {
+            assert(stack_size < stack.size() && "Octree too deep!");
+            const auto &children = current.children();
+            stack[stack_size++] = {&current, children.data(), children.data() + children.size()};
+            return true;
+        }
+        return detail::visit(post_visit, current, stack_size) != TraversalAction::STOP;
+    };
+
+    if (!enter(cube)) {
+        return false;
+    }
+    while (stack_size > 0) {
+        Frame &frame = stack[stack_size - 1];
+        if (frame.next_child != frame.end) {
+            if (!enter(**frame.next_child++)) {
+                return false;
+            }
+            continue;
+        }
+        stack_size--;
+        if (detail::visit(post_visit, *frame.cube, stack_size) == TraversalAction::STOP) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @brief Visit a cube and all its descendants in pre-order, see traverse().
+template <typename CubeType, typename Visitor>
+bool traverse_pre_order(CubeType &cube, Visitor &&visitor) {
+    return traverse(cube, std::forward<Visitor>(visitor), [](CubeType &) {});
+}
+
+/// @brief Visit a cube and all its descendants in post-order, see traverse().
+template <typename CubeType, typename Visitor>
+bool traverse_post_order(CubeType &cube, Visitor &&visitor) {
+    return traverse(cube, [](CubeType &) {}, std::forward<Visitor>(visitor));
+}
+
+} // namespace inexor::vulkan_renderer::world
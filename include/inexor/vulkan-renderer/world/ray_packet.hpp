@@ -0,0 +1,82 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+// Forward declarations
+namespace inexor::vulkan_renderer::tools {
+class ThreadPool;
+} // namespace inexor::vulkan_renderer::tools
+
+namespace inexor::vulkan_renderer::world {
+class Cube;
+} // namespace inexor::vulkan_renderer::world
+
+namespace inexor::vulkan_renderer::world {
+
+/// @brief The nearest hits of a batch of rays, as a structure of arrays. Index i is the hit of ray i.
+struct RayHits {
+    /// The cube which is hit, nullptr if the ray hits nothing.
+    std::vector<const Cube *> cubes;
+    /// The parameter along the direction at which the ray enters the cube or hits its triangle, so the intersection is
+    /// position + distance * direction. It is 0 if the ray starts inside a solid cube and infinity if the ray hits
+    /// nothing.
+    std::vector<float> distances;
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return cubes.size();
+    }
+};
+
+/// @brief Check for collisions between many rays and octree geometry.
+/// The rays are traversed in packets of 8 rays with AVX or of 4 rays with SSE, so every cube is tested against all
+/// rays of a packet with one slab test. A packet only descends into the cubes which at least one of its rays enters
+/// before its nearest hit so far, so consecutive rays should be coherent, for example the rays of neighboring pixels.
+/// The children are visited front to back along the direction of the first ray of a packet.
+/// @note See the thread safety of Cube for reading the octree from several threads.
+/// @param cube The cube to check collisions with.
+/// @param positions The start positions of the rays.
+/// @param directions The directions of the rays, the same number as positions.
+/// @param cubes The hit cube of every ray is written to it, the same number as positions.
+/// @param distances The distance of every hit is written to it, see RayHits::distances.
+/// @param max_depth The maximum subcube iteration depth, see ray_cube_collision_check().
+/// Type::NORMAL cubes are hit on their triangles like in ray_cube_collision_check(), one ray at a time.
+/// @note The hits are the same as the ones of ray_cube_collision_check(), except for rays which enter several cubes
+/// at the same distance.
+void ray_packet_collision_check(const Cube &cube, std::span<const glm::vec3> positions,
+                                std::span<const glm::vec3> directions, std::span<const Cube *> cubes,
+                                std::span<float> distances, std::optional<std::uint32_t> max_depth = std::nullopt);
+
+/// @brief Check for collisions between many rays and octree geometry, see the overload above.
+/// @param cube The cube to check collisions with.
+/// @param positions The start positions of the rays.
+/// @param directions The directions of the rays, the same number as positions.
+/// @param hits The hits, it is resized to the number of rays and can be reused without allocating.
+/// @param max_depth The maximum subcube iteration depth, see ray_cube_collision_check().
+void ray_packet_collision_check(const Cube &cube, std::span<const glm::vec3> positions,
+                                std::span<const glm::vec3> directions, RayHits &hits,
+                                std::optional<std::uint32_t> max_depth = std::nullopt);
+
+/// @brief Check for collisions between many rays and octree geometry in parallel.
+/// The rays are split into tasks of rays_per_task rays, which the thread pool checks like the overloads above. Every
+/// task has its own traversal stack and writes its own range of the hits, and the octree is only read, so there is no
+/// locking. The pending rotations of the octree are applied before, as children() would apply them otherwise.
+/// The hits are the same as the ones of the overloads above.
+/// @note The octree must not be modified until this returns.
+/// @param thread_pool The thread pool which checks the rays, the calling thread helps.
+/// @param cube The cube to check collisions with.
+/// @param positions The start positions of the rays.
+/// @param directions The directions of the rays, the same number as positions.
+/// @param hits The hits, it is resized to the number of rays and can be reused without allocating.
+/// @param rays_per_task The number of rays per task, which is rounded up to whole packets.
+/// @param max_depth The maximum subcube iteration depth, see ray_cube_collision_check().
+void ray_packet_collision_check(tools::ThreadPool &thread_pool, const Cube &cube,
+                                std::span<const glm::vec3> positions, std::span<const glm::vec3> directions,
+                                RayHits &hits, std::size_t rays_per_task = 1024,
+                                std::optional<std::uint32_t> max_depth = std::nullopt);
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// @brief A read-only octree in which identical subtrees are stored only once (a sparse voxel DAG).
+/// Every subtree is hashed by its type, indentations and children while the DAG is built from a Cube. If an equal
+/// subtree exists already, the existing node is used instead, so repeated geometry costs a single node per level.
+/// As a node can appear at many places, it does not know its position or size. They are tracked by Location while
+/// walking down from the root.
+class SparseVoxelDag {
+public:
+    /// Index of a unique node.
+    using NodeId = std::uint32_t;
+    /// Marks a missing child.
+    static constexpr NodeId INVALID_NODE{std::numeric_limits<NodeId>::max()};
+
+    /// A node at one of its places in the octree.
+    struct Location {
+        NodeId id{INVALID_NODE};
+        glm::vec3 position{0.0f, 0.0f, 0.0f};
+        float size{0};
+
+        [[nodiscard]] glm::vec3 center() const noexcept {
+            return position + 0.5f * size;
+        }
+
+        [[nodiscard]] std::array<glm::vec3, 2> bounding_box() const {
+            return {position, {position.x + size, position.y + size, position.z + size}};
+        }
+    };
+
+    /// The first geometry cube which is hit by a ray.
+    struct RayCollision {
+        Location location;
+        /// Distance from the start of the ray to the intersection, in units of the ray direction.
+        float distance;
+        /// The point where the ray enters the bounding box of the cube.
+        glm::vec3 intersection;
+    };
+
+private:
+    struct Node {
+        Cube::Type type{Cube::Type::EMPTY};
+        /// Index into m_children for Cube::Type::OCTANT, into m_indentations for Cube::Type::NORMAL.
+        std::uint32_t data{0};
+    };
+
+    float m_size{32};
+    glm::vec3 m_position{0.0f, 0.0f, 0.0f};
+    NodeId m_root{INVALID_NODE};
+    /// Number of cubes of the octree the DAG was built from.
+    std::size_t m_tree_node_count{0};
+
+    std::vector<Node> m_nodes;
+    std::vector<std::array<NodeId, Cube::SUB_CUBES>> m_children;
+    std::vector<std::array<Indentation, Cube::EDGES>> m_indentations;
+
+public:
+    /// Build the DAG from a pointer-based octree.
+    /// @note See the thread safety of Cube for reading the octree from several threads.
+    explicit SparseVoxelDag(const Cube &cube);
+
+    /// Number of unique nodes.
+    [[nodiscard]] std::size_t node_count() const noexcept {
+        return m_nodes.size();
+    }
+    /// Number of cubes of the octree the DAG was built from.
+    [[nodiscard]] std::size_t tree_node_count() const noexcept {
+        return m_tree_node_count;
+    }
+    /// Number of bytes allocated by the DAG.
+    [[nodiscard]] std::size_t memory_usage() const noexcept;
+
+    [[nodiscard]] Location root() const noexcept {
+        return {m_root, m_position, m_size};
+    }
+    /// Get type.
+    [[nodiscard]] Cube::Type type(NodeId id) const;
+    /// Get the child, INVALID_NODE if the node is not a Cube::Type::OCTANT.
+    [[nodiscard]] NodeId child(NodeId id, std::size_t idx) const;
+    /// Get the child with its position and size.
+    [[nodiscard]] Location child(const Location &location, std::size_t idx) const;
+    /// Get indentations, should only be used on Cube::Type::NORMAL.
+    [[nodiscard]] const std::array<Indentation, Cube::EDGES> &indentations(NodeId id) const;
+
+    /// Count the number of Cube::Type::SOLID and Cube::Type::NORMAL cubes of the whole octree.
+    /// Every unique node is only counted once and multiplied by the number of places it appears at.
+    [[nodiscard]] std::size_t count_geometry_cubes() const;
+    /// Find the leaf which contains the point.
+    /// @return The leaf, or std::nullopt if the point is outside of the octree.
+    [[nodiscard]] std::optional<Location> find_leaf(const glm::vec3 &point) const;
+    /// Collect the polygons of all geometry cubes in the same order as Cube::polygons.
+    [[nodiscard]] std::vector<Polygon> polygons() const;
+    /// Find the nearest geometry cube whose bounding box is hit by the ray.
+    /// The children of an octant are visited front to back, so the search stops at the first hit.
+    /// @param position The start of the ray.
+    /// @param direction The direction of the ray.
+    [[nodiscard]] std::optional<RayCollision> ray_collision(const glm::vec3 &position,
+                                                            const glm::vec3 &direction) const;
+};
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <vector>
+
+// Forward declaration
+namespace inexor::vulkan_renderer::world {
+class Cube;
+} // namespace inexor::vulkan_renderer::world
+
+namespace inexor::vulkan_renderer::world {
+
+/// @brief Find the leaf which contains a point.
+/// The point is converted into integer coordinates on the grid of the deepest level, whose bits select the child
+/// on every level like the locational code does, so there is no comparison with the bounds of the cubes.
+/// Points on the boundary between two cubes belong to the one with the larger coordinates, except on the far faces
+/// of the given cube.
+/// @note See the thread safety of Cube for reading the octree from several threads.
+/// @param cube The cube to start with, usually the root of a world.
+/// @param point The point.
+/// @return The leaf which contains the point, nullptr if the point is outside of the cube.
+[[nodiscard]] const Cube *find_leaf(const Cube &cube, const glm::vec3 &point);
+/// @copydoc find_leaf(const Cube &, const glm::vec3 &)
+[[nodiscard]] Cube *find_leaf(Cube &cube, const glm::vec3 &point);
+
+/// @brief Collect the leaves which overlap a box, including Type::EMPTY leaves.
+/// The box is converted into a range of integer coordinates on the grid of the deepest level, so the children are
+/// selected by integer comparisons. Leaves which touch the box are included.
+/// @note See the thread safety of Cube for reading the octree from several threads.
+/// @param cube The cube to start with, usually the root of a world.
+/// @param box_bounds An array of two vectors which represent the edges of the bounding box.
+/// @param leaves The leaves are appended in the order of Cube::polygons(), it is not cleared so it can be reused
+/// without allocating.
+void query_box(const Cube &cube, const std::array<glm::vec3, 2> &box_bounds, std::vector<const Cube *> &leaves);
+
+/// @brief Collect the leaves which overlap a sphere, including Type::EMPTY leaves.
+/// The octants outside of the bounding box of the sphere are skipped like query_box() does, the remaining ones are
+/// tested against the sphere. Leaves which touch the sphere are included.
+/// @note See the thread safety of Cube for reading the octree from several threads.
+/// @param cube The cube to start with, usually the root of a world.
+/// @param center The center of the sphere.
+/// @param radius The radius of the sphere.
+/// @param leaves The leaves are appended in the order of Cube::polygons(), it is not cleared so it can be reused
+/// without allocating.
+void query_sphere(const Cube &cube, const glm::vec3 &center, float radius, std::vector<const Cube *> &leaves);
+
+} // namespace inexor::vulkan_renderer::world
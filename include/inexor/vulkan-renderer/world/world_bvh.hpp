@@ -0,0 +1,60 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/collision.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+// Forward declaration
+class Cube;
+
+/// @brief A bounding volume hierarchy over the bounding boxes of the root cubes of many worlds.
+/// Every node has two children and the leaves hold one world each. The worlds are split at the median of their
+/// centers along the axis in which the centers spread the most, so the depth is logarithmic in the number of worlds.
+/// A ray visits the nearer child of every node first and skips all nodes which it enters behind its nearest hit, so
+/// the cost of a ray check hardly grows with the number of worlds.
+/// @note The bounding box of a world only depends on the position and the size of its root cube, so the hierarchy
+/// stays valid while the worlds are edited. It has to be rebuilt if worlds are added, removed or moved. Queries read
+/// the worlds like ray_cube_collision_check(), see the thread safety of Cube.
+class WorldBvh {
+    struct Node {
+        std::array<glm::vec3, 2> bounds;
+        /// The index of the first child for inner nodes, the second child follows it. The index of the world for
+        /// leaves.
+        std::uint32_t index{0};
+        bool leaf{false};
+    };
+
+    std::vector<Node> m_nodes;
+    std::vector<std::shared_ptr<Cube>> m_worlds;
+
+    /// Build the subtree of the worlds first to last into the given node.
+    void build(std::size_t node, std::vector<std::uint32_t> &worlds, std::size_t first, std::size_t last);
+
+public:
+    WorldBvh() = default;
+    /// @param worlds The worlds, they are shared with the hierarchy.
+    explicit WorldBvh(std::vector<std::shared_ptr<Cube>> worlds);
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return m_worlds.size();
+    }
+
+    /// @brief Check for a collision between a ray and the geometry of all worlds.
+    /// @param pos The start position of the ray.
+    /// @param dir The direction of the ray.
+    /// @param max_depth The maximum subcube iteration depth, see ray_cube_collision_check().
+    /// @return The collision which is the nearest to the start position, std::nullopt if there is none.
+    [[nodiscard]] std::optional<RayCubeCollision<Cube>>
+    ray_cube_collision_check(const glm::vec3 &pos, const glm::vec3 &dir,
+                             std::optional<std::uint32_t> max_depth = std::nullopt) const;
+};
+
+} // namespace inexor::vulkan_renderer::world
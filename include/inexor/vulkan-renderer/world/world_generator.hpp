@@ -0,0 +1,81 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+// Forward declaration
+namespace inexor::vulkan_renderer::tools {
+class ThreadPool;
+} // namespace inexor::vulkan_renderer::tools
+
+namespace inexor::vulkan_renderer::world {
+
+// Forward declaration
+class Cube;
+
+/// The terrain of WorldGenerator's heightfield mode, made of value noise.
+struct Heightfield {
+    /// The mean height of the terrain.
+    float base_height{2.0f};
+    /// The largest distance of the terrain from the mean height.
+    float amplitude{1.5f};
+    /// The distance between the lattice points of the first octave of the noise.
+    float wavelength{2.0f};
+    /// The number of octaves, each one has half the wavelength and half the amplitude of the previous one.
+    std::uint32_t octaves{3};
+};
+
+/// @brief Generates octrees whose content only depends on the seed and the position of every cube.
+/// Every random number is derived from the seed, the locational code of the cube and a counter, instead of being
+/// drawn from a sequence. So subtrees can be generated in any order and on any number of threads with the same
+/// result, and a cube does not change if other parts of the generation change.
+/// Without a heightfield, the leaves are filled like create_random_world() does: empty 30%, solid 30% and normal 40%
+/// with evenly distributed indentations. With a heightfield, the cubes below the terrain are solid, the ones above
+/// are empty and the leaves which the terrain passes through are normal cubes whose top corners follow it.
+class WorldGenerator {
+private:
+    std::uint64_t m_seed;
+    std::uint32_t m_max_depth;
+    std::optional<Heightfield> m_heightfield;
+
+    /// The height of the terrain at the given position.
+    [[nodiscard]] float height(float x, float z) const;
+    /// Set the type and the indentations of a cube at the given depth, octants create their children.
+    void fill(Cube &cube, std::size_t depth) const;
+    /// Fill a leaf with a random type.
+    void fill_random(Cube &cube) const;
+    /// Fill a cube from the heightfield.
+    void fill_heightfield(Cube &cube, std::size_t depth) const;
+    /// Fill a cube and all its descendants.
+    void generate_subtree(Cube &cube, std::size_t depth) const;
+
+public:
+    /// @param seed The seed of the world.
+    /// @param max_depth The maximum of nested octants, like create_random_world().
+    /// @param heightfield The terrain, std::nullopt for randomly filled leaves.
+    WorldGenerator(std::uint64_t seed, std::uint32_t max_depth, std::optional<Heightfield> heightfield = std::nullopt);
+
+    /// @brief A random number which only depends on its arguments, counter-based like Random123.
+    /// @param seed The seed of the world.
+    /// @param key The identifier of what the number is drawn for, e.g. the locational code of a cube.
+    /// @param counter The index of the number which is drawn for this key.
+    [[nodiscard]] static std::uint64_t random(std::uint64_t seed, std::uint64_t key, std::uint64_t counter) noexcept;
+
+    /// @brief Generate a world.
+    /// @param position The position of the root cube.
+    /// @param size The size of the root cube.
+    [[nodiscard]] std::shared_ptr<Cube> generate(const glm::vec3 &position, float size = 4.0f) const;
+
+    /// @brief Generate a world in parallel, with the same result as generate(position, size).
+    /// @param thread_pool The thread pool.
+    /// @param split_depth The depth at which the octree is split into subtrees which are generated on their own.
+    /// @param position The position of the root cube.
+    /// @param size The size of the root cube.
+    [[nodiscard]] std::shared_ptr<Cube> generate(tools::ThreadPool &thread_pool, std::size_t split_depth,
+                                                 const glm::vec3 &position, float size = 4.0f) const;
+};
+
+} // namespace inexor::vulkan_renderer::world
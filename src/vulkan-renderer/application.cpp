@@ -7,6 +7,9 @@
 #include "inexor/vulkan-renderer/tools/cla_parser.hpp"
 #include "inexor/vulkan-renderer/vk_tools/enumerate.hpp"
 #include "inexor/vulkan-renderer/world/collision.hpp"
+#include "inexor/vulkan-renderer/world/frustum.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+#include "inexor/vulkan-renderer/world/world_generator.hpp"
 #include "inexor/vulkan-renderer/wrapper/cpu_texture.hpp"
 #include "inexor/vulkan-renderer/wrapper/descriptor_builder.hpp"
 #include "inexor/vulkan-renderer/wrapper/instance.hpp"
@@ -14,8 +17,12 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <toml.hpp>
 
+#include <algorithm>
+#include <iterator>
 #include <random>
 #include <thread>
+#include <tuple>
+#include <utility>
 
 namespace inexor::vulkan_renderer {
 
@@ -190,25 +197,199 @@ void Application::load_shaders() {
 void Application::load_octree_geometry(bool initialize) {
     spdlog::trace("Creating octree geometry");
 
+    if (m_chunk_manager) {
+        // The camera does not exist at startup, so the chunks around the origin are loaded first.
+        if (initialize) {
+            m_chunk_manager->update(glm::vec3(0.0f), m_view_distance);
+            m_chunk_manager->wait();
+        }
+        m_worlds = m_chunk_manager->resident_chunks();
+        m_world_bvh = world::WorldBvh(m_worlds);
+        // The chunks which stay resident keep their meshes.
+        update_octree_vertices(initialize);
+        return;
+    }
+
     // 4: 23 012 | 5: 184352 | 6: 1474162 | 7: 11792978 cubes, DO NOT USE 7!
+    static std::random_device random_device;
+    const auto generate = [&](const std::uint64_t seed, const glm::vec3 &position) {
+        const world::WorldGenerator generator(initialize ? seed : random_device(), 2, m_heightfield);
+        return generator.generate(m_thread_pool, m_polygon_split_depth, position);
+    };
     m_worlds.clear();
-    m_worlds.push_back(
-        world::create_random_world(2, {0.0f, 0.0f, 0.0f}, initialize ? std::optional(42) : std::nullopt));
-    m_worlds.push_back(
-        world::create_random_world(2, {10.0f, 0.0f, 0.0f}, initialize ? std::optional(60) : std::nullopt));
+    m_worlds.push_back(generate(42, {0.0f, 0.0f, 0.0f}));
+    m_worlds.push_back(generate(60, {10.0f, 0.0f, 0.0f}));
+    for (const auto &world : m_worlds) {
+        const std::size_t reclaimed = world->compact();
+        spdlog::trace("Octree compaction removed {} cubes", reclaimed);
+    }
+    m_world_bvh = world::WorldBvh(m_worlds);
+    update_octree_vertices(true);
+}
 
+void Application::mesh_chunk(const world::Cube &chunk, std::vector<OctreeGpuVertex> &vertices) {
+    const auto add_triangle = [&](const world::Polygon &triangle) {
+        for (const auto &vertex : triangle) {
+            glm::vec3 color = {
+                static_cast<float>(rand()) / static_cast<float>(RAND_MAX),
+                static_cast<float>(rand()) / static_cast<float>(RAND_MAX),
+                static_cast<float>(rand()) / static_cast<float>(RAND_MAX),
+            };
+            vertices.emplace_back(vertex, color);
+        }
+    };
+    if (m_mesher == world::Mesher::GREEDY) {
+        // The greedy mesher always leaves out the hidden faces.
+        for (const auto &triangle : world::greedy_mesh(chunk)) {
+            add_triangle(triangle);
+        }
+    } else if (m_level_of_detail) {
+        // Far away octants are replaced by boxes, which don't know about their neighbors.
+        for (const auto &polygons : chunk.lod_polygons(m_lod_position, m_lod_size_ratio)) {
+            for (const auto &triangle : polygons) {
+                add_triangle(triangle);
+            }
+        }
+    } else if (m_cull_hidden_faces) {
+        // The callers update the polygon caches first, so only the hidden faces need to be removed.
+        for (const auto &triangle : chunk.visible_polygons()) {
+            add_triangle(triangle);
+        }
+    } else {
+        // The polygons of the chunk are one range of the polygon arena of the world.
+        for (const auto &triangle : chunk.polygons()) {
+            add_triangle(triangle);
+        }
+    }
+}
+
+void Application::mesh_world(const world::Cube &world, OctreeMesh &mesh) {
+    mesh.vertices.clear();
+    mesh.chunks.clear();
+    // An upper bound, as hidden faces and level of detail leave out triangles.
+    mesh.vertices.reserve(world.statistics().triangles() * 3);
+    // Update the polygon caches in parallel first.
+    static_cast<void>(world.polygons(m_thread_pool, m_polygon_split_depth));
+    const std::size_t chunk_depth = octree_chunk_depth();
+    world::traverse_pre_order(world, [&](const world::Cube &chunk, const std::size_t depth) {
+        if (chunk.type() == world::Cube::Type::OCTANT && depth < chunk_depth) {
+            return world::TraversalAction::CONTINUE;
+        }
+        const auto first_vertex = static_cast<std::uint32_t>(mesh.vertices.size());
+        mesh_chunk(chunk, mesh.vertices);
+        // generate_octree_indices() keeps the order of the vertices, so the indices are in the same range.
+        const auto vertex_count = static_cast<std::uint32_t>(mesh.vertices.size()) - first_vertex;
+        mesh.chunks[&chunk] = {first_vertex, vertex_count};
+        return world::TraversalAction::SKIP_CHILDREN;
+    });
+    generate_octree_indices(mesh.vertices, mesh.indices);
+}
+
+bool Application::remesh_octree_lod(const glm::vec3 &previous_lod_position) {
+    bool remeshed = false;
+    for (const auto &octree : m_worlds) {
+        const auto mesh = m_octree_meshes.find(octree);
+        if (mesh == m_octree_meshes.end()) {
+            continue;
+        }
+        // The chunks in the order of their vertices, together with whether their level of detail changed.
+        std::vector<std::tuple<const world::Cube *, IndexRange, bool>> chunks;
+        chunks.reserve(mesh->second.chunks.size());
+        bool changed = false;
+        for (const auto &[chunk, range] : mesh->second.chunks) {
+            const bool chunk_changed =
+                chunk->lod_selection_changed(previous_lod_position, m_lod_position, m_lod_size_ratio);
+            chunks.emplace_back(chunk, range, chunk_changed);
+            changed = changed || chunk_changed;
+        }
+        if (!changed) {
+            continue;
+        }
+        std::sort(chunks.begin(), chunks.end(), [](const auto &lhs, const auto &rhs) {
+            return std::get<1>(lhs).first_index < std::get<1>(rhs).first_index;
+        });
+        // The polygon caches are read by the chunks which are meshed again.
+        static_cast<void>(octree->polygons(m_thread_pool, m_polygon_split_depth));
+        OctreeMesh &world_mesh = mesh->second;
+        std::vector<OctreeGpuVertex> vertices;
+        vertices.reserve(world_mesh.vertices.size());
+        for (const auto &[chunk, range, chunk_changed] : chunks) {
+            const auto first_vertex = static_cast<std::uint32_t>(vertices.size());
+            if (chunk_changed) {
+                mesh_chunk(*chunk, vertices);
+            } else {
+                // The other chunks keep their vertices and colors, only their range is moved.
+                const auto first = world_mesh.vertices.begin() + range.first_index;
+                vertices.insert(vertices.end(), first, first + range.index_count);
+            }
+            const auto vertex_count = static_cast<std::uint32_t>(vertices.size()) - first_vertex;
+            world_mesh.chunks[chunk] = {first_vertex, vertex_count};
+        }
+        world_mesh.vertices = std::move(vertices);
+        generate_octree_indices(world_mesh.vertices, world_mesh.indices);
+        remeshed = true;
+    }
+    return remeshed;
+}
+
+void Application::update_octree_vertices(const bool remesh_all) {
+    if (remesh_all) {
+        m_octree_meshes.clear();
+    } else {
+        // Drop the meshes of the worlds which were removed.
+        std::erase_if(m_octree_meshes, [&](const auto &mesh) {
+            return std::find(m_worlds.begin(), m_worlds.end(), mesh.first) == m_worlds.end();
+        });
+    }
+    std::size_t vertex_count = 0;
+    std::size_t index_count = 0;
+    for (const auto &world : m_worlds) {
+        auto [mesh, added] = m_octree_meshes.try_emplace(world);
+        if (added) {
+            mesh_world(*world, mesh->second);
+        }
+        vertex_count += mesh->second.vertices.size();
+        index_count += mesh->second.indices.size();
+    }
+
+    // The meshes are copied as blocks, only their indices and index ranges are moved behind the previous meshes.
     m_octree_vertices.clear();
+    m_octree_indices.clear();
+    m_octree_chunks.clear();
+    m_octree_vertices.reserve(vertex_count);
+    m_octree_indices.reserve(index_count);
     for (const auto &world : m_worlds) {
-        for (const auto &polygons : world->polygons(true)) {
-            for (const auto &triangle : *polygons) {
-                for (const auto &vertex : triangle) {
-                    glm::vec3 color = {
-                        static_cast<float>(rand()) / static_cast<float>(RAND_MAX),
-                        static_cast<float>(rand()) / static_cast<float>(RAND_MAX),
-                        static_cast<float>(rand()) / static_cast<float>(RAND_MAX),
-                    };
-                    m_octree_vertices.emplace_back(vertex, color);
-                }
+        const OctreeMesh &mesh = m_octree_meshes.at(world);
+        const auto first_vertex = static_cast<std::uint32_t>(m_octree_vertices.size());
+        const auto first_index = static_cast<std::uint32_t>(m_octree_indices.size());
+        m_octree_vertices.insert(m_octree_vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+        std::transform(mesh.indices.begin(), mesh.indices.end(), std::back_inserter(m_octree_indices),
+                       [&](const std::uint32_t index) { return first_vertex + index; });
+        for (const auto &[chunk, range] : mesh.chunks) {
+            m_octree_chunks[chunk] = {first_index + range.first_index, range.index_count};
+        }
+    }
+}
+
+std::size_t Application::octree_chunk_depth() const {
+    return m_mesher == world::Mesher::GREEDY ? 0 : m_octree_chunk_depth;
+}
+
+void Application::cull_octree_chunks() {
+    const world::Frustum frustum(m_camera->view_matrix(), m_camera->perspective_matrix());
+    m_octree_draw_ranges.clear();
+    for (const auto &world : m_worlds) {
+        for (const auto *chunk : world::visible_subtrees(*world, frustum, octree_chunk_depth())) {
+            const IndexRange &range = m_octree_chunks.at(chunk);
+            if (range.index_count == 0) {
+                continue;
+            }
+            // Consecutive chunks are drawn with a single call.
+            auto *last = m_octree_draw_ranges.empty() ? nullptr : &m_octree_draw_ranges.back();
+            if (last != nullptr && last->first_index + last->index_count == range.first_index) {
+                last->index_count += range.index_count;
+            } else {
+                m_octree_draw_ranges.push_back(range);
             }
         }
     }
@@ -437,6 +618,32 @@ Application::Application(int argc, char **argv) {
         enable_debug_marker_device_extension = false;
     }
 
+    if (cla_parser.arg<bool>("--greedy-meshing").value_or(false)) {
+        spdlog::trace("--greedy-meshing specified, merging coplanar faces of solid cubes");
+        m_mesher = world::Mesher::GREEDY;
+    }
+
+    if (const auto chunk_directory = cla_parser.arg<std::string>("--chunk-directory")) {
+        spdlog::trace("--chunk-directory specified, loading the chunks around the camera from {}", *chunk_directory);
+        m_chunk_manager = std::make_unique<world::ChunkManager>(
+            m_thread_pool, world::ChunkManager::file_loader(*chunk_directory), m_chunk_size, m_chunk_budget);
+    }
+
+    if (cla_parser.arg<bool>("--heightfield").value_or(false)) {
+        spdlog::trace("--heightfield specified, generating worlds from noise");
+        m_heightfield = world::Heightfield{};
+    }
+
+    if (cla_parser.arg<bool>("--level-of-detail").value_or(false)) {
+        spdlog::trace("--level-of-detail specified, drawing far away octants as boxes");
+        m_level_of_detail = true;
+    }
+
+    if (cla_parser.arg<bool>("--no-hidden-face-culling").value_or(false)) {
+        spdlog::trace("--no-hidden-face-culling specified, drawing the faces which are covered by solid neighbors");
+        m_cull_hidden_faces = false;
+    }
+
     const auto physical_devices = vk_tools::get_physical_devices(m_instance->instance());
     if (preferred_graphics_card && *preferred_graphics_card >= physical_devices.size()) {
         spdlog::critical("GPU index {} out of range!", *preferred_graphics_card);
@@ -489,7 +696,6 @@ Application::Application(int argc, char **argv) {
             .build("Default uniform buffer"));
 
     load_octree_geometry(true);
-    generate_octree_indices();
 
     m_window->show();
     recreate_swapchain();
@@ -565,24 +771,19 @@ void Application::process_mouse_input() {
 }
 
 void Application::check_octree_collisions() {
-    // Check for collision between camera ray and every octree
-    for (const auto &world : m_worlds) {
-        const auto collision = ray_cube_collision_check(*world, m_camera->position(), m_camera->front());
-
-        if (collision) {
-            const auto intersection = collision.value().intersection();
-            const auto face_normal = collision.value().face();
-            const auto corner = collision.value().corner();
-            const auto edge = collision.value().edge();
-
-            spdlog::trace("pos {} {} {} | face {} {} {} | corner {} {} {} | edge {} {} {}", intersection.x,
-                          intersection.y, intersection.z, face_normal.x, face_normal.y, face_normal.z, corner.x,
-                          corner.y, corner.z, edge.x, edge.y, edge.z);
-
-            // Break after one collision.
-            break;
-        }
+    // Find the nearest collision between the camera ray and all octrees
+    const auto collision = m_world_bvh.ray_cube_collision_check(m_camera->position(), m_camera->front());
+    if (!collision) {
+        return;
     }
+    const auto intersection = collision.value().intersection();
+    const auto face_normal = collision.value().face();
+    const auto corner = collision.value().corner();
+    const auto edge = collision.value().edge();
+
+    spdlog::trace("pos {} {} {} | face {} {} {} | corner {} {} {} | edge {} {} {}", intersection.x, intersection.y,
+                  intersection.z, face_normal.x, face_normal.y, face_normal.z, corner.x, corner.y, corner.z, edge.x,
+                  edge.y, edge.z);
 }
 
 void Application::run() {
@@ -592,14 +793,30 @@ void Application::run() {
         m_window->poll();
         update_uniform_buffers();
         update_imgui_overlay();
+        cull_octree_chunks();
         render_frame();
         process_mouse_input();
         if (m_input_data->was_key_pressed_once(GLFW_KEY_N)) {
             load_octree_geometry(false);
-            generate_octree_indices();
             m_index_buffer->upload_data(m_octree_indices);
             m_vertex_buffer->upload_data(m_octree_vertices);
         }
+        if (m_chunk_manager && m_chunk_manager->update(m_camera->position(), m_view_distance)) {
+            load_octree_geometry(false);
+            m_index_buffer->upload_data(m_octree_indices);
+            m_vertex_buffer->upload_data(m_octree_vertices);
+        }
+        if (m_level_of_detail && m_mesher != world::Mesher::GREEDY &&
+            glm::distance(m_camera->position(), m_lod_position) > m_lod_update_distance) {
+            const glm::vec3 previous_lod_position = m_lod_position;
+            m_lod_position = m_camera->position();
+            // Only the chunks in which an octant is replaced by its proxy or the other way round are meshed again.
+            if (remesh_octree_lod(previous_lod_position)) {
+                update_octree_vertices(false);
+                m_index_buffer->upload_data(m_octree_indices);
+                m_vertex_buffer->upload_data(m_octree_vertices);
+            }
+        }
         m_camera->update(m_time_passed);
         m_time_passed = m_stopwatch.time_step();
         check_octree_collisions();
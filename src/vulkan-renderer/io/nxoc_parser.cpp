@@ -3,10 +3,12 @@
 #include "inexor/vulkan-renderer/io/byte_stream.hpp"
 #include "inexor/vulkan-renderer/io/exception.hpp"
 #include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/linear_octree.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
 
 #include <fstream>
-#include <functional>
 #include <utility>
+#include <vector>
 
 namespace inexor::vulkan_renderer::io {
 template <>
@@ -15,51 +17,99 @@ ByteStream NXOCParser::serialize_impl<0>(const std::shared_ptr<const world::Cube
     writer.write<std::string>("Inexor Octree");
     writer.write<std::uint32_t>(0);
 
-    std::function<void(const std::shared_ptr<const world::Cube> &)> iter_func;
-    // pre-order traversal
-    iter_func = [&iter_func, &writer](const std::shared_ptr<const world::Cube> &cube) {
-        writer.write(cube->type());
-        if (cube->type() == world::Cube::Type::OCTANT) {
-            for (const auto &child : cube->children()) {
-                iter_func(child);
-            }
-            return;
+    world::traverse_pre_order(*cube, [&writer](const world::Cube &current) {
+        writer.write(current.type());
+        if (current.type() == world::Cube::Type::NORMAL) {
+            writer.write(current.indentations());
+        }
+    });
+    return writer;
+}
+
+template <>
+std::shared_ptr<world::Cube> NXOCParser::deserialize_impl<0>(const ByteStream &stream, const float size,
+                                                             const glm::vec3 &position) {
+    ByteStreamReader reader(stream);
+    std::shared_ptr<world::Cube> root = std::make_shared<world::Cube>(size, position);
+
+    // Skip identifier, which is already checked.
+    reader.skip(13);
+    // Skip version.
+    reader.skip(4);
+
+    // The children of an octant are created by set_type, before the traversal visits them.
+    world::traverse_pre_order(*root, [&reader](world::Cube &cube, const std::size_t depth) {
+        const auto type = reader.read<world::Cube::Type>();
+        // The children would be deeper than the locational code and the traversal stack allow.
+        if (type == world::Cube::Type::OCTANT && depth >= world::Cube::MAX_DEPTH) {
+            throw IoException("Octree too deep");
         }
-        if (cube->type() == world::Cube::Type::NORMAL) {
-            writer.write(cube->indentations());
+        cube.set_type(type);
+        if (cube.type() == world::Cube::Type::NORMAL) {
+            cube.m_indentations = reader.read<std::array<world::Indentation, world::Cube::EDGES>>();
         }
-    };
+    });
+    return root;
+}
+
+template <>
+ByteStream NXOCParser::serialize_linear_impl<0>(const world::LinearOctree &octree) { // NOLINT
+    ByteStreamWriter writer;
+    writer.write<std::string>("Inexor Octree");
+    writer.write<std::uint32_t>(0);
 
-    iter_func(cube);
+    // Pre-order, so the children are pushed in reverse order.
+    std::vector<world::LinearOctree::NodeId> stack{world::LinearOctree::ROOT};
+    while (!stack.empty()) {
+        const auto id = stack.back();
+        stack.pop_back();
+        const auto &node = octree.node(id);
+        writer.write(node.type);
+        if (node.type == world::Cube::Type::NORMAL) {
+            writer.write(node.indentations);
+        } else if (node.type == world::Cube::Type::OCTANT) {
+            for (std::size_t idx = world::Cube::SUB_CUBES; idx-- > 0;) {
+                stack.push_back(octree.child(id, idx));
+            }
+        }
+    }
     return writer;
 }
 
 template <>
-std::shared_ptr<world::Cube> NXOCParser::deserialize_impl<0>(const ByteStream &stream) {
+world::LinearOctree NXOCParser::deserialize_linear_impl<0>(const ByteStream &stream, const float size,
+                                                           const glm::vec3 &position) {
     ByteStreamReader reader(stream);
-    std::shared_ptr<world::Cube> root = std::make_shared<world::Cube>();
+    world::LinearOctree octree(size, position);
 
     // Skip identifier, which is already checked.
     reader.skip(13);
     // Skip version.
     reader.skip(4);
 
-    std::function<void(std::shared_ptr<world::Cube> &)> iter_func;
-    // pre-order traversal
-    iter_func = [&iter_func, &reader](std::shared_ptr<world::Cube> &cube) {
-        cube->set_type(reader.read<world::Cube::Type>());
-        if (cube->type() == world::Cube::Type::OCTANT) {
-            for (auto child : cube->children()) {
-                iter_func(child);
-            }
-            return;
+    // The nodes with their depth, the children are pushed in reverse order to read them in pre-order.
+    std::vector<std::pair<world::LinearOctree::NodeId, std::size_t>> stack{{world::LinearOctree::ROOT, 0}};
+    while (!stack.empty()) {
+        const auto [id, depth] = stack.back();
+        stack.pop_back();
+        const auto type = reader.read<world::Cube::Type>();
+        // The same limit as for the pointer-based octree, which it may be converted to.
+        if (type == world::Cube::Type::OCTANT && depth >= world::Cube::MAX_DEPTH) {
+            throw IoException("Octree too deep");
         }
-        if (cube->type() == world::Cube::Type::NORMAL) {
-            cube->m_indentations = reader.read<std::array<world::Indentation, world::Cube::EDGES>>();
+        octree.set_type(id, type);
+        if (type == world::Cube::Type::NORMAL) {
+            const auto indentations = reader.read<std::array<world::Indentation, world::Cube::EDGES>>();
+            for (std::uint8_t edge = 0; edge < world::Cube::EDGES; edge++) {
+                octree.set_indent(id, edge, indentations[edge]);
+            }
+        } else if (type == world::Cube::Type::OCTANT) {
+            for (std::size_t idx = world::Cube::SUB_CUBES; idx-- > 0;) {
+                stack.emplace_back(octree.child(id, idx), depth + 1);
+            }
         }
-    };
-    iter_func(root);
-    return root;
+    }
+    return octree;
 }
 
 ByteStream NXOCParser::serialize(const std::shared_ptr<const world::Cube> cube, const std::uint32_t version) {
@@ -75,14 +125,44 @@ ByteStream NXOCParser::serialize(const std::shared_ptr<const world::Cube> cube,
 }
 
 std::shared_ptr<world::Cube> NXOCParser::deserialize(const ByteStream &stream) {
+    const world::Cube cube;
+    return deserialize(stream, cube.size(), cube.position());
+}
+
+std::shared_ptr<world::Cube> NXOCParser::deserialize(const ByteStream &stream, const float size,
+                                                     const glm::vec3 &position) {
+    ByteStreamReader reader(stream);
+    if (reader.read<std::string>(std::size_t{13}) != "Inexor Octree") {
+        throw IoException("Wrong identifier");
+    }
+    const auto version = reader.read<std::uint32_t>();
+    switch (version) { // NOLINT
+    case 0:
+        return deserialize_impl<0>(stream, size, position);
+    default:
+        throw IoException("Unsupported octree version");
+    }
+}
+
+ByteStream NXOCParser::serialize(const world::LinearOctree &octree, const std::uint32_t version) {
+    switch (version) { // NOLINT
+    case 0:
+        return serialize_linear_impl<0>(octree);
+    default:
+        throw IoException("Unsupported octree version");
+    }
+}
+
+world::LinearOctree NXOCParser::deserialize_linear(const ByteStream &stream, const float size,
+                                                   const glm::vec3 &position) {
     ByteStreamReader reader(stream);
-    if (reader.read<std::string>(13ull) != "Inexor Octree") {
+    if (reader.read<std::string>(std::size_t{13}) != "Inexor Octree") {
         throw IoException("Wrong identifier");
     }
     const auto version = reader.read<std::uint32_t>();
     switch (version) { // NOLINT
     case 0:
-        return deserialize_impl<0>(stream);
+        return deserialize_linear_impl<0>(stream, size, position);
     default:
         throw IoException("Unsupported octree version");
     }
@@ -31,7 +31,9 @@ void VulkanRenderer::setup_render_graph() {
     main_stage->set_depth_options(true, true);
     main_stage->set_on_record([&](const PhysicalStage &physical, const wrapper::CommandBuffer &cmd_buf) {
         cmd_buf.bind_descriptor_sets(m_descriptors[0].descriptor_sets(), physical.pipeline_layout());
-        cmd_buf.draw_indexed(static_cast<std::uint32_t>(m_octree_indices.size()));
+        for (const auto &range : m_octree_draw_ranges) {
+            cmd_buf.draw_indexed(range.index_count, 1, range.first_index);
+        }
     });
 
     for (const auto &shader : m_shaders) {
@@ -41,23 +43,24 @@ void VulkanRenderer::setup_render_graph() {
     main_stage->add_descriptor_layout(m_descriptors[0].descriptor_set_layout());
 }
 
-void VulkanRenderer::generate_octree_indices() {
-    auto old_vertices = std::move(m_octree_vertices);
-    m_octree_indices.clear();
-    m_octree_vertices.clear();
+void VulkanRenderer::generate_octree_indices(std::vector<OctreeGpuVertex> &vertices,
+                                             std::vector<std::uint32_t> &indices) {
+    auto old_vertices = std::move(vertices);
+    indices.clear();
+    vertices.clear();
     std::unordered_map<OctreeGpuVertex, std::uint32_t> vertex_map;
     for (auto &vertex : old_vertices) {
         // TODO: Use std::unordered_map::contains() when we switch to C++ 20.
         if (vertex_map.count(vertex) == 0) {
             assert(vertex_map.size() < std::numeric_limits<std::uint32_t>::max() && "Octree too big!");
             vertex_map.emplace(vertex, static_cast<std::uint32_t>(vertex_map.size()));
-            m_octree_vertices.push_back(vertex);
+            vertices.push_back(vertex);
         }
-        m_octree_indices.push_back(vertex_map.at(vertex));
+        indices.push_back(vertex_map.at(vertex));
     }
-    spdlog::trace("Reduced octree by {} vertices (from {} to {})", old_vertices.size() - m_octree_vertices.size(),
-                  old_vertices.size(), m_octree_vertices.size());
-    spdlog::trace("Total indices {} ", m_octree_indices.size());
+    spdlog::trace("Reduced octree by {} vertices (from {} to {})", old_vertices.size() - vertices.size(),
+                  old_vertices.size(), vertices.size());
+    spdlog::trace("Total indices {} ", indices.size());
 }
 
 void VulkanRenderer::recreate_swapchain() {
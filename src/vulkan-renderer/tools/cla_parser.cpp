@@ -27,6 +27,11 @@ template <>
     return static_cast<std::uint32_t>(as<int>());
 }
 
+template <>
+[[nodiscard]] std::string CommandLineArgumentValue::as() const {
+    return m_value;
+}
+
 std::optional<CommandLineArgumentTemplate>
 CommandLineArgumentParser::make_arg_template(const std::string &argument_name) const {
     auto it = std::find_if(m_accepted_args.begin(), m_accepted_args.end(),
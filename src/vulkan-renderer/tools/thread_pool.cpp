@@ -0,0 +1,108 @@
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
+
+#include <algorithm>
+
+namespace inexor::vulkan_renderer::tools {
+
+namespace {
+
+/// The pool the current thread is working for, nullptr if it is not a worker.
+thread_local const ThreadPool *current_pool{nullptr};
+/// The queue of the current worker thread.
+thread_local std::size_t current_queue{0};
+
+} // namespace
+
+ThreadPool::ThreadPool(std::size_t thread_count) {
+    thread_count = std::max<std::size_t>(thread_count, 1);
+    m_queues.reserve(thread_count);
+    for (std::size_t i = 0; i < thread_count; i++) {
+        m_queues.push_back(std::make_unique<TaskQueue>());
+    }
+    m_workers.reserve(thread_count);
+    for (std::size_t i = 0; i < thread_count; i++) {
+        m_workers.emplace_back(&ThreadPool::worker_loop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::scoped_lock lock(m_wake_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto &worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::push(std::function<void()> task) {
+    const std::size_t queue_index =
+        current_pool == this ? current_queue : m_next_queue.fetch_add(1) % m_queues.size();
+    {
+        // Increment before the task can be popped, so the decrement never comes first and wraps the counter around.
+        // Increment under the lock, so a worker can't miss the notification between checking and waiting.
+        std::scoped_lock lock(m_wake_mutex);
+        m_pending_tasks++;
+    }
+    {
+        std::scoped_lock lock(m_queues[queue_index]->mutex);
+        m_queues[queue_index]->tasks.push_back(std::move(task));
+    }
+    m_wake.notify_one();
+}
+
+bool ThreadPool::try_pop(const std::size_t queue_index, std::function<void()> &task) {
+    {
+        TaskQueue &own = *m_queues[queue_index];
+        std::scoped_lock lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            m_pending_tasks--;
+            return true;
+        }
+    }
+    for (std::size_t offset = 1; offset < m_queues.size(); offset++) {
+        TaskQueue &victim = *m_queues[(queue_index + offset) % m_queues.size()];
+        std::scoped_lock lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            m_pending_tasks--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::worker_loop(const std::size_t queue_index) {
+    current_pool = this;
+    current_queue = queue_index;
+
+    std::function<void()> task;
+    while (true) {
+        if (try_pop(queue_index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock lock(m_wake_mutex);
+        m_wake.wait(lock, [&] { return m_stop || m_pending_tasks > 0; });
+        if (m_stop && m_pending_tasks == 0) {
+            return;
+        }
+    }
+}
+
+bool ThreadPool::run_pending_task() {
+    std::function<void()> task;
+    const std::size_t queue_index = current_pool == this ? current_queue : 0;
+    if (!try_pop(queue_index, task)) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+} // namespace inexor::vulkan_renderer::tools
@@ -0,0 +1,183 @@
+#include "inexor/vulkan-renderer/world/chunk_manager.hpp"
+
+#include "inexor/vulkan-renderer/io/nxoc_parser.hpp"
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
+#include "inexor/vulkan-renderer/world/cube.hpp"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <utility>
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// Take over the chunk if it finished loading.
+/// @return ``True`` if a cube was loaded.
+bool take_finished(ChunkManager::GridPosition grid_position, std::future<std::shared_ptr<Cube>> &pending,
+                   std::shared_ptr<Cube> &cube) {
+    if (!pending.valid() || pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return false;
+    }
+    try {
+        cube = pending.get();
+    } catch (const std::exception &exception) {
+        // The position is remembered as empty, so a broken chunk is not loaded again every frame.
+        spdlog::error("Failed to load chunk ({}, {}, {}): {}", grid_position[0], grid_position[1], grid_position[2],
+                      exception.what());
+    }
+    return cube != nullptr;
+}
+
+} // namespace
+
+ChunkManager::ChunkManager(tools::ThreadPool &thread_pool, ChunkLoader loader, const float chunk_size,
+                           const std::size_t resident_budget)
+    : m_thread_pool(thread_pool), m_loader(std::move(loader)), m_chunk_size(chunk_size),
+      m_resident_budget(std::max<std::size_t>(resident_budget, 1)) {
+    assert(m_loader);
+    assert(m_chunk_size > 0.0f);
+}
+
+ChunkManager::ChunkLoader ChunkManager::file_loader(std::filesystem::path directory) {
+    return [directory = std::move(directory)](const GridPosition &grid_position) -> std::optional<io::ByteStream> {
+        const auto path = directory / (std::to_string(grid_position[0]) + "_" + std::to_string(grid_position[1]) +
+                                       "_" + std::to_string(grid_position[2]) + ".nxoc");
+        if (!std::filesystem::exists(path)) {
+            return std::nullopt;
+        }
+        return io::ByteStream(path);
+    };
+}
+
+std::future<std::shared_ptr<Cube>> ChunkManager::load(const GridPosition &grid_position) {
+    // The task copies everything it needs, so it can outlive the chunk manager.
+    return m_thread_pool.submit([loader = m_loader, size = m_chunk_size, grid_position]() -> std::shared_ptr<Cube> {
+        const auto stream = loader(grid_position);
+        if (!stream) {
+            return nullptr;
+        }
+        const glm::vec3 position(static_cast<float>(grid_position[0]), static_cast<float>(grid_position[1]),
+                                 static_cast<float>(grid_position[2]));
+        io::NXOCParser parser;
+        auto cube = parser.deserialize(*stream, size, position * size);
+        static_cast<void>(cube->update_polygon_caches());
+        return cube;
+    });
+}
+
+ChunkManager::GridPosition ChunkManager::grid_position(const glm::vec3 &position) const {
+    return {static_cast<std::int32_t>(std::floor(position.x / m_chunk_size)),
+            static_cast<std::int32_t>(std::floor(position.y / m_chunk_size)),
+            static_cast<std::int32_t>(std::floor(position.z / m_chunk_size))};
+}
+
+bool ChunkManager::update(const glm::vec3 &camera_position, const float view_distance) {
+    bool changed = false;
+    for (auto &[grid_position, chunk] : m_chunks) {
+        changed |= take_finished(grid_position, chunk.pending, chunk.cube);
+    }
+
+    const auto distance = [&](const GridPosition &grid_position) {
+        const glm::vec3 min = glm::vec3(static_cast<float>(grid_position[0]), static_cast<float>(grid_position[1]),
+                                        static_cast<float>(grid_position[2])) *
+                              m_chunk_size;
+        return glm::distance(camera_position, glm::clamp(camera_position, min, min + m_chunk_size));
+    };
+    for (auto &[grid_position, chunk] : m_chunks) {
+        chunk.distance = distance(grid_position);
+    }
+
+    // The chunks within the view distance, closest first, as only the closest ones may fit into the budget.
+    std::vector<std::pair<float, GridPosition>> requested;
+    const auto first = grid_position(camera_position - view_distance);
+    const auto last = grid_position(camera_position + view_distance);
+    for (std::int32_t x = first[0]; x <= last[0]; x++) {
+        for (std::int32_t y = first[1]; y <= last[1]; y++) {
+            for (std::int32_t z = first[2]; z <= last[2]; z++) {
+                const GridPosition grid_position{x, y, z};
+                if (const float chunk_distance = distance(grid_position); chunk_distance <= view_distance) {
+                    requested.emplace_back(chunk_distance, grid_position);
+                }
+            }
+        }
+    }
+    std::sort(requested.begin(), requested.end());
+
+    // Positions without a chunk do not count against the budget. They are remembered while they are within the view
+    // distance, so they are not loaded again.
+    std::size_t occupied = 0;
+    std::map<GridPosition, Chunk> kept;
+    for (const auto &[chunk_distance, grid_position] : requested) {
+        if (const auto chunk = m_chunks.find(grid_position); chunk != m_chunks.end()) {
+            if (chunk->second.cube != nullptr || chunk->second.pending.valid()) {
+                occupied++;
+            }
+            kept.insert(m_chunks.extract(chunk));
+        } else if (occupied < m_resident_budget) {
+            kept.emplace(grid_position, Chunk{.pending = load(grid_position), .distance = chunk_distance});
+            occupied++;
+        }
+    }
+
+    // Outside the view the loaded chunks and the loads in flight are kept, as long as they fit into the budget next to
+    // the requested ones. They are at least as far away as the requested ones, so they are evicted first. The tasks
+    // of the pool can't be cancelled, so a load which is kept does not have to run again if the camera turns back.
+    // Loads in flight reserve their slot, so the loaded chunks do not exceed the budget once they finish.
+    std::erase_if(m_chunks, [](const auto &chunk) {
+        return chunk.second.cube == nullptr && !chunk.second.pending.valid();
+    });
+    m_chunks.merge(kept);
+    std::vector<std::pair<float, GridPosition>> by_distance;
+    for (const auto &[grid_position, chunk] : m_chunks) {
+        if (chunk.cube != nullptr || chunk.pending.valid()) {
+            by_distance.emplace_back(chunk.distance, grid_position);
+        }
+    }
+    if (by_distance.size() > m_resident_budget) {
+        const auto evicted = by_distance.begin() + static_cast<std::ptrdiff_t>(by_distance.size() - m_resident_budget);
+        std::nth_element(by_distance.begin(), evicted, by_distance.end(), std::greater<>());
+        for (auto it = by_distance.begin(); it != evicted; ++it) {
+            const auto chunk = m_chunks.find(it->second);
+            changed |= chunk->second.cube != nullptr;
+            m_chunks.erase(chunk);
+        }
+    }
+    return changed;
+}
+
+bool ChunkManager::wait() {
+    bool changed = false;
+    for (auto &[grid_position, chunk] : m_chunks) {
+        if (!chunk.pending.valid()) {
+            continue;
+        }
+        m_thread_pool.wait(chunk.pending);
+        changed |= take_finished(grid_position, chunk.pending, chunk.cube);
+    }
+    return changed;
+}
+
+std::vector<std::shared_ptr<Cube>> ChunkManager::resident_chunks() const {
+    std::vector<std::shared_ptr<Cube>> chunks;
+    for (const auto &[grid_position, chunk] : m_chunks) {
+        if (chunk.cube != nullptr) {
+            chunks.push_back(chunk.cube);
+        }
+    }
+    return chunks;
+}
+
+std::size_t ChunkManager::pending_chunks() const {
+    return static_cast<std::size_t>(
+        std::count_if(m_chunks.begin(), m_chunks.end(), [](const auto &chunk) { return chunk.second.pending.valid(); }));
+}
+
+} // namespace inexor::vulkan_renderer::world
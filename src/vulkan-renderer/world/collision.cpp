@@ -1,6 +1,7 @@
 #include <inexor/vulkan-renderer/world/collision.hpp>
 
 #include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/linear_octree.hpp>
 
 #include <glm/geometric.hpp>
 #include <glm/gtx/vector_angle.hpp>
@@ -18,10 +19,23 @@ RayCubeCollision<T>::RayCubeCollision(RayCubeCollision &&other) noexcept : m_cub
     m_selected_face = other.m_selected_face;
     m_nearest_corner = other.m_nearest_corner;
     m_nearest_edge = other.m_nearest_edge;
+    m_triangle_hit = other.m_triangle_hit;
+}
+
+template <typename T>
+RayCubeCollision<T>::RayCubeCollision(const T &cube, const glm::vec3 ray_pos, const glm::vec3 ray_dir,
+                                      const RayTriangleHit &triangle_hit)
+    : m_cube(cube), m_triangle_hit(triangle_hit) {
+    calculate(ray_pos, ray_dir);
 }
 
 template <typename T>
 RayCubeCollision<T>::RayCubeCollision(const T &cube, const glm::vec3 ray_pos, const glm::vec3 ray_dir) : m_cube(cube) {
+    calculate(ray_pos, ray_dir);
+}
+
+template <typename T>
+void RayCubeCollision<T>::calculate(const glm::vec3 ray_pos, const glm::vec3 ray_dir) {
 
     // This lambda adjusts the center points on a cube's face to the size of the octree,
     // so collision works with cubes of any size. This does not yet account for rotations!
@@ -127,8 +141,16 @@ RayCubeCollision<T>::RayCubeCollision(const T &cube, const glm::vec3 ray_pos, co
     // The index of the array which contains the coordinates of the face centers of the cube's bounding box.
     std::size_t selected_face_index{0};
 
+    if (m_triangle_hit) {
+        // The polygon cache holds two triangles per face in the order -x, +x, -y, +y, -z, +z.
+        static constexpr std::array<std::size_t, 6> POLYGON_CACHE_FACES{0, 1, 2, 3, 5, 4};
+        selected_face_index = POLYGON_CACHE_FACES[m_triangle_hit->triangle / 2];
+        m_intersection = ray_pos + m_triangle_hit->distance * ray_dir;
+        m_selected_face = bbox_face_centers[selected_face_index];
+    }
+
     // Loop though all faces of the cube and check for collision between ray and face plane.
-    for (std::size_t i = 0; i < 6; i++) {
+    for (std::size_t i = 0; i < 6 && !m_triangle_hit; i++) {
 
         // Check if the cube side is facing the camera: if the dot product of the two vectors is smaller than
         // zero, the corresponding angle is smaller than 90 degrees, so the side is facing the camera. Check the
@@ -179,5 +201,13 @@ RayCubeCollision<T>::RayCubeCollision(const T &cube, const glm::vec3 ray_pos, co
 
 // Explicit instantiation
 template RayCubeCollision<Cube>::RayCubeCollision(const Cube &, const glm::vec3, const glm::vec3);
+template RayCubeCollision<Cube>::RayCubeCollision(const Cube &, const glm::vec3, const glm::vec3,
+                                                  const RayTriangleHit &);
+template RayCubeCollision<Cube>::RayCubeCollision(RayCubeCollision &&) noexcept;
+template RayCubeCollision<LinearOctree::NodeView>::RayCubeCollision(const LinearOctree::NodeView &, const glm::vec3,
+                                                                    const glm::vec3);
+template RayCubeCollision<LinearOctree::NodeView>::RayCubeCollision(const LinearOctree::NodeView &, const glm::vec3,
+                                                                    const glm::vec3, const RayTriangleHit &);
+template RayCubeCollision<LinearOctree::NodeView>::RayCubeCollision(RayCubeCollision &&) noexcept;
 
 } // namespace inexor::vulkan_renderer::world
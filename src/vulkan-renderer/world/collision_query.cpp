@@ -2,130 +2,320 @@
 
 #include "inexor/vulkan-renderer/world/cube.hpp"
 
-#include <glm/gtx/intersect.hpp>
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <limits>
 
 namespace inexor::vulkan_renderer::world {
 
-bool ray_box_collision(const std::array<glm::vec3, 2> &box_bounds, const glm::vec3 &position,
-                       const glm::vec3 &direction) {
-    glm::vec3 inverse_dir{1 / direction.x, 1 / direction.y, 1 / direction.z};
-    std::array<std::int32_t, 3> sign{static_cast<std::int32_t>(inverse_dir.x < 0),
-                                     static_cast<std::int32_t>(inverse_dir.y < 0),
-                                     static_cast<std::int32_t>(inverse_dir.z < 0)};
+namespace {
 
-    float tmin{(box_bounds[sign[0]].x - position.x) * inverse_dir.x};
-    float tmax{(box_bounds[1 - sign[0]].x - position.x) * inverse_dir.x};
-    float tymin{(box_bounds[sign[1]].y - position.y) * inverse_dir.y};
-    float tymax{(box_bounds[1 - sign[1]].y - position.y) * inverse_dir.y};
+constexpr float INFINITE_PARAMETER{std::numeric_limits<float>::infinity()};
 
-    if ((tmin > tymax) || (tymin > tmax)) {
-        return false;
-    }
-    if (tymin > tmin) {
-        tmin = tymin;
-    }
-    if (tymax < tmax) {
-        tmax = tymax;
+/// @brief The parameters at which a ray enters and exits the slabs of a box along every axis, in the order along the
+/// ray. The slabs which the ray runs parallel to are entered at -infinity and exited at +infinity, so there is no
+/// division by zero.
+/// @return std::nullopt if the ray runs parallel to a slab outside of it.
+std::optional<std::array<glm::vec3, 2>> slab_parameters(const std::array<glm::vec3, 2> &box_bounds,
+                                                         const glm::vec3 &position, const glm::vec3 &direction) {
+    std::array<glm::vec3, 2> parameters;
+    for (glm::vec3::length_type axis = 0; axis < 3; axis++) {
+        if (direction[axis] == 0.0f) {
+            if (position[axis] < box_bounds[0][axis] || position[axis] > box_bounds[1][axis]) {
+                return std::nullopt;
+            }
+            parameters[0][axis] = -INFINITE_PARAMETER;
+            parameters[1][axis] = INFINITE_PARAMETER;
+            continue;
+        }
+        const float near = direction[axis] > 0.0f ? box_bounds[0][axis] : box_bounds[1][axis];
+        const float far = direction[axis] > 0.0f ? box_bounds[1][axis] : box_bounds[0][axis];
+        parameters[0][axis] = (near - position[axis]) / direction[axis];
+        parameters[1][axis] = (far - position[axis]) / direction[axis];
     }
+    return parameters;
+}
 
-    float tzmin{(box_bounds[sign[2]].z - position.z) * inverse_dir.z};
-    float tzmax{(box_bounds[1 - sign[2]].z - position.z) * inverse_dir.z};
+float max_component(const glm::vec3 &vector) {
+    return std::max({vector.x, vector.y, vector.z});
+}
 
-    return (tmin <= tzmax) && (tzmin <= tmax);
+float min_component(const glm::vec3 &vector) {
+    return std::min({vector.x, vector.y, vector.z});
 }
 
-std::optional<RayCubeCollision<Cube>> ray_cube_collision_check(const Cube &cube, const glm::vec3 pos,
-                                                               const glm::vec3 dir,
-                                                               const std::optional<std::uint32_t> max_depth) {
-    // If the cube is empty, a collision with a ray is not possible,
-    // and there are no sub cubes to check for collision either.
-    if (cube.type() == Cube::Type::EMPTY) {
-        // No collision found.
-        return std::nullopt;
-    }
+/// @brief A ray which is traversed through an octree with the parametric algorithm of Revelles et al.
+/// Revelles, J., Urena, C., & Lastra, M. (2000). An Efficient Parametric Algorithm for Octree Traversal.
+/// The parameters of the slabs are computed as if the octree was mirrored along every axis in which the direction is
+/// negative, so the ray always goes towards the children with the larger coordinates. The child indices are mirrored
+/// back when the children are read.
+struct ParametricRay {
+    glm::vec3 position;
+    glm::vec3 direction;
+    /// The bits of the child index of the axes along which the octree is mirrored.
+    std::uint8_t mirror{0};
+};
+
+/// The bit of the child index of an axis, x, y and z from the most significant one.
+std::uint8_t axis_bit(const glm::vec3::length_type axis) {
+    return static_cast<std::uint8_t>(4u >> axis);
+}
 
-    // We need to pass this into glm::intersectRaySphere by reference,
-    // although we are not interested into it.
-    auto intersection_distance{0.0f};
+/// The nodes of a Cube octree for first_hit().
+struct CubeNodes {
+    using Node = const Cube *;
 
-    const auto bounding_sphere_radius = static_cast<float>(glm::sqrt(3) * cube.size()) / 2.0f;
+    [[nodiscard]] static Cube::Type type(const Node node) {
+        return node->type();
+    }
+    [[nodiscard]] static CubePolygons triangles(const Node node) {
+        return node->triangles();
+    }
+    [[nodiscard]] static glm::vec3 center(const Node node) {
+        return node->center();
+    }
+    [[nodiscard]] static Node child(const Node node, const std::uint8_t idx) {
+        return node->children()[idx].get();
+    }
+};
 
-    const auto sphere_radius_squared = static_cast<float>(std::pow(bounding_sphere_radius, 2));
+/// The nodes of a LinearOctree for first_hit().
+struct LinearOctreeNodes {
+    using Node = LinearOctree::NodeId;
 
-    // First, check if ray collides with bounding sphere.
-    // This is much easier to calculate than a collision with a bounding box.
-    if (!glm::intersectRaySphere(pos, dir, cube.center(), sphere_radius_squared, intersection_distance)) {
-        // No collision found.
-        return std::nullopt;
+    const LinearOctree &octree;
+
+    [[nodiscard]] Cube::Type type(const Node node) const {
+        return octree.type(node);
+    }
+    [[nodiscard]] CubePolygons triangles(const Node node) const {
+        return octree.triangles(node);
+    }
+    [[nodiscard]] glm::vec3 center(const Node node) const {
+        return octree.center(node);
     }
+    [[nodiscard]] Node child(const Node node, const std::uint8_t idx) const {
+        return octree.child(node, idx);
+    }
+};
 
-    // Second, check if ray collides with bounding box.
-    // This again is also much faster than to check for collision with every one of the 8 sub cubes.
-    // TODO: This is an axis aligned bounding box! Alignment must account for rotation in the future!
-    if (!ray_box_collision(cube.bounding_box(), pos, dir)) {
-        // No collision found.
+/// @brief Find the first cube along the ray which is hit, from the parameters at which the ray enters and exits the
+/// slabs of the cube.
+/// @tparam Nodes CubeNodes or LinearOctreeNodes, which read the nodes of the octree.
+/// @param triangle_hit The triangle which is hit, if the hit cube is a Type::NORMAL cube.
+/// @return std::nullopt if no cube is hit.
+template <typename Nodes>
+std::optional<typename Nodes::Node> first_hit(const Nodes &nodes, const typename Nodes::Node cube,
+                                              const ParametricRay &ray, const glm::vec3 &t0, const glm::vec3 &t1,
+                                              const std::optional<std::uint32_t> max_depth,
+                                              std::optional<RayTriangleHit> &triangle_hit) {
+    const Cube::Type type = nodes.type(cube);
+    // The cube lies behind the ray.
+    if (min_component(t1) < 0.0f || type == Cube::Type::EMPTY) {
         return std::nullopt;
     }
+    if (type == Cube::Type::SOLID) {
+        return cube;
+    }
+    if (type == Cube::Type::NORMAL) {
+        triangle_hit = ray_triangles_collision(nodes.triangles(cube), ray.position, ray.direction);
+        return triangle_hit ? std::make_optional(cube) : std::nullopt;
+    }
+    // If the maximum depth is reached, the octant is treated as if it was solid.
+    if (max_depth == 0u) {
+        return cube;
+    }
+    const std::optional<std::uint32_t> next_depth =
+        max_depth ? std::make_optional<std::uint32_t>(*max_depth - 1) : std::nullopt;
 
-    if (cube.type() == Cube::Type::OCTANT) {
-        std::size_t hit_candidate_count{0};
-        std::size_t collision_subcube_index{0};
-        float m_nearest_square_distance = std::numeric_limits<float>::max();
-        auto subcubes = cube.children();
-
-        if (max_depth.has_value()) {
-            // Check if the maximum depth is reached.
-            if (max_depth.value() == 0) {
-                // If the maximum depth is reached but the cube is empty, no collision was found.
-                if (cube.type() == Cube::Type::EMPTY) {
-                    return std::nullopt;
-                }
+    // The parameters of the planes between the children.
+    glm::vec3 tm;
+    const glm::vec3 center = nodes.center(cube);
+    for (glm::vec3::length_type axis = 0; axis < 3; axis++) {
+        if (ray.direction[axis] != 0.0f) {
+            tm[axis] = 0.5f * (t0[axis] + t1[axis]);
+        } else {
+            // A ray which runs parallel to the plane never crosses it.
+            tm[axis] = ray.position[axis] < center[axis] ? INFINITE_PARAMETER : -INFINITE_PARAMETER;
+        }
+    }
 
-                // The current cube is of type OCTANT but not of type SOLID, but since we reached the maximum depth of
-                // iteration, we treat it as type SOLID.
-                return std::make_optional<RayCubeCollision<Cube>>(cube, pos, dir);
-            }
+    // The ray enters the octant through the plane which it reaches last. It enters the children behind the planes
+    // between the children which it crosses before.
+    glm::vec3::length_type entry_axis = 0;
+    for (glm::vec3::length_type axis = 1; axis < 3; axis++) {
+        if (t0[axis] > t0[entry_axis]) {
+            entry_axis = axis;
+        }
+    }
+    std::uint8_t node = 0;
+    for (glm::vec3::length_type axis = 0; axis < 3; axis++) {
+        if (axis != entry_axis && tm[axis] < t0[entry_axis]) {
+            node |= axis_bit(axis);
         }
+    }
 
-        // Iterate through all sub cubes and check for collision.
-        for (std::int32_t i = 0; i < 8; i++) {
-            if (subcubes[i]->type() != Cube::Type::EMPTY) {
-                const std::optional<std::uint32_t> next_depth =
-                    max_depth.has_value() ? std::make_optional<std::uint32_t>(max_depth.value() - 1) : std::nullopt;
-
-                // No value for maximum depth given. Continue iterating until you find a leaf node of type SOLID.
-                if (ray_cube_collision_check(*subcubes[i], pos, dir, next_depth)) {
-                    hit_candidate_count++;
-
-                    // If a ray collides with an octant, it can collide with multiple child cubes as it goes
-                    // through it. We need to find the cube which is nearest to the camera and also in front of
-                    // the camera.
-                    const auto squared_distance = glm::distance2(subcubes[i]->center(), pos);
-
-                    if (squared_distance < m_nearest_square_distance) {
-                        collision_subcube_index = i;
-                        m_nearest_square_distance = squared_distance;
-                    }
-                }
+    while (true) {
+        glm::vec3 child_t0;
+        glm::vec3 child_t1;
+        for (glm::vec3::length_type axis = 0; axis < 3; axis++) {
+            const bool upper = (node & axis_bit(axis)) != 0;
+            child_t0[axis] = upper ? tm[axis] : t0[axis];
+            child_t1[axis] = upper ? t1[axis] : tm[axis];
+        }
+        const auto child = nodes.child(cube, static_cast<std::uint8_t>(node ^ ray.mirror));
+        if (const auto hit = first_hit(nodes, child, ray, child_t0, child_t1, next_depth, triangle_hit)) {
+            return hit;
+        }
+        // The ray leaves the child through the plane which it reaches first, which leads to the neighbor behind it
+        // or out of the octant.
+        glm::vec3::length_type exit_axis = 0;
+        for (glm::vec3::length_type axis = 1; axis < 3; axis++) {
+            if (child_t1[axis] < child_t1[exit_axis]) {
+                exit_axis = axis;
             }
+        }
+        if ((node & axis_bit(exit_axis)) != 0) {
+            return std::nullopt;
+        }
+        node |= axis_bit(exit_axis);
+    }
+}
 
-            // If a ray goes through a cube of 8 subcubes, no more than 4 collisions can take place.
-            if (hit_candidate_count == 4) {
-                break;
-            }
+/// @brief Find the first cube of an octree which a ray hits, see ray_cube_collision_check().
+/// @param box_bounds The bounding box of the root.
+template <typename Nodes>
+std::optional<typename Nodes::Node>
+first_octree_hit(const Nodes &nodes, const typename Nodes::Node root, const std::array<glm::vec3, 2> &box_bounds,
+                 const glm::vec3 &pos, const glm::vec3 &dir, const std::optional<std::uint32_t> max_depth,
+                 std::optional<RayTriangleHit> &triangle_hit) {
+    if (nodes.type(root) == Cube::Type::EMPTY || dir == glm::vec3(0.0f)) {
+        return std::nullopt;
+    }
+    const auto parameters = slab_parameters(box_bounds, pos, dir);
+    if (!parameters || max_component((*parameters)[0]) > min_component((*parameters)[1])) {
+        return std::nullopt;
+    }
+    ParametricRay ray{pos, dir};
+    for (glm::vec3::length_type axis = 0; axis < 3; axis++) {
+        if (dir[axis] < 0.0f) {
+            ray.mirror |= axis_bit(axis);
         }
+    }
+    return first_hit(nodes, root, ray, (*parameters)[0], (*parameters)[1], max_depth, triangle_hit);
+}
+
+} // namespace
+
+bool ray_box_collision(const std::array<glm::vec3, 2> &box_bounds, const glm::vec3 &position,
+                       const glm::vec3 &direction) {
+    const auto parameters = slab_parameters(box_bounds, position, direction);
+    return parameters && max_component((*parameters)[0]) <= min_component((*parameters)[1]);
+}
+
+std::optional<float> ray_box_entry_distance(const std::array<glm::vec3, 2> &box_bounds, const glm::vec3 &position,
+                                            const glm::vec3 &direction) {
+    const auto parameters = slab_parameters(box_bounds, position, direction);
+    if (!parameters) {
+        return std::nullopt;
+    }
+    const float entry = std::max(max_component((*parameters)[0]), 0.0f);
+    if (entry > min_component((*parameters)[1])) {
+        return std::nullopt;
+    }
+    return entry;
+}
 
-        if (hit_candidate_count > 0) {
-            return std::make_optional<RayCubeCollision<Cube>>(*subcubes[collision_subcube_index], pos, dir);
+std::optional<RayTriangleHit> ray_triangles_collision(const CubePolygons &triangles, const glm::vec3 &position,
+                                                      const glm::vec3 &direction) {
+    constexpr std::size_t TRIANGLES{std::tuple_size_v<CubePolygons>};
+    using Lanes = std::array<float, TRIANGLES>;
+    // The start position relative to the first vertex and the two edges from the first vertex, one lane per triangle.
+    std::array<Lanes, 3> origins;
+    std::array<Lanes, 3> first_edges;
+    std::array<Lanes, 3> second_edges;
+    for (std::size_t idx = 0; idx < TRIANGLES; idx++) {
+        for (glm::vec3::length_type axis = 0; axis < 3; axis++) {
+            origins[axis][idx] = position[axis] - triangles[idx][0][axis];
+            first_edges[axis][idx] = triangles[idx][1][axis] - triangles[idx][0][axis];
+            second_edges[axis][idx] = triangles[idx][2][axis] - triangles[idx][0][axis];
         }
-    } else if (cube.type() == Cube::Type::SOLID) {
-        // We found a leaf collision. Now we need to determine the selected face,
-        // nearest corner to intersection point and nearest edge to intersection point.
-        return std::make_optional<RayCubeCollision<Cube>>(cube, pos, dir);
     }
+    const auto &[ox, oy, oz] = origins;
+    const auto &[ax, ay, az] = first_edges;
+    const auto &[bx, by, bz] = second_edges;
+    Lanes distances;
+    Lanes us;
+    Lanes vs;
+    for (std::size_t idx = 0; idx < TRIANGLES; idx++) {
+        // p = direction x second edge
+        const float px = direction.y * bz[idx] - direction.z * by[idx];
+        const float py = direction.z * bx[idx] - direction.x * bz[idx];
+        const float pz = direction.x * by[idx] - direction.y * bx[idx];
+        const float inverse_determinant = 1.0f / (ax[idx] * px + ay[idx] * py + az[idx] * pz);
+        // q = origin x first edge
+        const float qx = oy[idx] * az[idx] - oz[idx] * ay[idx];
+        const float qy = oz[idx] * ax[idx] - ox[idx] * az[idx];
+        const float qz = ox[idx] * ay[idx] - oy[idx] * ax[idx];
+        const float u = (ox[idx] * px + oy[idx] * py + oz[idx] * pz) * inverse_determinant;
+        const float v = (direction.x * qx + direction.y * qy + direction.z * qz) * inverse_determinant;
+        const float t = (bx[idx] * qx + by[idx] * qy + bz[idx] * qz) * inverse_determinant;
+        // If the ray is parallel to the triangle or the triangle is degenerate, the determinant is zero. The results
+        // are infinite or NaN then, which fail the comparisons.
+        // The comparisons are combined without short circuit, so the loop has no branches.
+        const bool hit = (u >= 0.0f) & (v >= 0.0f) & (u + v <= 1.0f) & (t >= 0.0f);
+        distances[idx] = hit ? t : INFINITE_PARAMETER;
+        us[idx] = u;
+        vs[idx] = v;
+    }
+    const auto nearest = static_cast<std::size_t>(std::distance(
+        distances.begin(), std::min_element(distances.begin(), distances.end())));
+    if (distances[nearest] == INFINITE_PARAMETER) {
+        return std::nullopt;
+    }
+    return RayTriangleHit{nearest, distances[nearest], us[nearest], vs[nearest]};
+}
+
+std::optional<RayTriangleHit> ray_normal_cube_collision(const Cube &cube, const glm::vec3 &position,
+                                                        const glm::vec3 &direction) {
+    assert(cube.type() == Cube::Type::NORMAL);
+    if (!ray_box_collision(cube.bounding_box(), position, direction)) {
+        return std::nullopt;
+    }
+    return ray_triangles_collision(cube.triangles(), position, direction);
+}
 
-    // No collision found.
-    return std::nullopt;
+std::optional<RayCubeCollision<Cube>> ray_cube_collision_check(const Cube &cube, const glm::vec3 pos,
+                                                               const glm::vec3 dir,
+                                                               const std::optional<std::uint32_t> max_depth) {
+    std::optional<RayTriangleHit> triangle_hit;
+    const auto hit = first_octree_hit(CubeNodes{}, &cube, cube.bounding_box(), pos, dir, max_depth, triangle_hit);
+    if (!hit) {
+        return std::nullopt;
+    }
+    // We found a leaf collision. Now we need to determine the selected face,
+    // nearest corner to intersection point and nearest edge to intersection point.
+    if (triangle_hit) {
+        return std::make_optional<RayCubeCollision<Cube>>(**hit, pos, dir, *triangle_hit);
+    }
+    return std::make_optional<RayCubeCollision<Cube>>(**hit, pos, dir);
+}
+
+std::optional<RayCubeCollision<LinearOctree::NodeView>>
+ray_cube_collision_check(const LinearOctree &octree, const glm::vec3 pos, const glm::vec3 dir,
+                         const std::optional<std::uint32_t> max_depth) {
+    std::optional<RayTriangleHit> triangle_hit;
+    const auto hit = first_octree_hit(LinearOctreeNodes{octree}, LinearOctree::ROOT,
+                                      octree.bounding_box(LinearOctree::ROOT), pos, dir, max_depth, triangle_hit);
+    if (!hit) {
+        return std::nullopt;
+    }
+    const LinearOctree::NodeView node(octree, *hit);
+    if (triangle_hit) {
+        return std::make_optional<RayCubeCollision<LinearOctree::NodeView>>(node, pos, dir, *triangle_hit);
+    }
+    return std::make_optional<RayCubeCollision<LinearOctree::NodeView>>(node, pos, dir);
 }
 
 } // namespace inexor::vulkan_renderer::world
@@ -1,28 +1,364 @@
 #include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/exception.hpp"
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
 #include "inexor/vulkan-renderer/world/indentation.hpp"
+#include "inexor/vulkan-renderer/world/normal_cube_batch.hpp"
+#include "inexor/vulkan-renderer/world/octree_snapshot.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
 
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <bit>
 #include <random>
+#include <utility>
 
 void swap(inexor::vulkan_renderer::world::Cube &lhs, inexor::vulkan_renderer::world::Cube &rhs) noexcept {
     std::swap(lhs.m_type, rhs.m_type);
     std::swap(lhs.m_size, rhs.m_size);
     std::swap(lhs.m_position, rhs.m_position);
     std::swap(lhs.m_parent, rhs.m_parent);
+    std::swap(lhs.m_parent_node, rhs.m_parent_node);
     std::swap(lhs.m_index_in_parent, rhs.m_index_in_parent);
+    std::swap(lhs.m_locational_code, rhs.m_locational_code);
     std::swap(lhs.m_indentations, rhs.m_indentations);
     std::swap(lhs.m_children, rhs.m_children);
-    std::swap(lhs.m_polygon_cache, rhs.m_polygon_cache);
+    std::swap(lhs.m_pending_rotation, rhs.m_pending_rotation);
+    std::swap(lhs.m_polygon_offset, rhs.m_polygon_offset);
     std::swap(lhs.m_polygon_cache_valid, rhs.m_polygon_cache_valid);
+    std::swap(lhs.m_polygon_arena, rhs.m_polygon_arena);
+    std::swap(lhs.m_subtree_dirty, rhs.m_subtree_dirty);
+    std::swap(lhs.m_auto_compaction, rhs.m_auto_compaction);
+    std::swap(lhs.m_statistics, rhs.m_statistics);
+    std::swap(lhs.m_lod_proxy, rhs.m_lod_proxy);
+    std::swap(lhs.m_occupancy, rhs.m_occupancy);
+    std::swap(lhs.m_snapshot, rhs.m_snapshot);
+    // The children were swapped with the other members, so they have to point at their new parent.
+    // A cube which is move constructed by std::make_shared is not owned yet, so its children only get m_parent_node.
+    for (auto *cube : {&lhs, &rhs}) {
+        for (const auto &child : cube->m_children) {
+            if (child != nullptr) {
+                child->m_parent = cube->weak_from_this();
+                child->m_parent_node = cube;
+            }
+        }
+    }
 }
 
 namespace inexor::vulkan_renderer::world {
 void Cube::remove_children() {
+    m_pending_rotation.reset();
     for (auto &child : m_children) {
+        if (child == nullptr) {
+            continue;
+        }
         child->remove_children();
+        child->m_parent_node = nullptr;
         child.reset();
     }
 }
 
+void Cube::set_locational_code(const std::uint64_t code) {
+    m_locational_code = code;
+    if (m_type == Type::OCTANT) {
+        for (std::uint8_t idx = 0; idx < SUB_CUBES; idx++) {
+            m_children[idx]->set_locational_code((code << 3u) | idx);
+        }
+    }
+}
+
+std::optional<Cube::Type> Cube::uniform_children_type() const {
+    if (m_type != Type::OCTANT) {
+        return std::nullopt;
+    }
+    const Type type = m_children[0]->m_type;
+    if (type != Type::EMPTY && type != Type::SOLID) {
+        return std::nullopt;
+    }
+    for (const auto &child : m_children) {
+        if (child->m_type != type) {
+            return std::nullopt;
+        }
+    }
+    return type;
+}
+
+void Cube::collapse(const Type type) {
+    assert(m_type == Type::OCTANT);
+    remove_children();
+    m_type = type;
+    invalidate_polygon_cache();
+    update_statistics();
+}
+
+void Cube::collapse_uniform_octants(Cube *octant) {
+    // Collapsing an octant only destroys its children, so it can be followed to its parent afterwards.
+    for (; octant != nullptr; octant = octant->m_parent_node) {
+        const auto type = octant->uniform_children_type();
+        if (!type) {
+            return;
+        }
+        octant->collapse(*type);
+    }
+}
+
+void Cube::mark_subtree_dirty() const {
+    m_snapshot.reset();
+    m_lod_proxy.reset();
+    m_subtree_dirty = true;
+    mark_parents_dirty();
+}
+
+void Cube::mark_parents_dirty() const {
+    for (const Cube *parent = m_parent_node;
+         parent != nullptr && (parent->m_snapshot != nullptr || parent->m_lod_proxy != nullptr);
+         parent = parent->m_parent_node) {
+        parent->m_snapshot.reset();
+        parent->m_lod_proxy.reset();
+    }
+    for (const Cube *parent = m_parent_node; parent != nullptr && !parent->m_subtree_dirty;
+         parent = parent->m_parent_node) {
+        parent->m_subtree_dirty = true;
+    }
+}
+
+void Cube::update_statistics() {
+    const SubtreeStatistics previous = m_statistics;
+    m_statistics = {};
+    switch (m_type) {
+    case Type::EMPTY:
+        m_statistics.empty_cubes = 1;
+        break;
+    case Type::SOLID:
+        m_statistics.solid_cubes = 1;
+        break;
+    case Type::NORMAL:
+        m_statistics.normal_cubes = 1;
+        break;
+    case Type::OCTANT:
+        m_statistics.octants = 1;
+        for (const auto &child : m_children) {
+            const SubtreeStatistics &child_statistics = child->m_statistics;
+            m_statistics.empty_cubes += child_statistics.empty_cubes;
+            m_statistics.solid_cubes += child_statistics.solid_cubes;
+            m_statistics.normal_cubes += child_statistics.normal_cubes;
+            m_statistics.octants += child_statistics.octants;
+            m_statistics.depth = std::max(m_statistics.depth, child_statistics.depth + 1);
+        }
+        break;
+    }
+    propagate_statistics(previous);
+}
+
+void Cube::propagate_statistics(SubtreeStatistics previous) {
+    // The counts of the subtree are part of the ones of every parent, so the difference is applied to all of them.
+    // The unsigned arithmetic wraps around in between, but the results can't be negative.
+    const Cube *child = this;
+    for (Cube *parent = m_parent_node; parent != nullptr; child = parent, parent = parent->m_parent_node) {
+        const SubtreeStatistics parent_previous = parent->m_statistics;
+        SubtreeStatistics &statistics = parent->m_statistics;
+        statistics.empty_cubes = statistics.empty_cubes + child->m_statistics.empty_cubes - previous.empty_cubes;
+        statistics.solid_cubes = statistics.solid_cubes + child->m_statistics.solid_cubes - previous.solid_cubes;
+        statistics.normal_cubes = statistics.normal_cubes + child->m_statistics.normal_cubes - previous.normal_cubes;
+        statistics.octants = statistics.octants + child->m_statistics.octants - previous.octants;
+        if (child->m_statistics.depth + 1 > statistics.depth) {
+            statistics.depth = child->m_statistics.depth + 1;
+        } else if (child->m_statistics.depth < previous.depth && previous.depth + 1 == statistics.depth) {
+            // The deepest subtree became shallower, another child may still be as deep as it was.
+            statistics.depth = 0;
+            for (const auto &sibling : parent->m_children) {
+                statistics.depth = std::max(statistics.depth, sibling->m_statistics.depth + 1);
+            }
+        }
+        previous = parent_previous;
+    }
+}
+
+bool Cube::update_dirty_polygon_caches(std::vector<std::shared_ptr<const Cube>> *changed) const {
+    const auto [arena, offset] = update_polygon_arena();
+    return update_dirty_polygon_caches(changed, *arena, offset);
+}
+
+bool Cube::update_dirty_polygon_caches(std::vector<std::shared_ptr<const Cube>> *changed, PolygonArena &arena,
+                                       const std::size_t offset) const {
+    std::vector<const Cube *> normal_cubes;
+    std::vector<std::size_t> normal_offsets;
+    const bool updated = collect_dirty_polygon_caches(changed, arena, offset, normal_cubes, normal_offsets);
+    if (normal_cubes.empty()) {
+        return updated;
+    }
+    NormalCubeBatch batch;
+    batch.add(normal_cubes);
+    batch.compute();
+    for (std::size_t idx = 0; idx < normal_cubes.size(); idx++) {
+        const CubePolygons polygons = batch.polygons(idx);
+        std::copy(polygons.begin(), polygons.end(), arena.begin() + static_cast<std::ptrdiff_t>(normal_offsets[idx]));
+        normal_cubes[idx]->m_polygon_cache_valid = true;
+    }
+    return updated;
+}
+
+bool Cube::collect_dirty_polygon_caches(std::vector<std::shared_ptr<const Cube>> *changed, PolygonArena &arena,
+                                        const std::size_t offset, std::vector<const Cube *> &normal_cubes,
+                                        std::vector<std::size_t> &normal_offsets) const {
+    if (!m_subtree_dirty) {
+        return false;
+    }
+    m_subtree_dirty = false;
+    bool updated = false;
+    if (!m_polygon_cache_valid) {
+        if (m_type == Type::NORMAL) {
+            normal_cubes.push_back(this);
+            normal_offsets.push_back(offset);
+        } else {
+            update_polygon_cache(arena, offset);
+        }
+        updated = m_type != Type::OCTANT;
+    }
+    if (m_type == Type::OCTANT) {
+        apply_pending_rotation();
+        for (const auto &child : m_children) {
+            if (child->collect_dirty_polygon_caches(changed, arena, offset + child->m_polygon_offset, normal_cubes,
+                                                    normal_offsets) &&
+                changed != nullptr) {
+                changed->push_back(child);
+            }
+        }
+    }
+    return updated;
+}
+
+void Cube::update_polygon_cache(PolygonArena &arena, const std::size_t offset) const {
+    if (m_type == Type::SOLID || m_type == Type::NORMAL) {
+        const CubePolygons polygons = triangulate(m_type, m_position, m_size, m_indentations);
+        std::copy(polygons.begin(), polygons.end(), arena.begin() + static_cast<std::ptrdiff_t>(offset));
+    }
+    m_polygon_cache_valid = true;
+}
+
+std::pair<PolygonArena *, std::size_t> Cube::update_polygon_arena() const {
+    const Cube *root = polygon_arena_offset().first;
+    if (root->m_polygon_arena == nullptr) {
+        // The offsets may refer to the arena of the octree this was removed from, so nothing can be reused.
+        traverse_pre_order(*root, [](const Cube &cube) {
+            cube.m_polygon_cache_valid = false;
+            cube.m_subtree_dirty = true;
+        });
+        root->m_polygon_arena = std::make_unique<PolygonArena>();
+    }
+    const std::size_t triangles = root->m_statistics.triangles();
+    if (root->m_polygon_offset != 0 || root->m_polygon_arena->size() != triangles || root->polygon_layout_changed()) {
+        PolygonArena arena(triangles);
+        root->relayout_polygons(*root->m_polygon_arena, root->m_polygon_offset, arena, 0);
+        root->m_polygon_offset = 0;
+        *root->m_polygon_arena = std::move(arena);
+    }
+    return {root->m_polygon_arena.get(), polygon_arena_offset().second};
+}
+
+bool Cube::polygon_layout_changed() const {
+    if (!m_subtree_dirty || m_type != Type::OCTANT) {
+        return false;
+    }
+    apply_pending_rotation();
+    std::size_t offset = 0;
+    for (const auto &child : m_children) {
+        if (child->m_polygon_offset != offset || child->polygon_layout_changed()) {
+            return true;
+        }
+        offset += child->m_statistics.triangles();
+    }
+    return false;
+}
+
+void Cube::relayout_polygons(const PolygonArena &old_arena, const std::size_t old_offset, PolygonArena &new_arena,
+                             const std::size_t new_offset) const {
+    if (!m_subtree_dirty || (m_type != Type::OCTANT && m_polygon_cache_valid)) {
+        // Nothing changed, so the whole subtree is in the old arena already.
+        const std::size_t triangles = m_statistics.triangles();
+        assert(old_offset + triangles <= old_arena.size());
+        std::copy_n(old_arena.begin() + static_cast<std::ptrdiff_t>(old_offset), triangles,
+                    new_arena.begin() + static_cast<std::ptrdiff_t>(new_offset));
+        return;
+    }
+    if (m_type != Type::OCTANT) {
+        // The slot is written when the polygon cache is updated.
+        return;
+    }
+    apply_pending_rotation();
+    std::size_t offset = new_offset;
+    for (const auto &child : m_children) {
+        child->relayout_polygons(old_arena, old_offset + child->m_polygon_offset, new_arena, offset);
+        child->m_polygon_offset = offset - new_offset;
+        offset += child->m_statistics.triangles();
+    }
+}
+
+std::pair<const Cube *, std::size_t> Cube::polygon_arena_offset() const noexcept {
+    std::size_t offset = m_polygon_offset;
+    const Cube *root = this;
+    for (; root->m_parent_node != nullptr; root = root->m_parent_node) {
+        offset += root->m_parent_node->m_polygon_offset;
+    }
+    return {root, offset};
+}
+
+void Cube::update_lod_proxy() const {
+    assert(m_type == Type::OCTANT);
+    float occupancy = 0.0f;
+    for (const auto &child : m_children) {
+        occupancy += child->occupancy();
+    }
+    m_occupancy = occupancy / static_cast<float>(SUB_CUBES);
+    m_lod_proxy = std::make_shared<const CubePolygons>(triangulate(Type::SOLID, m_position, m_size, m_indentations));
+}
+
+void Cube::append_visible_polygons(const std::span<const Polygon> triangles, std::vector<Polygon> &polygons) const {
+    const std::uint8_t hidden = hidden_faces();
+    for (std::size_t idx = 0; idx < triangles.size(); idx++) {
+        const Polygon &polygon = triangles[idx];
+        const std::size_t face = idx / 2;
+        if (((hidden >> face) & 1u) != 0) {
+            // Indented faces of normal cubes can lie inside of the cube, so only the triangles which lie flat on
+            // the boundary of the cube are covered by the neighbor.
+            const auto axis = static_cast<glm::vec3::length_type>(face / 2);
+            const float plane = face % 2 == 0 ? m_position[axis] : m_position[axis] + m_size;
+            if (polygon[0][axis] == plane && polygon[1][axis] == plane && polygon[2][axis] == plane) {
+                continue;
+            }
+        }
+        polygons.push_back(polygon);
+    }
+}
+
+Cube::DetachedSubtree::DetachedSubtree(Cube &cube)
+    : m_cube(&cube), m_parent(cube.m_parent_node), m_statistics(cube.m_statistics) {
+    cube.m_parent_node = nullptr;
+}
+
+Cube::DetachedSubtree::DetachedSubtree(DetachedSubtree &&other) noexcept
+    : m_cube(std::exchange(other.m_cube, nullptr)), m_parent(other.m_parent), m_statistics(other.m_statistics) {}
+
+Cube::DetachedSubtree::~DetachedSubtree() {
+    if (m_cube == nullptr || m_parent == nullptr) {
+        return;
+    }
+    if (m_cube->m_polygon_arena != nullptr) {
+        // The polygons which were updated meanwhile are in an arena of the subtree, not in the one of the octree.
+        m_cube->m_polygon_arena.reset();
+        traverse_pre_order(*m_cube, [](const Cube &cube) {
+            cube.m_polygon_cache_valid = false;
+            cube.m_subtree_dirty = true;
+        });
+    }
+    m_cube->m_parent_node = m_parent;
+    m_cube->propagate_statistics(m_statistics);
+    if (m_cube->m_subtree_dirty) {
+        m_cube->mark_parents_dirty();
+    }
+}
+
 std::shared_ptr<Cube> Cube::root() {
     std::shared_ptr<Cube> new_parent = m_parent.lock();
     if (!new_parent) {
@@ -38,11 +374,15 @@ std::shared_ptr<Cube> Cube::root() {
 
 std::array<glm::vec3, 8> Cube::vertices() const noexcept {
     assert(m_type == Type::SOLID || m_type == Type::NORMAL);
+    return vertices(m_type, m_position, m_size, m_indentations);
+}
 
-    const glm::vec3 pos = m_position;
-    const glm::vec3 max = {m_position.x + m_size, m_position.y + m_size, m_position.z + m_size};
+std::array<glm::vec3, 8> Cube::vertices(const Type type, const glm::vec3 &position, const float size,
+                                        const std::array<Indentation, Cube::EDGES> &ind) noexcept {
+    const glm::vec3 pos = position;
+    const glm::vec3 max = {position.x + size, position.y + size, position.z + size};
 
-    if (m_type == Type::SOLID) {
+    if (type == Type::SOLID) {
         return {{{pos.x, pos.y, pos.z},
                  {pos.x, pos.y, max.z},
                  {pos.x, max.y, pos.z},
@@ -52,9 +392,8 @@ std::array<glm::vec3, 8> Cube::vertices() const noexcept {
                  {max.x, max.y, pos.z},
                  {max.x, max.y, max.z}}};
     }
-    if (m_type == Type::NORMAL) {
-        const float step = m_size / Indentation::MAX;
-        const std::array<Indentation, Cube::EDGES> &ind = m_indentations;
+    if (type == Type::NORMAL) {
+        const float step = size / Indentation::MAX;
 
         return {{{pos.x + static_cast<float>(ind[0].start()) * step, pos.y + static_cast<float>(ind[1].start()) * step,
                   pos.z + static_cast<float>(ind[2].start()) * step},
@@ -76,97 +415,146 @@ std::array<glm::vec3, 8> Cube::vertices() const noexcept {
     return {};
 }
 
-/// 90 degree rotation.
-template <>
-void Cube::rotate<1>(const RotationAxis::Type &axis) {
-    // the reorder function can be replaced by a lambda and used both cases.
-    // requires: constexpr vector
-    if (m_type == Type::NORMAL) {
-        const RotationAxis::EdgeType &edge_rotation = std::get<1>(axis);
-        for (const auto &order : edge_rotation) {
-            std::swap(m_indentations[order[0]], m_indentations[order[1]]);
-            std::swap(m_indentations[order[1]], m_indentations[order[2]]);
-            std::swap(m_indentations[order[2]], m_indentations[order[3]]);
-        }
-        // Some indentations need to be mirrored, as the direction has changed.
-        // not the last array, as it contains the edges parallel to the axis around which we rotate
-        for (int idx = 0; idx < edge_rotation.size() - 1; idx++) {
-            m_indentations[edge_rotation[idx][0]].mirror();
-            m_indentations[edge_rotation[idx][2]].mirror();
-        }
-        return;
+std::uint8_t Cube::face_splits(const std::array<Indentation, Cube::EDGES> &ind) noexcept {
+    // Check for each side if the side is convex, rotate the hypotenuse (middle diagonal edge) so it becomes convex!
+    std::uint8_t splits = 0;
+    // x = 0
+    splits |= static_cast<std::uint8_t>(ind[0].start() + ind[6].start() < ind[9].start() + ind[3].start()) << 0u;
+    // x = 1
+    splits |= static_cast<std::uint8_t>(ind[0].end() + ind[6].end() < ind[9].end() + ind[3].end()) << 1u;
+    // y = 0
+    splits |= static_cast<std::uint8_t>(ind[1].start() + ind[7].start() < ind[4].start() + ind[10].start()) << 2u;
+    // y = 1
+    splits |= static_cast<std::uint8_t>(ind[1].end() + ind[7].end() < ind[4].end() + ind[10].end()) << 3u;
+    // z = 0
+    splits |= static_cast<std::uint8_t>(ind[2].start() + ind[8].start() < ind[11].start() + ind[5].start()) << 4u;
+    // z = 1
+    splits |= static_cast<std::uint8_t>(ind[2].end() + ind[8].end() < ind[11].end() + ind[5].end()) << 5u;
+    return splits;
+}
+
+CubePolygons Cube::triangulate(const std::array<glm::vec3, 8> &v, const std::uint8_t face_splits) noexcept {
+    CubePolygons polygons{{
+        {{v[0], v[2], v[1]}}, // x = 0
+        {{v[1], v[2], v[3]}}, // x = 0
+        {{v[4], v[5], v[6]}}, // x = 1
+        {{v[5], v[7], v[6]}}, // x = 1
+        {{v[0], v[1], v[4]}}, // y = 0
+        {{v[1], v[5], v[4]}}, // y = 0
+        {{v[2], v[6], v[3]}}, // y = 1
+        {{v[3], v[6], v[7]}}, // y = 1
+        {{v[0], v[4], v[2]}}, // z = 0
+        {{v[2], v[4], v[6]}}, // z = 0
+        {{v[1], v[3], v[5]}}, // z = 1
+        {{v[3], v[7], v[5]}}  // z = 1
+    }};
+    const auto split = [face_splits](const std::size_t face) { return ((face_splits >> face) & 1u) != 0; };
+    // x = 0
+    if (split(0)) {
+        polygons[0] = {{v[0], v[2], v[3]}};
+        polygons[1] = {{v[0], v[3], v[1]}};
     }
-    if (m_type == Type::OCTANT) {
-        const RotationAxis::ChildType &child_rotation = std::get<0>(axis);
-        for (const auto &order : child_rotation) {
-            std::swap(m_children[order[0]], m_children[order[1]]);
-            std::swap(m_children[order[1]], m_children[order[2]]);
-            std::swap(m_children[order[2]], m_children[order[3]]);
-        }
-        for (auto &child : m_children) {
-            child->rotate<1>(axis);
+    // x = 1
+    if (split(1)) {
+        polygons[2] = {{v[4], v[7], v[6]}};
+        polygons[3] = {{v[4], v[5], v[7]}};
+    }
+    // y = 0
+    if (split(2)) {
+        polygons[4] = {{v[0], v[1], v[5]}};
+        polygons[5] = {{v[0], v[5], v[4]}};
+    }
+    // y = 1
+    if (split(3)) {
+        polygons[6] = {{v[2], v[7], v[3]}};
+        polygons[7] = {{v[2], v[6], v[7]}};
+    }
+    // z = 0
+    if (split(4)) {
+        polygons[8] = {{v[0], v[4], v[6]}};
+        polygons[9] = {{v[0], v[6], v[2]}};
+    }
+    // z = 1
+    if (split(5)) {
+        polygons[10] = {{v[1], v[3], v[7]}};
+        polygons[11] = {{v[1], v[7], v[5]}};
+    }
+    return polygons;
+}
+
+CubePolygons Cube::triangulate(const Type type, const glm::vec3 &position, const float size,
+                               const std::array<Indentation, Cube::EDGES> &ind) noexcept {
+    assert(type == Type::SOLID || type == Type::NORMAL);
+    return triangulate(vertices(type, position, size, ind), type == Type::NORMAL ? face_splits(ind) : 0);
+}
+
+void Cube::PendingRotation::apply(std::array<Indentation, EDGES> &indentations) const {
+    const auto previous = indentations;
+    for (std::size_t idx = 0; idx < EDGES; idx++) {
+        indentations[idx] = previous[edges[idx].edge];
+        if (edges[idx].mirrored) {
+            indentations[idx].mirror();
         }
     }
 }
 
-/// 180 degree rotation.
-template <>
-void Cube::rotate<2>(const RotationAxis::Type &axis) {
+void Cube::PendingRotation::apply(PendingRotation &rotation) const {
+    const PendingRotation previous = rotation;
+    for (std::size_t idx = 0; idx < SUB_CUBES; idx++) {
+        rotation.children[idx] = previous.children[children[idx]];
+    }
+    for (std::size_t idx = 0; idx < EDGES; idx++) {
+        const RotatedEdge &edge = previous.edges[edges[idx].edge];
+        rotation.edges[idx] = {edge.edge, edge.mirrored != edges[idx].mirrored};
+    }
+}
+
+template <int Rotations>
+void Cube::rotate(const RotationAxis::Type &axis) {
+    m_polygon_cache_valid = false;
+    m_subtree_dirty = true;
+    m_snapshot.reset();
+    m_lod_proxy.reset();
     if (m_type == Type::NORMAL) {
-        const RotationAxis::EdgeType &edge_rotation = std::get<1>(axis);
-        for (const auto &order : edge_rotation) {
-            std::swap(m_indentations[order[0]], m_indentations[order[2]]);
-            std::swap(m_indentations[order[1]], m_indentations[order[3]]);
-        }
-        // Some indentations need to be mirrored, as the direction has changed.
-        // not the last array, as it contains the edges parallel to the axis around which we rotate
-        for (int idx = 0; idx < edge_rotation.size() - 1; idx++) {
-            m_indentations[edge_rotation[idx][0]].mirror();
-            m_indentations[edge_rotation[idx][1]].mirror();
-            m_indentations[edge_rotation[idx][2]].mirror();
-            m_indentations[edge_rotation[idx][3]].mirror();
-        }
+        rotate_indentations<Rotations>(m_indentations, axis);
         return;
     }
     if (m_type == Type::OCTANT) {
-        const RotationAxis::ChildType &child_rotation = std::get<0>(axis);
-        for (const auto &order : child_rotation) {
-            std::swap(m_children[order[0]], m_children[order[2]]);
-            std::swap(m_children[order[1]], m_children[order[3]]);
-        }
-        for (auto &child : m_children) {
-            child->rotate<2>(axis);
+        // Rotating the identity records where every child and edge comes from.
+        if (!m_pending_rotation) {
+            m_pending_rotation.emplace();
         }
+        rotate_children<Rotations>(m_pending_rotation->children, axis);
+        rotate_indentations<Rotations>(m_pending_rotation->edges, axis);
     }
 }
 
-/// 270 degree rotation.
-template <>
-void Cube::rotate<3>(const RotationAxis::Type &axis) {
-    if (m_type == Type::NORMAL) {
-        const RotationAxis::EdgeType &edge_rotation = std::get<1>(axis);
-        for (const auto &order : edge_rotation) {
-            std::swap(m_indentations[order[0]], m_indentations[order[3]]);
-            std::swap(m_indentations[order[3]], m_indentations[order[2]]);
-            std::swap(m_indentations[order[2]], m_indentations[order[1]]);
-        }
-        // Some indentations need to be mirrored, as the direction has changed.
-        // not the last array, as it contains the edges parallel to the axis around which we rotate
-        m_indentations[edge_rotation[0][1]].mirror();
-        m_indentations[edge_rotation[0][3]].mirror();
-        m_indentations[edge_rotation[1][1]].mirror();
-        m_indentations[edge_rotation[1][3]].mirror();
+void Cube::apply_pending_rotation() const {
+    if (!m_pending_rotation) {
         return;
     }
-    if (m_type == Type::OCTANT) {
-        const RotationAxis::ChildType &child_rotation = std::get<0>(axis);
-        for (const auto &order : child_rotation) {
-            std::swap(m_children[order[0]], m_children[order[3]]);
-            std::swap(m_children[order[3]], m_children[order[2]]);
-            std::swap(m_children[order[2]], m_children[order[1]]);
-        }
-        for (auto &child : m_children) {
-            child->rotate<3>(axis);
+    const PendingRotation rotation = *m_pending_rotation;
+    m_pending_rotation.reset();
+    const auto previous = m_children;
+    // The children moved to new slots, so their index and position have to follow.
+    const float half_size = m_size / 2;
+    for (std::uint8_t idx = 0; idx < SUB_CUBES; idx++) {
+        const auto &child = m_children[idx] = previous[rotation.children[idx]];
+        child->m_index_in_parent = idx;
+        child->m_locational_code = (m_locational_code << 3u) | idx;
+        child->m_position = m_position + half_size * child_offset(idx);
+        child->m_polygon_cache_valid = false;
+        child->m_subtree_dirty = true;
+        child->m_snapshot.reset();
+        child->m_lod_proxy.reset();
+        if (child->m_type == Type::NORMAL) {
+            rotation.apply(child->m_indentations);
+        } else if (child->m_type == Type::OCTANT) {
+            // Even if the rotations cancel out, the grandchildren have to follow the new position of the child.
+            if (!child->m_pending_rotation) {
+                child->m_pending_rotation.emplace();
+            }
+            rotation.apply(*child->m_pending_rotation);
         }
     }
 }
@@ -177,6 +565,19 @@ Cube::Cube(std::weak_ptr<Cube> parent, const std::uint8_t index, const float siz
     : Cube(size, position) {
     m_parent = std::move(parent);
     m_index_in_parent = index;
+    if (const auto parent_cube = m_parent.lock()) {
+        m_parent_node = parent_cube.get();
+        m_locational_code = (parent_cube->m_locational_code << 3u) | index;
+    }
+}
+
+Cube::~Cube() {
+    // Children which are still referenced elsewhere become roots, like the expired m_parent says.
+    for (const auto &child : m_children) {
+        if (child != nullptr) {
+            child->m_parent_node = nullptr;
+        }
+    }
 }
 
 Cube::Cube(Cube &&rhs) noexcept : Cube() {
@@ -190,15 +591,17 @@ Cube &Cube::operator=(Cube rhs) {
 
 std::shared_ptr<Cube> Cube::operator[](std::size_t idx) {
     assert(idx <= SUB_CUBES);
+    apply_pending_rotation();
     return m_children[idx];
 }
 
 std::shared_ptr<const Cube> Cube::operator[](std::size_t idx) const {
     assert(idx <= SUB_CUBES);
+    apply_pending_rotation();
     return m_children[idx];
 }
 
-std::shared_ptr<Cube> Cube::clone() const {
+std::shared_ptr<Cube> Cube::clone_nodes() const {
     std::shared_ptr<Cube> clone = std::make_shared<Cube>(this->m_size, this->m_position);
     clone->m_type = this->m_type;
     clone->m_index_in_parent = this->m_index_in_parent;
@@ -206,49 +609,145 @@ std::shared_ptr<Cube> Cube::clone() const {
     if (clone->m_type == Type::NORMAL) {
         clone->m_indentations = this->m_indentations;
     } else if (clone->m_type == Type::OCTANT) {
-        for (std::size_t idx = 0; idx <= this->m_children.size(); idx++) {
-            clone->m_children[idx] = this->m_children[idx]->clone();
+        clone->m_pending_rotation = this->m_pending_rotation;
+        for (std::size_t idx = 0; idx < this->m_children.size(); idx++) {
+            clone->m_children[idx] = this->m_children[idx]->clone_nodes();
             clone->m_children[idx]->m_parent = clone;
+            clone->m_children[idx]->m_parent_node = clone.get();
+            clone->m_children[idx]->set_locational_code((clone->m_locational_code << 3u) | idx);
         }
     }
     clone->m_polygon_cache_valid = this->m_polygon_cache_valid;
-    if (clone->m_type == Type::NORMAL || clone->m_type == Type::SOLID) {
-        clone->m_polygon_cache = std::make_shared<std::vector<Polygon>>(*this->m_polygon_cache);
+    clone->m_subtree_dirty = this->m_subtree_dirty;
+    clone->m_auto_compaction = this->m_auto_compaction;
+    clone->m_statistics = this->m_statistics;
+    clone->m_polygon_offset = this->m_polygon_offset;
+    // Level of detail proxies are replaced instead of changed and snapshots are immutable, so both can be shared.
+    clone->m_lod_proxy = this->m_lod_proxy;
+    clone->m_occupancy = this->m_occupancy;
+    clone->m_snapshot = this->m_snapshot;
+    return clone;
+}
+
+std::shared_ptr<Cube> Cube::clone() const {
+    std::shared_ptr<Cube> clone = clone_nodes();
+    clone->m_polygon_offset = 0;
+    const auto [root, offset] = polygon_arena_offset();
+    if (root->m_polygon_arena == nullptr) {
+        return clone;
+    }
+    // The clone is a root, so it needs its own arena. The slots of a clean subtree are up to date and contiguous,
+    // otherwise the whole arena is copied and the slots are moved by the next update.
+    const PolygonArena &arena = *root->m_polygon_arena;
+    const std::size_t triangles = m_statistics.triangles();
+    if (!m_subtree_dirty && offset + triangles <= arena.size()) {
+        const auto first = arena.begin() + static_cast<std::ptrdiff_t>(offset);
+        clone->m_polygon_arena = std::make_unique<PolygonArena>(first, first + static_cast<std::ptrdiff_t>(triangles));
+    } else {
+        clone->m_polygon_arena = std::make_unique<PolygonArena>(arena);
+        clone->m_polygon_offset = offset;
     }
     return clone;
 }
 
+OctreeSnapshot Cube::snapshot() const {
+    // Only the subtrees which changed since the last snapshot get new nodes, bottom-up.
+    traverse(
+        *this,
+        [](const Cube &cube) {
+            return cube.m_snapshot != nullptr ? TraversalAction::SKIP_CHILDREN : TraversalAction::CONTINUE;
+        },
+        [](const Cube &cube) {
+            if (cube.m_snapshot != nullptr) {
+                return;
+            }
+            auto node = std::make_shared<SnapshotNode>();
+            node->type = cube.m_type;
+            if (cube.m_type == Type::OCTANT) {
+                for (std::size_t idx = 0; idx < SUB_CUBES; idx++) {
+                    node->children[idx] = cube.m_children[idx]->m_snapshot;
+                }
+            } else if (cube.m_type != Type::EMPTY) {
+                node->indentations = cube.m_indentations;
+                // The polygon cache of the cube is left alone, so update_polygon_caches() still reports the change.
+                node->polygons = std::make_shared<const CubePolygons>(cube.triangles());
+            }
+            cube.m_snapshot = std::move(node);
+        });
+    return {m_snapshot, m_size, m_position};
+}
+
 bool Cube::is_root() const noexcept {
-    return m_parent.lock() == nullptr;
+    return m_parent_node == nullptr;
 }
 
 std::size_t Cube::grid_level() const noexcept {
-    std::size_t level = 0;
-    std::shared_ptr<Cube> parent = m_parent.lock();
-    while (!parent->is_root()) {
-        parent = parent->m_parent.lock();
-        level++;
-    }
-    return level;
+    return static_cast<std::size_t>(std::bit_width(m_locational_code) - 1) / 3;
 }
 
 std::size_t Cube::count_geometry_cubes() const noexcept {
-    if (m_type == Type::SOLID || m_type == Type::NORMAL) {
-        return 1;
+    return statistics().geometry_cubes();
+}
+
+std::size_t Cube::compact() {
+    if (m_type != Type::OCTANT) {
+        return 0;
+    }
+    std::size_t reclaimed = 0;
+    for (const auto &child : m_children) {
+        reclaimed += child->compact();
     }
+    if (const auto type = uniform_children_type()) {
+        collapse(*type);
+        reclaimed += SUB_CUBES;
+    }
+    return reclaimed;
+}
+
+void Cube::set_auto_compaction(const bool enabled) {
+    m_auto_compaction = enabled;
     if (m_type == Type::OCTANT) {
-        std::size_t count = 0;
-        for (const auto &cube : m_children) {
-            count += cube->count_geometry_cubes();
+        for (const auto &child : m_children) {
+            child->set_auto_compaction(enabled);
         }
-        return count;
     }
-    return 0;
 }
 
-void Cube::set_type(const Type new_type) {
+float Cube::occupancy() const {
+    switch (m_type) {
+    case Type::EMPTY:
+        return 0.0f;
+    case Type::SOLID:
+    case Type::NORMAL:
+        return 1.0f;
+    case Type::OCTANT:
+        break;
+    }
+    if (m_lod_proxy == nullptr) {
+        update_lod_proxy();
+    }
+    return m_occupancy;
+}
+
+std::uint8_t Cube::hidden_faces() const {
+    assert(m_type == Type::SOLID || m_type == Type::NORMAL);
+    // The axis of the faces in the order of the polygon cache.
+    static constexpr std::array FACE_AXES{NeighborAxis::X, NeighborAxis::Y, NeighborAxis::Z};
+
+    std::uint8_t hidden = 0;
+    for (std::uint8_t face = 0; face < FACES; face++) {
+        const auto direction = face % 2 == 0 ? NeighborDirection::NEGATIVE : NeighborDirection::POSITIVE;
+        const auto neighbor = this->neighbor(FACE_AXES[face / 2], direction);
+        if (neighbor != nullptr && neighbor->type() == Type::SOLID) {
+            hidden |= 1u << face;
+        }
+    }
+    return hidden;
+}
+
+bool Cube::change_type(const Type new_type) {
     if (m_type == new_type) {
-        return;
+        return false;
     }
     switch (new_type) {
     case Type::EMPTY:
@@ -258,10 +757,16 @@ void Cube::set_type(const Type new_type) {
         m_indentations = {};
         break;
     case Type::OCTANT:
+        // The children would not fit into the locational code.
+        if (grid_level() >= MAX_DEPTH) {
+            throw InexorException("Octree too deep");
+        }
         const float half_size = m_size / 2;
         std::uint8_t index = 0;
         auto create_cube = [&](const glm::vec3 &offset) {
-            return std::make_shared<Cube>(weak_from_this(), index++, half_size, m_position + offset);
+            auto cube = std::make_shared<Cube>(weak_from_this(), index++, half_size, m_position + offset);
+            cube->m_auto_compaction = m_auto_compaction;
+            return cube;
         };
         // Look into octree documentation to find information about the order of subcubes in space.
         // We can't use initializer list here because clang-tidy complains about it.
@@ -279,9 +784,20 @@ void Cube::set_type(const Type new_type) {
     if (m_type == Type::OCTANT && new_type != Type::OCTANT) {
         remove_children();
     }
-    m_polygon_cache_valid = false;
+    invalidate_polygon_cache();
     m_type = new_type;
-    // TODO: clean up if whole octant is empty, etc.
+    update_statistics();
+    return true;
+}
+
+void Cube::set_type(const Type new_type) {
+    if (!change_type(new_type)) {
+        return;
+    }
+    if (m_auto_compaction && new_type != Type::OCTANT) {
+        // Collapsing the parent can destroy this cube, so nothing may be done afterwards.
+        collapse_uniform_octants(m_parent_node);
+    }
 }
 
 Cube::Type Cube::type() const noexcept {
@@ -289,19 +805,46 @@ Cube::Type Cube::type() const noexcept {
 }
 
 const std::array<std::shared_ptr<Cube>, Cube::SUB_CUBES> &Cube::children() const {
+    apply_pending_rotation();
     return m_children;
 }
 
+void Cube::apply_pending_rotations() const {
+    if (!m_subtree_dirty || m_type != Type::OCTANT) {
+        return;
+    }
+    apply_pending_rotation();
+    for (const auto &child : m_children) {
+        child->apply_pending_rotations();
+    }
+}
+
 std::array<Indentation, Cube::EDGES> Cube::indentations() const noexcept {
     return m_indentations;
 }
 
+CubePolygons Cube::triangles() const {
+    assert(m_type == Type::SOLID || m_type == Type::NORMAL);
+    if (m_polygon_cache_valid) {
+        const auto [root, offset] = polygon_arena_offset();
+        // The offsets and the arena are only changed together, so the slot of a valid polygon cache holds its polygons.
+        CubePolygons polygons;
+        if (root->m_polygon_arena != nullptr && offset + polygons.size() <= root->m_polygon_arena->size()) {
+            std::copy_n(root->m_polygon_arena->begin() + static_cast<std::ptrdiff_t>(offset), polygons.size(),
+                        polygons.begin());
+            return polygons;
+        }
+    }
+    return triangulate(m_type, m_position, m_size, m_indentations);
+}
+
 void Cube::set_indent(const std::uint8_t edge_id, Indentation indentation) {
     if (m_type != Type::NORMAL) {
         return;
     }
     assert(edge_id <= Cube::EDGES);
     m_indentations[edge_id] = indentation;
+    invalidate_polygon_cache();
 }
 
 void Cube::indent(const std::uint8_t edge_id, const bool positive_direction, const std::uint8_t steps) {
@@ -314,7 +857,7 @@ void Cube::indent(const std::uint8_t edge_id, const bool positive_direction, con
     } else {
         m_indentations[edge_id].indent_end(steps);
     }
-    m_polygon_cache_valid = false;
+    invalidate_polygon_cache();
 }
 
 void Cube::rotate(const RotationAxis::Type &axis, int rotations) {
@@ -335,163 +878,197 @@ void Cube::rotate(const RotationAxis::Type &axis, int rotations) {
     default:
         break;
     }
+    mark_subtree_dirty();
 }
 
 void Cube::update_polygon_cache() const {
-    if (m_type == Type::OCTANT || m_type == Type::EMPTY) {
-        m_polygon_cache = nullptr;
-        m_polygon_cache_valid = true;
-        return;
+    const auto [arena, offset] = update_polygon_arena();
+    update_polygon_cache(*arena, offset);
+}
+
+void Cube::invalidate_polygon_cache() const {
+    m_polygon_cache_valid = false;
+    mark_subtree_dirty();
+}
+
+std::vector<std::shared_ptr<const Cube>> Cube::update_polygon_caches() const {
+    std::vector<std::shared_ptr<const Cube>> changed;
+    if (update_dirty_polygon_caches(&changed)) {
+        changed.push_back(shared_from_this());
     }
-    const std::array<glm::vec3, 8> v = vertices();
-    m_polygon_cache = std::make_shared<std::vector<Polygon>>(std::vector<Polygon>{
-        {{v[0], v[2], v[1]}}, // x = 0
-        {{v[1], v[2], v[3]}}, // x = 0
-        {{v[4], v[5], v[6]}}, // x = 1
-        {{v[5], v[7], v[6]}}, // x = 1
-        {{v[0], v[1], v[4]}}, // y = 0
-        {{v[1], v[5], v[4]}}, // y = 0
-        {{v[2], v[6], v[3]}}, // y = 1
-        {{v[3], v[6], v[7]}}, // y = 1
-        {{v[0], v[4], v[2]}}, // z = 0
-        {{v[2], v[4], v[6]}}, // z = 0
-        {{v[1], v[3], v[5]}}, // z = 1
-        {{v[3], v[7], v[5]}}  // z = 1
-    });
-    if (m_type == Type::SOLID) {
-        m_polygon_cache_valid = true;
-        return;
+    return changed;
+}
+
+std::span<const Polygon> Cube::polygons(const bool update_invalid) const {
+    if (update_invalid) {
+        update_dirty_polygon_caches(nullptr);
     }
-    if (m_type == Type::NORMAL) {
-        const std::array<Indentation, Cube::EDGES> ind = m_indentations;
-
-        // Check for each side if the side is convex, rotate the hypotenuse (middle diagonal edge) so it becomes convex!
-        // x = 0
-        if (ind[0].start() + ind[6].start() < ind[9].start() + ind[3].start()) {
-            (*m_polygon_cache)[0] = {{v[0], v[2], v[3]}};
-            (*m_polygon_cache)[1] = {{v[0], v[3], v[1]}};
-        }
-        // x = 1
-        if (ind[0].end() + ind[6].end() < ind[9].end() + ind[3].end()) {
-            (*m_polygon_cache)[2] = {{v[4], v[7], v[6]}};
-            (*m_polygon_cache)[3] = {{v[4], v[5], v[7]}};
-        }
-        // y = 0
-        if (ind[1].start() + ind[7].start() < ind[4].start() + ind[10].start()) {
-            (*m_polygon_cache)[4] = {{v[0], v[1], v[5]}};
-            (*m_polygon_cache)[5] = {{v[0], v[5], v[4]}};
-        }
-        // y = 1
-        if (ind[1].end() + ind[7].end() < ind[4].end() + ind[10].end()) {
-            (*m_polygon_cache)[6] = {{v[2], v[7], v[3]}};
-            (*m_polygon_cache)[7] = {{v[2], v[6], v[7]}};
-        }
-        // z = 0
-        if (ind[2].start() + ind[8].start() < ind[11].start() + ind[5].start()) {
-            (*m_polygon_cache)[8] = {{v[0], v[4], v[6]}};
-            (*m_polygon_cache)[9] = {{v[0], v[6], v[2]}};
-        }
-        // z = 1
-        if (ind[2].end() + ind[8].end() < ind[11].end() + ind[5].end()) {
-            (*m_polygon_cache)[10] = {{v[1], v[3], v[7]}};
-            (*m_polygon_cache)[11] = {{v[1], v[7], v[5]}};
-        }
-        m_polygon_cache_valid = true;
-        return;
+    const auto [root, offset] = polygon_arena_offset();
+    if (root->m_polygon_arena == nullptr) {
+        return {};
     }
-    // This point should not be reached.
-    assert(false);
+    // Without an update, the slots can be outdated, but they must not leave the arena.
+    const std::span<const Polygon> arena(*root->m_polygon_arena);
+    const std::size_t first = std::min(offset, arena.size());
+    return arena.subspan(first, std::min(m_statistics.triangles(), arena.size() - first));
 }
-void Cube::invalidate_polygon_cache() const {
-    m_polygon_cache_valid = false;
+
+std::span<const Polygon> Cube::polygons(tools::ThreadPool &thread_pool, const std::size_t split_depth) const {
+    // The slots are assigned first, so every subtree only writes to its own slots and no synchronization is needed.
+    const auto [arena, offset] = update_polygon_arena();
+    std::vector<const Cube *> subtrees;
+    std::vector<const Cube *> octants;
+    traverse_pre_order(*this, [&](const Cube &cube, const std::size_t depth) {
+        if (cube.type() == Type::OCTANT && depth < split_depth) {
+            cube.m_polygon_cache_valid = true;
+            octants.push_back(&cube);
+            return TraversalAction::CONTINUE;
+        }
+        subtrees.push_back(&cube);
+        return TraversalAction::SKIP_CHILDREN;
+    });
+
+    thread_pool.parallel_for(subtrees.size(), [&, arena = arena](const std::size_t idx) {
+        subtrees[idx]->update_dirty_polygon_caches(nullptr, *arena, subtrees[idx]->polygon_arena_offset().second);
+    });
+    // All subtrees are clean now, so the octants above them are too.
+    for (const auto *octant : octants) {
+        octant->m_subtree_dirty = false;
+    }
+    return std::span<const Polygon>(*arena).subspan(offset, m_statistics.triangles());
 }
-std::vector<PolygonCache> Cube::polygons(const bool update_invalid) const {
-    std::vector<PolygonCache> polygons;
-    polygons.reserve(count_geometry_cubes());
 
-    // post-order traversal
-    std::function<void(const Cube &)> collect = [&collect, &polygons, &update_invalid](const Cube &cube) {
-        if (cube.type() == world::Cube::Type::OCTANT) {
-            for (const auto &child : cube.children()) {
-                collect(*child);
+std::vector<std::span<const Polygon>> Cube::lod_polygons(const glm::vec3 &position, const float min_size_ratio,
+                                                         const float occupancy_threshold,
+                                                         const bool update_invalid) const {
+    if (update_invalid) {
+        update_dirty_polygon_caches(nullptr);
+    }
+    std::vector<std::span<const Polygon>> polygons;
+    const auto append = [&](const std::span<const Polygon> range) {
+        if (!polygons.empty() && polygons.back().data() + polygons.back().size() == range.data()) {
+            polygons.back() = {polygons.back().data(), polygons.back().size() + range.size()};
+        } else {
+            polygons.push_back(range);
+        }
+    };
+    const auto [root, offset] = polygon_arena_offset();
+    if (root->m_polygon_arena == nullptr) {
+        return polygons;
+    }
+    const std::span<const Polygon> arena(*root->m_polygon_arena);
+    const auto visit = [&](const auto &self, const Cube &cube, const std::size_t first) -> void {
+        if (cube.m_type != Type::OCTANT) {
+            if (cube.m_type != Type::EMPTY && cube.m_polygon_cache_valid &&
+                first + std::tuple_size_v<CubePolygons> <= arena.size()) {
+                append(arena.subspan(first, std::tuple_size_v<CubePolygons>));
             }
             return;
         }
-        if (!cube.m_polygon_cache_valid && update_invalid) {
-            cube.update_polygon_cache();
+        if (cube.lod_detailed(position, min_size_ratio)) {
+            for (const auto &child : cube.children()) {
+                self(self, *child, first + child->m_polygon_offset);
+            }
+            return;
         }
-        if (cube.m_polygon_cache != nullptr) {
-            polygons.push_back(cube.m_polygon_cache);
+        if (cube.occupancy() >= occupancy_threshold) {
+            polygons.emplace_back(*cube.m_lod_proxy);
         }
     };
-    collect(*this);
+    visit(visit, *this, offset);
     return polygons;
 }
 
-std::shared_ptr<Cube> Cube::neighbor(const NeighborAxis axis, const NeighborDirection direction) {
-    if (is_root()) {
-        return nullptr;
-    }
+bool Cube::lod_detailed(const glm::vec3 &position, const float min_size_ratio) const {
+    // The distance to the closest point of the cube, which is 0 if the position is inside.
+    const glm::vec3 closest = glm::clamp(position, m_position, m_position + m_size);
+    return m_size >= min_size_ratio * glm::distance(position, closest);
+}
 
-    // Each axis only requires information and manipulation of one (relevant) bit to find the neighbor.
-    const auto relevant_index_bit = static_cast<std::uint8_t>(axis); // bit index of the axis we are working on
+bool Cube::lod_selection_changed(const glm::vec3 &old_position, const glm::vec3 &new_position,
+                                 const float min_size_ratio) const {
+    if (m_type != Type::OCTANT) {
+        return false;
+    }
+    const bool detailed = lod_detailed(old_position, min_size_ratio);
+    if (detailed != lod_detailed(new_position, min_size_ratio)) {
+        return true;
+    }
+    // An octant which is replaced by its proxy for both positions is drawn the same way.
+    return detailed && std::any_of(children().begin(), children().end(), [&](const auto &child) {
+               return child->lod_selection_changed(old_position, new_position, min_size_ratio);
+           });
+}
 
-    auto get_bit = [&relevant_index_bit](const std::uint8_t cube_index) {
-        return ((cube_index >> relevant_index_bit) & 1u) != 0;
-    };
-    auto toggle_bit = [&relevant_index_bit](const std::uint8_t cube_index) {
-        return cube_index ^ (1u << relevant_index_bit);
+std::vector<Polygon> Cube::visible_polygons(const bool update_invalid) const {
+    if (update_invalid) {
+        update_dirty_polygon_caches(nullptr);
+    }
+    std::vector<Polygon> polygons;
+    polygons.reserve(m_statistics.triangles());
+    const auto [root, offset] = polygon_arena_offset();
+    if (root->m_polygon_arena == nullptr) {
+        return polygons;
+    }
+    const std::span<const Polygon> arena(*root->m_polygon_arena);
+    const auto visit = [&](const auto &self, const Cube &cube, const std::size_t first) -> void {
+        if (cube.m_type == Type::OCTANT) {
+            for (const auto &child : cube.children()) {
+                self(self, *child, first + child->m_polygon_offset);
+            }
+        } else if (cube.m_type != Type::EMPTY && cube.m_polygon_cache_valid &&
+                   first + std::tuple_size_v<CubePolygons> <= arena.size()) {
+            cube.append_visible_polygons(arena.subspan(first, std::tuple_size_v<CubePolygons>), polygons);
+        }
     };
+    visit(visit, *this, offset);
+    return polygons;
+}
 
-    auto parent = m_parent.lock();
-    const std::uint8_t index = m_index_in_parent;
-    const bool home_bit = get_bit(index);
+std::shared_ptr<const Cube> Cube::neighbor(const NeighborAxis axis, const NeighborDirection direction) const {
+    // The search only applies the pending rotations on the path to the neighbor, which children() const does as well.
+    return const_cast<Cube *>(this)->neighbor(axis, direction); // NOLINT
+}
 
-    // The relevant bit denotes whether `m_parent` and `this` share a face on the upper side of the relevant axis.
-    // If they share one and also the user wants to go in the positive direction, then the neighbor is not a sibling.
-    // (Same for opposite, i.e. share face on lower side and going negative direction.)
-    if (home_bit && direction == NeighborDirection::NEGATIVE || !home_bit && direction == NeighborDirection::POSITIVE) {
-        // The demanded neighbor is a sibling! Return the neighboring sibling.
-        return parent->m_children[toggle_bit(index)];
-    }
-    if (parent->is_root()) {
+std::shared_ptr<Cube> Cube::neighbor(const NeighborAxis axis, const NeighborDirection direction) {
+    // Each level of the locational code holds one bit per axis, which together form the coordinate of the cube on that
+    // axis. The neighbor is one step away, so adding (or subtracting) one to this coordinate toggles the bits of the
+    // lowest levels up to and including the first one which does not carry over, i.e. which is 0 (or 1).
+    const auto depth = static_cast<std::size_t>((std::bit_width(m_locational_code) - 1) / 3);
+    const std::uint64_t path_mask = (std::uint64_t{1} << (3 * depth)) - 1;
+    // Bits 0, 3, 6, ... of the code, shifted to the bit of the axis.
+    const std::uint64_t axis_mask = (0x1249249249249249ull << static_cast<std::uint8_t>(axis)) & path_mask;
+    const std::uint64_t carry_stops =
+        (direction == NeighborDirection::POSITIVE ? ~m_locational_code : m_locational_code) & axis_mask;
+    if (carry_stops == 0) {
+        // The carry runs over the root, the neighbor would be outside of the octree.
         return nullptr;
     }
-    // the neighbor is further away than a sibling
+    const auto last_toggled_bit = static_cast<std::size_t>(std::countr_zero(carry_stops));
+    const std::uint64_t neighbor_code = m_locational_code ^ (axis_mask & ((std::uint64_t{2} << last_toggled_bit) - 1));
+    const std::size_t levels = last_toggled_bit / 3 + 1;
 
-    // Keep the history of indices because we just need to mirror indices (i.e. toggle the relevant bit)
-    // to find the desired neighboring cube.
-    std::vector<std::uint8_t> history;
-    history.push_back(index);
-
-    // Find the first cube where the bit (of `get_bit`) is different to `this_bit`.
-    // That cubes parent is the first mutual parent of the desired neighbor and `this`.
-    std::uint8_t p_index = parent->m_index_in_parent;
-    history.push_back(p_index);
-    while (get_bit(p_index) == home_bit) {
-        parent = parent->m_parent.lock();
-        if (parent->is_root()) {
+    // The levels above the last toggled bit are shared with the neighbor, so that cube is the first mutual parent.
+    Cube *mutual_parent = this;
+    for (std::size_t level = 0; level < levels; level++) {
+        mutual_parent = mutual_parent->m_parent_node;
+        if (mutual_parent == nullptr) {
             return nullptr;
         }
-        p_index = parent->m_index_in_parent;
-        history.push_back(p_index);
     }
 
-    // get the first mutual parent of neighbor and `this`.
-    std::shared_ptr<Cube> child = parent->m_parent.lock();
-
-    // Now mirror the path we took by just flipping the relevant bit of each index in the history.
-    while (!history.empty()) {
-        if (child->m_type != Type::OCTANT) {
-            // The neighbor is larger but still a neighbor!
-            return {child};
+    // Now walk down the path of the neighbor.
+    Cube *cube = mutual_parent;
+    for (std::size_t level = levels; level-- > 0;) {
+        cube->apply_pending_rotation();
+        const std::shared_ptr<Cube> &child = cube->m_children[(neighbor_code >> (3 * level)) & 0b111u];
+        if (level == 0 || child->m_type != Type::OCTANT) {
+            // We found a same-sized neighbor, or a larger one which is still a neighbor!
+            return child;
         }
-        child = child->m_children[toggle_bit(history.back())];
-        history.pop_back();
+        cube = child.get();
     }
-
-    // We found a same-sized neighbor!
-    return {child};
+    return nullptr;
 }
 
 std::shared_ptr<Cube> create_random_world(std::uint32_t max_depth, const glm::vec3 &position,
@@ -503,32 +1080,30 @@ std::shared_ptr<Cube> create_random_world(std::uint32_t max_depth, const glm::ve
 
     std::shared_ptr<Cube> cube = std::make_shared<Cube>(4.0f, position);
     cube->set_type(Cube::Type::OCTANT);
-    std::function<void(const Cube &, std::uint32_t)> populate_cube = [&](const Cube &parent, std::uint32_t depth) {
-        for (const auto &child : parent.children()) {
-            if (depth != max_depth) {
-                child->set_type(Cube::Type::OCTANT);
-                populate_cube(*child, depth + 1);
-                continue;
-            }
-            auto ty = cube_type(mt);
-            if (ty < 30) {
-                child->set_type(Cube::Type::EMPTY);
-                continue;
-            }
-            if (ty < 60) {
-                child->set_type(Cube::Type::SOLID);
-                continue;
-            }
-            if (ty < 100) {
-                child->set_type(Cube::Type::NORMAL);
-                for (int i = 0; i < 12; i++) {
-                    child->set_indent(i, Indentation(indent(mt)));
-                }
-                continue;
+    traverse_pre_order(*cube, [&](Cube &child, const std::size_t depth) {
+        if (depth == 0) {
+            return;
+        }
+        if (depth <= max_depth) {
+            child.set_type(Cube::Type::OCTANT);
+            return;
+        }
+        auto ty = cube_type(mt);
+        if (ty < 30) {
+            child.set_type(Cube::Type::EMPTY);
+            return;
+        }
+        if (ty < 60) {
+            child.set_type(Cube::Type::SOLID);
+            return;
+        }
+        if (ty < 100) {
+            child.set_type(Cube::Type::NORMAL);
+            for (int i = 0; i < 12; i++) {
+                child.set_indent(i, Indentation(indent(mt)));
             }
         }
-    };
-    populate_cube(*cube, 0);
+    });
     return cube;
 }
 
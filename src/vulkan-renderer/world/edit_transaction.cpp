@@ -0,0 +1,241 @@
+#include "inexor/vulkan-renderer/world/edit_transaction.hpp"
+
+#include "inexor/vulkan-renderer/exception.hpp"
+
+#include <glm/common.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <limits>
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// Grid level of the cube with the given locational code, the root has level 0.
+std::size_t depth(const std::uint64_t code) {
+    return static_cast<std::size_t>((std::bit_width(code) - 1) / 3);
+}
+
+/// Whether the cube with the given code is the ancestor or the cube itself.
+bool contains(const std::uint64_t ancestor, const std::uint64_t code) {
+    const std::size_t ancestor_depth = depth(ancestor);
+    const std::size_t code_depth = depth(code);
+    return code_depth >= ancestor_depth && (code >> (3 * (code_depth - ancestor_depth))) == ancestor;
+}
+
+} // namespace
+
+EditTransaction::EditTransaction(std::shared_ptr<Cube> root) : m_root(std::move(root)) {
+    assert(m_root != nullptr);
+}
+
+std::pair<std::uint64_t, std::size_t> EditTransaction::key(const std::uint64_t code) noexcept {
+    // Aligning the paths to the left orders the cubes like a depth-first traversal, the depth puts parents first.
+    const std::size_t code_depth = depth(code);
+    return {code << (3 * (Cube::MAX_DEPTH - code_depth)), code_depth};
+}
+
+void EditTransaction::push(Edit edit) {
+    if (edit.kind == Edit::Kind::ROTATE) {
+        // The cubes move to other locational codes, so the queued edits can't be coalesced with later ones.
+        m_edits_by_cube.clear();
+    } else {
+        m_edits_by_cube[key(edit.code)].push_back(m_edits.size());
+    }
+    m_edits.push_back(std::move(edit));
+}
+
+void EditTransaction::drop(std::vector<std::size_t> &edits) {
+    for (const std::size_t idx : edits) {
+        m_edits[idx].dropped = true;
+    }
+    edits.clear();
+}
+
+std::pair<Cube *, bool> EditTransaction::find(const std::uint64_t code) const {
+    Cube *cube = m_root.get();
+    for (std::size_t level = depth(code) - depth(m_root->m_locational_code); level-- > 0;) {
+        if (cube->m_type != Cube::Type::OCTANT) {
+            return {cube, false};
+        }
+        cube->apply_pending_rotation();
+        cube = cube->m_children[(code >> (3 * level)) & 0b111u].get();
+    }
+    return {cube, true};
+}
+
+void EditTransaction::set_type(const std::uint64_t code, const Cube::Type type) {
+    assert(contains(m_root->m_locational_code, code));
+    // Rejected right away, so commit() does not stop halfway through the edits.
+    if (type == Cube::Type::OCTANT && depth(code) >= Cube::MAX_DEPTH) {
+        throw InexorException("Octree too deep");
+    }
+    m_queued_edits++;
+    Edit edit{.kind = Edit::Kind::TYPE, .code = code, .type = type};
+
+    const auto cube = m_edits_by_cube.find(key(code));
+    if (cube != m_edits_by_cube.end()) {
+        const auto previous_type = std::find_if(cube->second.rbegin(), cube->second.rend(), [&](const std::size_t idx) {
+            return m_edits[idx].kind == Edit::Kind::TYPE;
+        });
+        if (previous_type != cube->second.rend()) {
+            if (m_edits[*previous_type].type == type) {
+                // The cube already has this type when the edit is applied.
+                return;
+            }
+            // The earlier type change is replaced. If the cube had the new type before, it still has to be reset,
+            // as it has been something else in between.
+            edit.reset = true;
+        }
+        // Indentations don't matter for other types, and changes of a cube which got a new type were no-ops.
+        if (edit.reset || type != Cube::Type::NORMAL) {
+            drop(cube->second);
+        }
+    }
+
+    // The children are replaced, unless the cube was an octant already.
+    const auto [aligned, cube_depth] = key(code);
+    const std::uint64_t last_descendant = aligned + ((std::uint64_t{1} << (3 * (Cube::MAX_DEPTH - cube_depth))) - 1);
+    const auto first = m_edits_by_cube.upper_bound({aligned, cube_depth});
+    const auto last = m_edits_by_cube.upper_bound({last_descendant, std::numeric_limits<std::size_t>::max()});
+    if (edit.reset || type != Cube::Type::OCTANT) {
+        for (auto descendant = first; descendant != last; ++descendant) {
+            drop(descendant->second);
+        }
+    }
+    // If the cube was no octant before, the earlier edits of its children targeted cubes which did not exist, so
+    // they must not be coalesced with the ones of the new children.
+    m_edits_by_cube.erase(first, last);
+    push(std::move(edit));
+}
+
+void EditTransaction::set_indent(const std::uint64_t code, const std::uint8_t edge_id, const Indentation indentation) {
+    assert(contains(m_root->m_locational_code, code));
+    assert(edge_id < Cube::EDGES);
+    m_queued_edits++;
+    const auto cube = m_edits_by_cube.find(key(code));
+    if (cube != m_edits_by_cube.end()) {
+        // Earlier changes of the same edge are overwritten.
+        auto &edits = cube->second;
+        edits.erase(std::remove_if(edits.begin(), edits.end(),
+                                   [&](const std::size_t idx) {
+                                       Edit &earlier = m_edits[idx];
+                                       if (earlier.kind == Edit::Kind::TYPE || earlier.edge_id != edge_id) {
+                                           return false;
+                                       }
+                                       earlier.dropped = true;
+                                       return true;
+                                   }),
+                    edits.end());
+    }
+    push({.kind = Edit::Kind::SET_INDENT, .code = code, .edge_id = edge_id, .indentation = indentation});
+}
+
+void EditTransaction::indent(const std::uint64_t code, const std::uint8_t edge_id, const bool positive_direction,
+                             const std::uint8_t steps) {
+    assert(contains(m_root->m_locational_code, code));
+    assert(edge_id < Cube::EDGES);
+    m_queued_edits++;
+    push({.kind = Edit::Kind::INDENT,
+          .code = code,
+          .edge_id = edge_id,
+          .positive_direction = positive_direction,
+          .steps = steps});
+}
+
+void EditTransaction::rotate(const std::uint64_t code, const Cube::RotationAxis::Type &axis, int rotations) {
+    assert(contains(m_root->m_locational_code, code));
+    m_queued_edits++;
+    rotations = ((rotations % 4) + 4) % 4;
+    if (rotations == 0) {
+        return;
+    }
+    // Merge consecutive rotations of the same cube around the same axis.
+    const auto previous =
+        std::find_if(m_edits.rbegin(), m_edits.rend(), [](const Edit &edit) { return !edit.dropped; });
+    if (previous != m_edits.rend() && previous->kind == Edit::Kind::ROTATE && previous->code == code &&
+        previous->axis == axis) {
+        previous->rotations = (previous->rotations + rotations) % 4;
+        previous->dropped = previous->rotations == 0;
+        return;
+    }
+    push({.kind = Edit::Kind::ROTATE, .code = code, .axis = axis, .rotations = rotations});
+}
+
+std::size_t EditTransaction::pending_edits() const noexcept {
+    return static_cast<std::size_t>(
+        std::count_if(m_edits.begin(), m_edits.end(), [](const Edit &edit) { return !edit.dropped; }));
+}
+
+ChangedRegion EditTransaction::commit() {
+    ChangedRegion region;
+    region.queued_edits = m_queued_edits;
+
+    std::vector<std::uint64_t> changed;
+    for (const auto &edit : m_edits) {
+        if (edit.dropped) {
+            continue;
+        }
+        const auto [cube, exists] = find(edit.code);
+        if (!exists) {
+            continue;
+        }
+        switch (edit.kind) {
+        case Edit::Kind::TYPE:
+            if (edit.reset && cube->m_type == edit.type) {
+                cube->change_type(Cube::Type::EMPTY);
+            }
+            cube->change_type(edit.type);
+            break;
+        case Edit::Kind::SET_INDENT:
+            cube->set_indent(edit.edge_id, edit.indentation);
+            break;
+        case Edit::Kind::INDENT:
+            cube->indent(edit.edge_id, edit.positive_direction, edit.steps);
+            break;
+        case Edit::Kind::ROTATE:
+            cube->rotate(edit.axis, edit.rotations);
+            break;
+        }
+        region.applied_edits++;
+        changed.push_back(edit.code);
+    }
+    m_edits.clear();
+    m_edits_by_cube.clear();
+    m_queued_edits = 0;
+
+    // Parents come before their children now, and each cube is only listed once.
+    std::sort(changed.begin(), changed.end(), [](const auto lhs, const auto rhs) { return key(lhs) < key(rhs); });
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+
+    // Compact bottom-up. A collapse can remove changed cubes, so every cube is looked up again.
+    for (auto code = changed.rbegin(); code != changed.rend(); ++code) {
+        Cube *cube = find(*code).first;
+        if (cube->m_auto_compaction) {
+            Cube::collapse_uniform_octants(cube->m_type == Cube::Type::OCTANT ? cube : cube->m_parent_node);
+        }
+    }
+
+    for (const auto code : changed) {
+        Cube *cube = find(code).first;
+        // A removed cube is covered by a leaf which can contain the changed cubes before it.
+        while (!region.subtrees.empty() &&
+               contains(cube->m_locational_code, region.subtrees.back()->m_locational_code)) {
+            region.subtrees.pop_back();
+        }
+        if (region.subtrees.empty() || !contains(region.subtrees.back()->m_locational_code, cube->m_locational_code)) {
+            region.subtrees.push_back(cube->shared_from_this());
+        }
+    }
+    for (std::size_t idx = 0; idx < region.subtrees.size(); idx++) {
+        const auto box = region.subtrees[idx]->bounding_box();
+        region.bounding_box = idx == 0 ? box
+                                       : std::array{glm::min(region.bounding_box[0], box[0]),
+                                                    glm::max(region.bounding_box[1], box[1])};
+    }
+    return region;
+}
+
+} // namespace inexor::vulkan_renderer::world
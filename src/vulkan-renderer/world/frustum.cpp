@@ -0,0 +1,67 @@
+#include "inexor/vulkan-renderer/world/frustum.hpp"
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <limits>
+
+namespace inexor::vulkan_renderer::world {
+
+Frustum::Frustum(const glm::mat4 &view, const glm::mat4 &perspective) {
+    const glm::mat4 clip = perspective * view;
+    // A point is inside if its clip coordinates satisfy -w <= x <= w, -w <= y <= w and 0 <= z <= w.
+    // glm matrices are column-major, so row i is made of the i-th component of each column.
+    const auto row = [&](const int idx) { return glm::vec4(clip[0][idx], clip[1][idx], clip[2][idx], clip[3][idx]); };
+    m_planes = {row(3) + row(0), row(3) - row(0), row(3) + row(1), row(3) - row(1), row(2), row(3) - row(2)};
+}
+
+Frustum::Containment Frustum::classify(const std::array<glm::vec3, 2> &box_bounds) const {
+    Containment containment = Containment::INSIDE;
+    for (const auto &plane : m_planes) {
+        // The corners of the box which are the farthest in front of and behind the plane.
+        const glm::vec3 front(plane.x >= 0.0f ? box_bounds[1].x : box_bounds[0].x,
+                              plane.y >= 0.0f ? box_bounds[1].y : box_bounds[0].y,
+                              plane.z >= 0.0f ? box_bounds[1].z : box_bounds[0].z);
+        const glm::vec3 back(plane.x >= 0.0f ? box_bounds[0].x : box_bounds[1].x,
+                             plane.y >= 0.0f ? box_bounds[0].y : box_bounds[1].y,
+                             plane.z >= 0.0f ? box_bounds[0].z : box_bounds[1].z);
+        if (plane.x * front.x + plane.y * front.y + plane.z * front.z + plane.w < 0.0f) {
+            return Containment::OUTSIDE;
+        }
+        if (plane.x * back.x + plane.y * back.y + plane.z * back.z + plane.w < 0.0f) {
+            containment = Containment::INTERSECTING;
+        }
+    }
+    return containment;
+}
+
+std::vector<const Cube *> visible_subtrees(const Cube &cube, const Frustum &frustum, const std::size_t split_depth) {
+    std::vector<const Cube *> subtrees;
+    // Depth of the octant which lies inside of the frustum, all cubes below it are visible.
+    std::size_t inside_depth = std::numeric_limits<std::size_t>::max();
+    traverse_pre_order(cube, [&](const Cube &current, const std::size_t depth) {
+        if (depth <= inside_depth) {
+            inside_depth = std::numeric_limits<std::size_t>::max();
+        }
+        if (current.type() == Cube::Type::EMPTY) {
+            return TraversalAction::SKIP_CHILDREN;
+        }
+        if (inside_depth == std::numeric_limits<std::size_t>::max()) {
+            const auto containment = frustum.classify(current.bounding_box());
+            if (containment == Frustum::Containment::OUTSIDE) {
+                return TraversalAction::SKIP_CHILDREN;
+            }
+            if (containment == Frustum::Containment::INSIDE) {
+                inside_depth = depth;
+            }
+        }
+        if (current.type() == Cube::Type::OCTANT && depth < split_depth) {
+            return TraversalAction::CONTINUE;
+        }
+        subtrees.push_back(&current);
+        return TraversalAction::SKIP_CHILDREN;
+    });
+    return subtrees;
+}
+
+} // namespace inexor::vulkan_renderer::world
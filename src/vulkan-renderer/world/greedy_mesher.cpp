@@ -0,0 +1,258 @@
+#include "inexor/vulkan-renderer/world/greedy_mesher.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <tuple>
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// Coordinate on the grid of the smallest solid cube.
+using GridCoordinate = std::int64_t;
+
+/// Faces in [begin, end) along the u axis of a slice.
+struct Span {
+    GridCoordinate begin;
+    GridCoordinate end;
+};
+
+/// One row of faces in a slice, i.e. the faces in the plane ``axis = plane`` at ``v``, where u and v are the next two
+/// axes after ``axis``.
+struct FaceRow {
+    std::uint8_t axis;
+    /// Whether the faces point in positive axis direction.
+    bool positive;
+    GridCoordinate plane;
+    GridCoordinate v;
+    Span span;
+};
+
+/// Get the deepest grid level of a Type::SOLID cube, relative to the given cube.
+std::size_t solid_depth(const Cube &cube) {
+    std::size_t depth = 0;
+    std::vector<std::pair<const Cube *, std::size_t>> stack{{&cube, 0}};
+    while (!stack.empty()) {
+        const auto [current, level] = stack.back();
+        stack.pop_back();
+        if (current->type() == Cube::Type::SOLID) {
+            depth = std::max(depth, level);
+        } else if (current->type() == Cube::Type::OCTANT) {
+            for (const auto &child : current->children()) {
+                stack.emplace_back(child.get(), level + 1);
+            }
+        }
+    }
+    return depth;
+}
+
+/// Merge the sorted spans of one row, so touching spans become one.
+std::vector<Span> merge_spans(const std::vector<Span> &spans) {
+    std::vector<Span> merged;
+    for (const auto &span : spans) {
+        if (!merged.empty() && merged.back().end >= span.begin) {
+            merged.back().end = std::max(merged.back().end, span.end);
+        } else {
+            merged.push_back(span);
+        }
+    }
+    return merged;
+}
+
+/// Get the parts of the merged spans ``lhs`` which are not covered by the merged spans ``rhs``.
+std::vector<Span> subtract_spans(const std::vector<Span> &lhs, const std::vector<Span> &rhs) {
+    std::vector<Span> result;
+    std::size_t other = 0;
+    for (Span span : lhs) {
+        while (other < rhs.size() && rhs[other].end <= span.begin) {
+            other++;
+        }
+        for (std::size_t idx = other; idx < rhs.size() && rhs[idx].begin < span.end; idx++) {
+            if (rhs[idx].begin > span.begin) {
+                result.push_back({span.begin, rhs[idx].begin});
+            }
+            span.begin = std::max(span.begin, rhs[idx].end);
+        }
+        if (span.begin < span.end) {
+            result.push_back(span);
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+std::vector<Polygon> greedy_mesh(const Cube &cube, const bool update_invalid) {
+    if (update_invalid) {
+        cube.update_dirty_polygon_caches(nullptr);
+    }
+    const std::size_t depth = solid_depth(cube);
+    assert(depth < 48 && "Octree too deep for greedy meshing!");
+    const float cell_size = cube.size() / static_cast<float>(GridCoordinate{1} << depth);
+
+    std::vector<Polygon> polygons;
+    std::vector<Polygon> normal_polygons;
+    std::vector<FaceRow> rows;
+
+    // Project all solid faces onto the grid, split into rows of one cell.
+    struct Entry {
+        const Cube *cube;
+        std::array<GridCoordinate, 3> position;
+        GridCoordinate extent;
+    };
+    std::vector<Entry> stack{{&cube, {0, 0, 0}, GridCoordinate{1} << depth}};
+    while (!stack.empty()) {
+        const Entry entry = stack.back();
+        stack.pop_back();
+        switch (entry.cube->type()) {
+        case Cube::Type::EMPTY:
+            break;
+        case Cube::Type::NORMAL:
+            entry.cube->append_visible_polygons(entry.cube->triangles(), normal_polygons);
+            break;
+        case Cube::Type::SOLID:
+            for (std::uint8_t axis = 0; axis < 3; axis++) {
+                const std::uint8_t u = (axis + 1) % 3;
+                const std::uint8_t v = (axis + 2) % 3;
+                for (const bool positive : {false, true}) {
+                    const GridCoordinate plane = entry.position[axis] + (positive ? entry.extent : 0);
+                    for (GridCoordinate row = 0; row < entry.extent; row++) {
+                        rows.push_back({axis,
+                                        positive,
+                                        plane,
+                                        entry.position[v] + row,
+                                        {entry.position[u], entry.position[u] + entry.extent}});
+                    }
+                }
+            }
+            break;
+        case Cube::Type::OCTANT:
+            // Visit the children in descending order, so the normal cubes keep the order of polygons().
+            const GridCoordinate half_extent = entry.extent / 2;
+            for (std::uint8_t idx = Cube::SUB_CUBES; idx-- > 0;) {
+                const glm::vec3 offset = Cube::child_offset(idx);
+                stack.push_back({entry.cube->children()[idx].get(),
+                                 {entry.position[0] + static_cast<GridCoordinate>(offset.x) * half_extent,
+                                  entry.position[1] + static_cast<GridCoordinate>(offset.y) * half_extent,
+                                  entry.position[2] + static_cast<GridCoordinate>(offset.z) * half_extent},
+                                 half_extent});
+            }
+            break;
+        }
+    }
+
+    // Faces of solid cubes which touch each other point in opposite directions at the same place, so both of them are
+    // hidden. Group the rows by plane and remove the faces which appear in both directions.
+    std::sort(rows.begin(), rows.end(), [](const FaceRow &lhs, const FaceRow &rhs) {
+        return std::tie(lhs.axis, lhs.plane, lhs.v, lhs.positive, lhs.span.begin) <
+               std::tie(rhs.axis, rhs.plane, rhs.v, rhs.positive, rhs.span.begin);
+    });
+    std::vector<FaceRow> visible_rows;
+    std::array<std::vector<Span>, 2> spans;
+    for (std::size_t first = 0; first < rows.size();) {
+        std::size_t last = first;
+        spans[0].clear();
+        spans[1].clear();
+        while (last < rows.size() && rows[last].axis == rows[first].axis && rows[last].plane == rows[first].plane &&
+               rows[last].v == rows[first].v) {
+            spans[rows[last].positive ? 1 : 0].push_back(rows[last].span);
+            last++;
+        }
+        const auto negative = merge_spans(spans[0]);
+        const auto positive = merge_spans(spans[1]);
+        for (const auto &span : subtract_spans(negative, positive)) {
+            visible_rows.push_back({rows[first].axis, false, rows[first].plane, rows[first].v, span});
+        }
+        for (const auto &span : subtract_spans(positive, negative)) {
+            visible_rows.push_back({rows[first].axis, true, rows[first].plane, rows[first].v, span});
+        }
+        first = last;
+    }
+    rows.clear();
+    rows.shrink_to_fit();
+
+    // Sort the rows of every slice by v, so the rectangles can grow from one row into the next.
+    std::sort(visible_rows.begin(), visible_rows.end(), [](const FaceRow &lhs, const FaceRow &rhs) {
+        return std::tie(lhs.axis, lhs.positive, lhs.plane, lhs.v, lhs.span.begin) <
+               std::tie(rhs.axis, rhs.positive, rhs.plane, rhs.v, rhs.span.begin);
+    });
+
+    const auto add_rectangle = [&](const FaceRow &slice, const Span &span, const GridCoordinate v_begin,
+                                   const GridCoordinate v_end) {
+        const auto u = static_cast<glm::vec3::length_type>((slice.axis + 1) % 3);
+        const auto v = static_cast<glm::vec3::length_type>((slice.axis + 2) % 3);
+        const auto corner = [&](const GridCoordinate u_coordinate, const GridCoordinate v_coordinate) {
+            glm::vec3 vertex = cube.position();
+            vertex[slice.axis] += static_cast<float>(slice.plane) * cell_size;
+            vertex[u] += static_cast<float>(u_coordinate) * cell_size;
+            vertex[v] += static_cast<float>(v_coordinate) * cell_size;
+            return vertex;
+        };
+        const glm::vec3 p00 = corner(span.begin, v_begin);
+        const glm::vec3 p10 = corner(span.end, v_begin);
+        const glm::vec3 p01 = corner(span.begin, v_end);
+        const glm::vec3 p11 = corner(span.end, v_end);
+        // The cross product of u and v points along the axis, pick the winding of the polygon cache.
+        if (slice.positive) {
+            polygons.push_back({{p00, p01, p10}});
+            polygons.push_back({{p10, p01, p11}});
+        } else {
+            polygons.push_back({{p00, p10, p01}});
+            polygons.push_back({{p10, p11, p01}});
+        }
+    };
+
+    struct Row {
+        GridCoordinate v;
+        std::vector<Span> spans;
+    };
+    std::vector<Row> slice_rows;
+    for (std::size_t first = 0; first < visible_rows.size();) {
+        const FaceRow &slice = visible_rows[first];
+        slice_rows.clear();
+        std::size_t last = first;
+        for (; last < visible_rows.size() && visible_rows[last].axis == slice.axis &&
+               visible_rows[last].positive == slice.positive && visible_rows[last].plane == slice.plane;
+             last++) {
+            if (slice_rows.empty() || slice_rows.back().v != visible_rows[last].v) {
+                slice_rows.push_back({visible_rows[last].v, {}});
+            }
+            slice_rows.back().spans.push_back(visible_rows[last].span);
+        }
+
+        // Take the widest span of a row and grow it along the following rows as long as they cover it. The covered
+        // part is cut out of the following rows, so every face ends up in exactly one rectangle.
+        for (std::size_t row = 0; row < slice_rows.size(); row++) {
+            for (const Span &span : slice_rows[row].spans) {
+                GridCoordinate v_end = slice_rows[row].v + 1;
+                for (std::size_t next = row + 1; next < slice_rows.size() && slice_rows[next].v == v_end; next++) {
+                    auto &next_spans = slice_rows[next].spans;
+                    auto covering = std::upper_bound(next_spans.begin(), next_spans.end(), span.begin,
+                                                     [](const GridCoordinate u, const Span &s) { return u < s.begin; });
+                    if (covering == next_spans.begin() || std::prev(covering)->end < span.end) {
+                        break;
+                    }
+                    covering = std::prev(covering);
+                    const Span before{covering->begin, span.begin};
+                    const Span after{span.end, covering->end};
+                    covering = next_spans.erase(covering);
+                    if (after.begin < after.end) {
+                        covering = next_spans.insert(covering, after);
+                    }
+                    if (before.begin < before.end) {
+                        next_spans.insert(covering, before);
+                    }
+                    v_end++;
+                }
+                add_rectangle(slice, span, slice_rows[row].v, v_end);
+            }
+        }
+        first = last;
+    }
+
+    polygons.insert(polygons.end(), normal_polygons.begin(), normal_polygons.end());
+    return polygons;
+}
+
+} // namespace inexor::vulkan_renderer::world
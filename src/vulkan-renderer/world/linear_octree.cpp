@@ -0,0 +1,349 @@
+#include "inexor/vulkan-renderer/world/linear_octree.hpp"
+
+#include "inexor/vulkan-renderer/exception.hpp"
+
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// Gather every third bit, starting with the least significant one, into the low bits of the result.
+std::uint32_t compact_every_third_bit(std::uint64_t bits) {
+    bits &= 0x1249249249249249ull;
+    bits = (bits ^ (bits >> 2u)) & 0x10c30c30c30c30c3ull;
+    bits = (bits ^ (bits >> 4u)) & 0x100f00f00f00f00full;
+    bits = (bits ^ (bits >> 8u)) & 0x1f0000ff0000ffull;
+    bits = (bits ^ (bits >> 16u)) & 0x1f00000000ffffull;
+    bits = (bits ^ (bits >> 32u)) & 0x1fffffull;
+    return static_cast<std::uint32_t>(bits);
+}
+
+} // namespace
+
+LinearOctree::LinearOctree(const float size, const glm::vec3 &position) : m_size(size), m_position(position) {}
+
+LinearOctree::LinearOctree(const Cube &cube) : LinearOctree(cube.size(), cube.position()) {
+    std::vector<std::pair<const Cube *, NodeId>> stack{{&cube, ROOT}};
+    while (!stack.empty()) {
+        const auto [source, id] = stack.back();
+        stack.pop_back();
+        set_type(id, source->type());
+        if (source->type() == Cube::Type::NORMAL) {
+            m_nodes[id].indentations = source->m_indentations;
+        } else if (source->type() == Cube::Type::OCTANT) {
+            const NodeId first_child = m_nodes[id].children;
+            source->apply_pending_rotation();
+            for (std::uint8_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+                stack.emplace_back(source->m_children[idx].get(), first_child + idx);
+            }
+        }
+    }
+    m_nodes.shrink_to_fit();
+}
+
+std::shared_ptr<Cube> LinearOctree::to_cube() const {
+    auto root = std::make_shared<Cube>(m_size, m_position);
+    std::vector<std::pair<NodeId, Cube *>> stack{{ROOT, root.get()}};
+    while (!stack.empty()) {
+        const auto [id, target] = stack.back();
+        stack.pop_back();
+        const Node &node = m_nodes[id];
+        target->set_type(node.type);
+        if (node.type == Cube::Type::NORMAL) {
+            target->m_indentations = node.indentations;
+        } else if (node.type == Cube::Type::OCTANT) {
+            for (std::uint8_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+                stack.emplace_back(node.children + idx, target->m_children[idx].get());
+            }
+        }
+    }
+    return root;
+}
+
+LinearOctree::NodeId LinearOctree::allocate_children(const NodeId parent) {
+    assert(grid_level(parent) < MAX_DEPTH && "Octree too deep!");
+    NodeId first_child{0};
+    if (!m_free_blocks.empty()) {
+        first_child = m_free_blocks.back();
+        m_free_blocks.pop_back();
+    } else {
+        assert(m_nodes.size() + Cube::SUB_CUBES < INVALID_NODE && "Octree too big!");
+        first_child = static_cast<NodeId>(m_nodes.size());
+        m_nodes.resize(m_nodes.size() + Cube::SUB_CUBES);
+    }
+    const std::uint64_t parent_code = m_nodes[parent].locational_code;
+    for (std::size_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+        m_nodes[first_child + idx] = Node{.locational_code = (parent_code << 3u) | idx, .parent = parent};
+    }
+    return first_child;
+}
+
+void LinearOctree::release_children(const NodeId id) {
+    const NodeId first_child = m_nodes[id].children;
+    if (first_child == INVALID_NODE) {
+        return;
+    }
+    for (std::size_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+        release_children(first_child + static_cast<NodeId>(idx));
+    }
+    m_nodes[id].children = INVALID_NODE;
+    m_free_blocks.push_back(first_child);
+}
+
+template <int Rotations>
+void LinearOctree::rotate(const NodeId id, const Cube::RotationAxis::Type &axis) {
+    Node &node = m_nodes[id];
+    if (node.type == Cube::Type::NORMAL) {
+        Cube::rotate_indentations<Rotations>(node.indentations, axis);
+        return;
+    }
+    if (node.type != Cube::Type::OCTANT) {
+        return;
+    }
+    const NodeId first_child = node.children;
+    std::array<Node, Cube::SUB_CUBES> children;
+    std::copy_n(m_nodes.begin() + first_child, Cube::SUB_CUBES, children.begin());
+    Cube::rotate_children<Rotations>(children, axis);
+    std::copy(children.begin(), children.end(), m_nodes.begin() + first_child);
+
+    for (NodeId child = first_child; child < first_child + Cube::SUB_CUBES; child++) {
+        // The nodes were moved to other slots and take over their codes, the recursion updates the codes below them.
+        m_nodes[child].locational_code = (node.locational_code << 3u) | (child - first_child);
+        // The grandchildren have to point to the new slot of their parent.
+        if (m_nodes[child].type == Cube::Type::OCTANT) {
+            for (std::size_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+                m_nodes[m_nodes[child].children + idx].parent = child;
+            }
+        }
+        rotate<Rotations>(child, axis);
+    }
+}
+
+std::size_t LinearOctree::node_count() const noexcept {
+    return m_nodes.size() - m_free_blocks.size() * Cube::SUB_CUBES;
+}
+
+std::size_t LinearOctree::memory_usage() const noexcept {
+    return sizeof(LinearOctree) + m_nodes.capacity() * sizeof(Node) + m_free_blocks.capacity() * sizeof(NodeId);
+}
+
+LinearOctree::NodeId LinearOctree::child(const NodeId id, const std::size_t idx) const {
+    assert(idx < Cube::SUB_CUBES);
+    const Node &node = m_nodes[id];
+    return node.type == Cube::Type::OCTANT ? node.children + static_cast<NodeId>(idx) : INVALID_NODE;
+}
+
+LinearOctree::NodeId LinearOctree::parent(const NodeId id) const {
+    return m_nodes[id].parent;
+}
+
+std::uint8_t LinearOctree::index_in_parent(const NodeId id) const noexcept {
+    // Blocks of children start right after the root, so every block starts at a multiple of eight plus one.
+    return static_cast<std::uint8_t>((id - 1) % Cube::SUB_CUBES);
+}
+
+bool LinearOctree::is_root(const NodeId id) const noexcept {
+    return id == ROOT;
+}
+
+std::size_t LinearOctree::grid_level(const NodeId id) const {
+    return static_cast<std::size_t>(std::bit_width(m_nodes[id].locational_code) - 1) / 3;
+}
+
+std::uint64_t LinearOctree::locational_code(const NodeId id) const {
+    return m_nodes[id].locational_code;
+}
+
+std::size_t LinearOctree::count_geometry_cubes(const NodeId id) const {
+    std::size_t count = 0;
+    std::vector<NodeId> stack{id};
+    while (!stack.empty()) {
+        const Node &node = m_nodes[stack.back()];
+        stack.pop_back();
+        if (node.type == Cube::Type::SOLID || node.type == Cube::Type::NORMAL) {
+            count++;
+        } else if (node.type == Cube::Type::OCTANT) {
+            for (std::size_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+                stack.push_back(node.children + static_cast<NodeId>(idx));
+            }
+        }
+    }
+    return count;
+}
+
+glm::vec3 LinearOctree::position(const NodeId id) const {
+    // Without the leading one bit, the code interleaves the x, y and z bits of the child indices of all levels, so
+    // every third bit is one bit of the grid coordinate in units of the node size.
+    const std::uint64_t path = m_nodes[id].locational_code ^ (std::uint64_t{1} << (3 * grid_level(id)));
+    const glm::vec3 grid_position{static_cast<float>(compact_every_third_bit(path >> 2u)),
+                                  static_cast<float>(compact_every_third_bit(path >> 1u)),
+                                  static_cast<float>(compact_every_third_bit(path))};
+    return m_position + grid_position * size(id);
+}
+
+float LinearOctree::size(const NodeId id) const {
+    return std::ldexp(m_size, -static_cast<int>(grid_level(id)));
+}
+
+glm::vec3 LinearOctree::center(const NodeId id) const {
+    return position(id) + 0.5f * size(id);
+}
+
+std::array<glm::vec3, 2> LinearOctree::bounding_box(const NodeId id) const {
+    const glm::vec3 min = position(id);
+    const float node_size = size(id);
+    return {min, {min.x + node_size, min.y + node_size, min.z + node_size}};
+}
+
+void LinearOctree::set_type(const NodeId id, const Cube::Type new_type) {
+    if (m_nodes[id].type == new_type) {
+        return;
+    }
+    if (new_type == Cube::Type::OCTANT && grid_level(id) >= MAX_DEPTH) {
+        throw InexorException("Octree too deep");
+    }
+    if (m_nodes[id].type == Cube::Type::OCTANT) {
+        release_children(id);
+    }
+    switch (new_type) {
+    case Cube::Type::EMPTY:
+    case Cube::Type::SOLID:
+        break;
+    case Cube::Type::NORMAL:
+        m_nodes[id].indentations = {};
+        break;
+    case Cube::Type::OCTANT:
+        // The pool may grow, so do not keep a reference to the node across this call.
+        const NodeId first_child = allocate_children(id);
+        m_nodes[id].children = first_child;
+        break;
+    }
+    m_nodes[id].type = new_type;
+}
+
+Cube::Type LinearOctree::type(const NodeId id) const {
+    return m_nodes[id].type;
+}
+
+const std::array<Indentation, Cube::EDGES> &LinearOctree::indentations(const NodeId id) const {
+    return m_nodes[id].indentations;
+}
+
+void LinearOctree::set_indent(const NodeId id, const std::uint8_t edge_id, const Indentation indentation) {
+    if (m_nodes[id].type != Cube::Type::NORMAL) {
+        return;
+    }
+    assert(edge_id < Cube::EDGES);
+    m_nodes[id].indentations[edge_id] = indentation;
+}
+
+void LinearOctree::indent(const NodeId id, const std::uint8_t edge_id, const bool positive_direction,
+                          const std::uint8_t steps) {
+    if (m_nodes[id].type != Cube::Type::NORMAL) {
+        return;
+    }
+    assert(edge_id < Cube::EDGES);
+    if (positive_direction) {
+        m_nodes[id].indentations[edge_id].indent_start(steps);
+    } else {
+        m_nodes[id].indentations[edge_id].indent_end(steps);
+    }
+}
+
+void LinearOctree::rotate(const NodeId id, const Cube::RotationAxis::Type &axis, int rotations) {
+    rotations = ((rotations % 4) + 4) % 4;
+    switch (rotations) {
+    case 1:
+        rotate<1>(id, axis);
+        break;
+    case 2:
+        rotate<2>(id, axis);
+        break;
+    case 3:
+        rotate<3>(id, axis);
+        break;
+    default:
+        break;
+    }
+}
+
+CubePolygons LinearOctree::triangles(const NodeId id) const {
+    const Node &node = m_nodes[id];
+    assert(node.type == Cube::Type::SOLID || node.type == Cube::Type::NORMAL);
+    return Cube::triangulate(node.type, position(id), size(id), node.indentations);
+}
+
+std::vector<Polygon> LinearOctree::polygons(const NodeId id) const {
+    struct Entry {
+        NodeId id;
+        glm::vec3 position;
+        float size;
+    };
+
+    std::vector<Polygon> polygons;
+    polygons.reserve(count_geometry_cubes(id) * 12);
+
+    // Visit the children in ascending order, so the result matches Cube::polygons.
+    std::vector<Entry> stack{{id, position(id), size(id)}};
+    while (!stack.empty()) {
+        const Entry entry = stack.back();
+        stack.pop_back();
+        const Node &node = m_nodes[entry.id];
+        if (node.type == Cube::Type::OCTANT) {
+            const float half_size = entry.size / 2;
+            for (std::uint8_t idx = Cube::SUB_CUBES; idx-- > 0;) {
+                stack.push_back({node.children + idx, entry.position + Cube::child_offset(idx) * half_size, half_size});
+            }
+            continue;
+        }
+        if (node.type == Cube::Type::SOLID || node.type == Cube::Type::NORMAL) {
+            const auto cube_polygons = Cube::triangulate(node.type, entry.position, entry.size, node.indentations);
+            polygons.insert(polygons.end(), cube_polygons.begin(), cube_polygons.end());
+        }
+    }
+    return polygons;
+}
+
+LinearOctree::NodeId LinearOctree::neighbor(const NodeId id, const Cube::NeighborAxis axis,
+                                            const Cube::NeighborDirection direction) const {
+    // Each axis only requires information and manipulation of one (relevant) bit to find the neighbor.
+    const auto relevant_index_bit = static_cast<std::uint8_t>(axis);
+    const bool positive = direction == Cube::NeighborDirection::POSITIVE;
+
+    // Climb up until the neighbor in the requested direction is a sibling and keep the history of indices, because
+    // we just need to mirror them (i.e. toggle the relevant bit) to walk down to the neighbor.
+    std::array<std::uint8_t, MAX_DEPTH> history{};
+    std::size_t depth = 0;
+    NodeId current = id;
+    while (true) {
+        if (is_root(current)) {
+            return INVALID_NODE;
+        }
+        const std::uint8_t index = index_in_parent(current);
+        assert(depth < MAX_DEPTH);
+        history[depth++] = index;
+        if ((((index >> relevant_index_bit) & 1u) != 0) != positive) {
+            break;
+        }
+        current = m_nodes[current].parent;
+    }
+
+    // Now walk down from the first mutual parent of the neighbor and the node.
+    NodeId node = m_nodes[current].parent;
+    while (depth > 0) {
+        if (m_nodes[node].type != Cube::Type::OCTANT) {
+            // The neighbor is larger but still a neighbor!
+            return node;
+        }
+        node = m_nodes[node].children + (history[--depth] ^ (1u << relevant_index_bit));
+    }
+
+    // We found a same-sized neighbor!
+    return node;
+}
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,254 @@
+#include "inexor/vulkan-renderer/world/normal_cube_batch.hpp"
+
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+
+#include <cassert>
+
+#if defined(__AVX__)
+#define INEXOR_NORMAL_CUBE_BATCH_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define INEXOR_NORMAL_CUBE_BATCH_SSE
+#include <emmintrin.h>
+#endif
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// The edges which indent every coordinate of every corner, see Cube::vertices().
+constexpr std::array<std::array<std::uint8_t, 3>, 8> CORNER_EDGES{{
+    {0, 1, 2},
+    {9, 4, 2},
+    {3, 1, 11},
+    {6, 4, 11},
+    {0, 10, 5},
+    {9, 7, 5},
+    {3, 10, 8},
+    {6, 7, 8},
+}};
+
+/// The edges of every face, whose diagonal is flipped if the sum of the first two indentations is less than the sum
+/// of the last two. The start of the edges is used for the faces at 0, the end for the faces at 1.
+constexpr std::array<std::array<std::uint8_t, 4>, 6> FACE_EDGES{{
+    {0, 6, 9, 3},
+    {0, 6, 9, 3},
+    {1, 7, 4, 10},
+    {1, 7, 4, 10},
+    {2, 8, 11, 5},
+    {2, 8, 11, 5},
+}};
+
+struct ScalarLanes {
+    using Float = float;
+    static constexpr std::size_t WIDTH{1};
+
+    static Float load(const float *source) {
+        return *source;
+    }
+    static void store(float *destination, const Float value) {
+        *destination = value;
+    }
+    static Float add(const Float lhs, const Float rhs) {
+        return lhs + rhs;
+    }
+    static Float sub(const Float lhs, const Float rhs) {
+        return lhs - rhs;
+    }
+    static Float mul(const Float lhs, const Float rhs) {
+        return lhs * rhs;
+    }
+    /// One bit per lane.
+    static std::uint32_t less(const Float lhs, const Float rhs) {
+        return lhs < rhs ? 1u : 0u;
+    }
+};
+
+#if defined(INEXOR_NORMAL_CUBE_BATCH_AVX)
+struct SimdLanes {
+    using Float = __m256;
+    static constexpr std::size_t WIDTH{8};
+
+    static Float load(const float *source) {
+        return _mm256_loadu_ps(source);
+    }
+    static void store(float *destination, const Float value) {
+        _mm256_storeu_ps(destination, value);
+    }
+    static Float add(const Float lhs, const Float rhs) {
+        return _mm256_add_ps(lhs, rhs);
+    }
+    static Float sub(const Float lhs, const Float rhs) {
+        return _mm256_sub_ps(lhs, rhs);
+    }
+    static Float mul(const Float lhs, const Float rhs) {
+        return _mm256_mul_ps(lhs, rhs);
+    }
+    static std::uint32_t less(const Float lhs, const Float rhs) {
+        return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(lhs, rhs, _CMP_LT_OQ)));
+    }
+};
+#elif defined(INEXOR_NORMAL_CUBE_BATCH_SSE)
+struct SimdLanes {
+    using Float = __m128;
+    static constexpr std::size_t WIDTH{4};
+
+    static Float load(const float *source) {
+        return _mm_loadu_ps(source);
+    }
+    static void store(float *destination, const Float value) {
+        _mm_storeu_ps(destination, value);
+    }
+    static Float add(const Float lhs, const Float rhs) {
+        return _mm_add_ps(lhs, rhs);
+    }
+    static Float sub(const Float lhs, const Float rhs) {
+        return _mm_sub_ps(lhs, rhs);
+    }
+    static Float mul(const Float lhs, const Float rhs) {
+        return _mm_mul_ps(lhs, rhs);
+    }
+    static std::uint32_t less(const Float lhs, const Float rhs) {
+        return static_cast<std::uint32_t>(_mm_movemask_ps(_mm_cmplt_ps(lhs, rhs)));
+    }
+};
+#else
+using SimdLanes = ScalarLanes;
+#endif
+
+/// The arrays of a batch which are read and written by the kernel.
+struct BatchArrays {
+    const std::array<std::vector<float>, 3> &positions;
+    const std::vector<float> &sizes;
+    const std::vector<float> &steps;
+    const std::array<std::vector<float>, Cube::EDGES> &starts;
+    const std::array<std::vector<float>, Cube::EDGES> &ends;
+    std::array<std::vector<float>, NormalCubeBatch::CORNER_COORDINATES> &corners;
+    std::vector<std::uint8_t> &face_splits;
+};
+
+/// Compute the cubes first to last, Lanes::WIDTH at a time. The number of cubes must be a multiple of the width.
+template <typename Lanes>
+void compute_lanes(BatchArrays &arrays, const std::size_t first, const std::size_t last) {
+    using Float = typename Lanes::Float;
+    for (std::size_t idx = first; idx < last; idx += Lanes::WIDTH) {
+        const Float size = Lanes::load(&arrays.sizes[idx]);
+        const Float step = Lanes::load(&arrays.steps[idx]);
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            const Float min = Lanes::load(&arrays.positions[axis][idx]);
+            const Float max = Lanes::add(min, size);
+            for (std::size_t corner = 0; corner < CORNER_EDGES.size(); corner++) {
+                const std::uint8_t edge = CORNER_EDGES[corner][axis];
+                // The bits of the corner index are x, y and z, from the most significant one.
+                const Float coordinate =
+                    ((corner >> (2 - axis)) & 1u) == 0
+                        ? Lanes::add(min, Lanes::mul(Lanes::load(&arrays.starts[edge][idx]), step))
+                        : Lanes::sub(max, Lanes::mul(Lanes::load(&arrays.ends[edge][idx]), step));
+                Lanes::store(&arrays.corners[corner * 3 + axis][idx], coordinate);
+            }
+        }
+        std::array<std::uint32_t, FACE_EDGES.size()> masks{};
+        for (std::size_t face = 0; face < FACE_EDGES.size(); face++) {
+            const auto &indentations = face % 2 == 0 ? arrays.starts : arrays.ends;
+            const auto &[a, b, c, d] = FACE_EDGES[face];
+            masks[face] = Lanes::less(
+                Lanes::add(Lanes::load(&indentations[a][idx]), Lanes::load(&indentations[b][idx])),
+                Lanes::add(Lanes::load(&indentations[c][idx]), Lanes::load(&indentations[d][idx])));
+        }
+        for (std::size_t lane = 0; lane < Lanes::WIDTH; lane++) {
+            std::uint8_t splits = 0;
+            for (std::size_t face = 0; face < FACE_EDGES.size(); face++) {
+                splits |= static_cast<std::uint8_t>(((masks[face] >> lane) & 1u) << face);
+            }
+            arrays.face_splits[idx + lane] = splits;
+        }
+    }
+}
+
+} // namespace
+
+std::size_t NormalCubeBatch::lanes() noexcept {
+    return SimdLanes::WIDTH;
+}
+
+void NormalCubeBatch::reserve(const std::size_t size) {
+    for (auto &coordinates : m_positions) {
+        coordinates.reserve(size);
+    }
+    m_sizes.reserve(size);
+    m_steps.reserve(size);
+    for (std::size_t edge = 0; edge < Cube::EDGES; edge++) {
+        m_starts[edge].reserve(size);
+        m_ends[edge].reserve(size);
+    }
+}
+
+void NormalCubeBatch::clear() noexcept {
+    for (auto &coordinates : m_positions) {
+        coordinates.clear();
+    }
+    m_sizes.clear();
+    m_steps.clear();
+    for (std::size_t edge = 0; edge < Cube::EDGES; edge++) {
+        m_starts[edge].clear();
+        m_ends[edge].clear();
+    }
+}
+
+void NormalCubeBatch::add(const Cube &cube) {
+    add(std::span<const Cube *const>(std::array<const Cube *, 1>{&cube}));
+}
+
+void NormalCubeBatch::add(const std::span<const Cube *const> cubes) {
+    // The arrays are resized once and filled by index, instead of appending to every array for every cube.
+    const std::size_t first = size();
+    for (auto &coordinates : m_positions) {
+        coordinates.resize(first + cubes.size());
+    }
+    m_sizes.resize(first + cubes.size());
+    m_steps.resize(first + cubes.size());
+    for (std::size_t edge = 0; edge < Cube::EDGES; edge++) {
+        m_starts[edge].resize(first + cubes.size());
+        m_ends[edge].resize(first + cubes.size());
+    }
+    for (std::size_t offset = 0; offset < cubes.size(); offset++) {
+        const Cube &cube = *cubes[offset];
+        const std::size_t idx = first + offset;
+        assert(cube.type() == Cube::Type::NORMAL);
+        for (glm::vec3::length_type axis = 0; axis < 3; axis++) {
+            m_positions[axis][idx] = cube.m_position[axis];
+        }
+        m_sizes[idx] = cube.m_size;
+        m_steps[idx] = cube.m_size / Indentation::MAX;
+        for (std::size_t edge = 0; edge < Cube::EDGES; edge++) {
+            m_starts[edge][idx] = static_cast<float>(cube.m_indentations[edge].start());
+            m_ends[edge][idx] = static_cast<float>(cube.m_indentations[edge].end());
+        }
+    }
+}
+
+void NormalCubeBatch::compute() {
+    for (auto &coordinates : m_corners) {
+        coordinates.resize(size());
+    }
+    m_face_splits.resize(size());
+    BatchArrays arrays{m_positions, m_sizes, m_steps, m_starts, m_ends, m_corners, m_face_splits};
+    // The cubes which don't fill all lanes are computed by the scalar kernel.
+    const std::size_t simd_size = size() - size() % SimdLanes::WIDTH;
+    compute_lanes<SimdLanes>(arrays, 0, simd_size);
+    compute_lanes<ScalarLanes>(arrays, simd_size, size());
+}
+
+std::array<glm::vec3, 8> NormalCubeBatch::vertices(const std::size_t idx) const {
+    std::array<glm::vec3, 8> vertices;
+    for (std::size_t corner = 0; corner < vertices.size(); corner++) {
+        vertices[corner] = {m_corners[corner * 3][idx], m_corners[corner * 3 + 1][idx], m_corners[corner * 3 + 2][idx]};
+    }
+    return vertices;
+}
+
+CubePolygons NormalCubeBatch::polygons(const std::size_t idx) const {
+    return Cube::triangulate(vertices(idx), face_splits(idx));
+}
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,75 @@
+#include "inexor/vulkan-renderer/world/octree_snapshot.hpp"
+
+#include <cassert>
+#include <utility>
+
+namespace inexor::vulkan_renderer::world {
+
+OctreeSnapshot::OctreeSnapshot(std::shared_ptr<const SnapshotNode> root, const float size, const glm::vec3 &position)
+    : m_root(std::move(root)), m_size(size), m_position(position) {
+    assert(m_root != nullptr);
+}
+
+void OctreeSnapshot::restore(const std::shared_ptr<const SnapshotNode> &node, Cube &cube, PolygonArena &arena) {
+    cube.set_type(node->type);
+    if (node->type == Cube::Type::OCTANT) {
+        // The children are restored in their slots, so a rotation of the octant since the snapshot has to be applied.
+        cube.apply_pending_rotation();
+        const std::size_t first = arena.size();
+        for (std::size_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+            cube.m_children[idx]->m_polygon_offset = arena.size() - first;
+            restore(node->children[idx], *cube.m_children[idx], arena);
+        }
+    } else if (node->type != Cube::Type::EMPTY) {
+        cube.m_indentations = node->indentations;
+        arena.insert(arena.end(), node->polygons->begin(), node->polygons->end());
+        cube.m_polygon_cache_valid = true;
+    }
+    // The edits of the children released the node of their parent, so it is set last.
+    cube.m_snapshot = node;
+}
+
+std::size_t OctreeSnapshot::count_geometry_cubes() const {
+    std::size_t count = 0;
+    std::vector<const SnapshotNode *> stack{m_root.get()};
+    while (!stack.empty()) {
+        const SnapshotNode *node = stack.back();
+        stack.pop_back();
+        if (node->type == Cube::Type::OCTANT) {
+            for (const auto &child : node->children) {
+                stack.push_back(child.get());
+            }
+        } else if (node->type != Cube::Type::EMPTY) {
+            count++;
+        }
+    }
+    return count;
+}
+
+std::vector<PolygonCache> OctreeSnapshot::polygons() const {
+    std::vector<PolygonCache> polygons;
+    std::vector<const SnapshotNode *> stack{m_root.get()};
+    while (!stack.empty()) {
+        const SnapshotNode *node = stack.back();
+        stack.pop_back();
+        if (node->type == Cube::Type::OCTANT) {
+            // Reversed, so the children are visited in ascending order.
+            for (auto child = node->children.rbegin(); child != node->children.rend(); ++child) {
+                stack.push_back(child->get());
+            }
+        } else if (node->type != Cube::Type::EMPTY) {
+            polygons.push_back(node->polygons);
+        }
+    }
+    return polygons;
+}
+
+std::shared_ptr<Cube> OctreeSnapshot::to_cube() const {
+    auto cube = std::make_shared<Cube>(m_size, m_position);
+    auto arena = std::make_unique<PolygonArena>();
+    restore(m_root, *cube, *arena);
+    cube->m_polygon_arena = std::move(arena);
+    return cube;
+}
+
+} // namespace inexor::vulkan_renderer::world
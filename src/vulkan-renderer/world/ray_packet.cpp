@@ -0,0 +1,396 @@
+#include "inexor/vulkan-renderer/world/ray_packet.hpp"
+
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
+#include "inexor/vulkan-renderer/world/collision_query.hpp"
+#include "inexor/vulkan-renderer/world/cube.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <limits>
+
+#if defined(__AVX__)
+#define INEXOR_RAY_PACKET_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define INEXOR_RAY_PACKET_SSE
+#include <emmintrin.h>
+#endif
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+constexpr float INFINITE_DISTANCE{std::numeric_limits<float>::infinity()};
+
+#if defined(INEXOR_RAY_PACKET_AVX)
+struct PacketLanes {
+    using Float = __m256;
+    static constexpr std::size_t WIDTH{8};
+
+    static Float load(const float *source) {
+        return _mm256_loadu_ps(source);
+    }
+    static void store(float *destination, const Float value) {
+        _mm256_storeu_ps(destination, value);
+    }
+    static Float set(const float value) {
+        return _mm256_set1_ps(value);
+    }
+    static Float sub(const Float lhs, const Float rhs) {
+        return _mm256_sub_ps(lhs, rhs);
+    }
+    static Float mul(const Float lhs, const Float rhs) {
+        return _mm256_mul_ps(lhs, rhs);
+    }
+    static Float min(const Float lhs, const Float rhs) {
+        return _mm256_min_ps(lhs, rhs);
+    }
+    static Float max(const Float lhs, const Float rhs) {
+        return _mm256_max_ps(lhs, rhs);
+    }
+    /// All bits of a lane are set if the comparison is true.
+    static Float less(const Float lhs, const Float rhs) {
+        return _mm256_cmp_ps(lhs, rhs, _CMP_LT_OQ);
+    }
+    static Float less_equal(const Float lhs, const Float rhs) {
+        return _mm256_cmp_ps(lhs, rhs, _CMP_LE_OQ);
+    }
+    static Float equal(const Float lhs, const Float rhs) {
+        return _mm256_cmp_ps(lhs, rhs, _CMP_EQ_OQ);
+    }
+    static Float bitwise_and(const Float lhs, const Float rhs) {
+        return _mm256_and_ps(lhs, rhs);
+    }
+    /// The lanes of lhs of which mask is set, the ones of rhs otherwise.
+    static Float select(const Float mask, const Float lhs, const Float rhs) {
+        return _mm256_blendv_ps(rhs, lhs, mask);
+    }
+    /// One bit per lane.
+    static std::uint32_t bits(const Float mask) {
+        return static_cast<std::uint32_t>(_mm256_movemask_ps(mask));
+    }
+};
+#elif defined(INEXOR_RAY_PACKET_SSE)
+struct PacketLanes {
+    using Float = __m128;
+    static constexpr std::size_t WIDTH{4};
+
+    static Float load(const float *source) {
+        return _mm_loadu_ps(source);
+    }
+    static void store(float *destination, const Float value) {
+        _mm_storeu_ps(destination, value);
+    }
+    static Float set(const float value) {
+        return _mm_set1_ps(value);
+    }
+    static Float sub(const Float lhs, const Float rhs) {
+        return _mm_sub_ps(lhs, rhs);
+    }
+    static Float mul(const Float lhs, const Float rhs) {
+        return _mm_mul_ps(lhs, rhs);
+    }
+    static Float min(const Float lhs, const Float rhs) {
+        return _mm_min_ps(lhs, rhs);
+    }
+    static Float max(const Float lhs, const Float rhs) {
+        return _mm_max_ps(lhs, rhs);
+    }
+    static Float less(const Float lhs, const Float rhs) {
+        return _mm_cmplt_ps(lhs, rhs);
+    }
+    static Float less_equal(const Float lhs, const Float rhs) {
+        return _mm_cmple_ps(lhs, rhs);
+    }
+    static Float equal(const Float lhs, const Float rhs) {
+        return _mm_cmpeq_ps(lhs, rhs);
+    }
+    static Float bitwise_and(const Float lhs, const Float rhs) {
+        return _mm_and_ps(lhs, rhs);
+    }
+    static Float select(const Float mask, const Float lhs, const Float rhs) {
+        // SSE2 has no blend instruction.
+        return _mm_or_ps(_mm_and_ps(mask, lhs), _mm_andnot_ps(mask, rhs));
+    }
+    static std::uint32_t bits(const Float mask) {
+        return static_cast<std::uint32_t>(_mm_movemask_ps(mask));
+    }
+};
+#else
+/// Without SIMD, a packet is a single ray and a mask is -1 or 0.
+struct PacketLanes {
+    using Float = float;
+    static constexpr std::size_t WIDTH{1};
+
+    static Float load(const float *source) {
+        return *source;
+    }
+    static void store(float *destination, const Float value) {
+        *destination = value;
+    }
+    static Float set(const float value) {
+        return value;
+    }
+    static Float sub(const Float lhs, const Float rhs) {
+        return lhs - rhs;
+    }
+    static Float mul(const Float lhs, const Float rhs) {
+        return lhs * rhs;
+    }
+    // The same operand order as minps and maxps, which return rhs if either is NaN.
+    static Float min(const Float lhs, const Float rhs) {
+        return lhs < rhs ? lhs : rhs;
+    }
+    static Float max(const Float lhs, const Float rhs) {
+        return lhs > rhs ? lhs : rhs;
+    }
+    static Float mask(const bool value) {
+        return value ? -1.0f : 0.0f;
+    }
+    static Float less(const Float lhs, const Float rhs) {
+        return mask(lhs < rhs);
+    }
+    static Float less_equal(const Float lhs, const Float rhs) {
+        return mask(lhs <= rhs);
+    }
+    static Float equal(const Float lhs, const Float rhs) {
+        return mask(lhs == rhs);
+    }
+    static Float bitwise_and(const Float lhs, const Float rhs) {
+        return mask(lhs != 0.0f && rhs != 0.0f);
+    }
+    static Float select(const Float mask, const Float lhs, const Float rhs) {
+        return mask != 0.0f ? lhs : rhs;
+    }
+    static std::uint32_t bits(const Float mask) {
+        return mask != 0.0f ? 1u : 0u;
+    }
+};
+#endif
+
+using Float = PacketLanes::Float;
+constexpr std::size_t PACKET_SIZE{PacketLanes::WIDTH};
+
+/// A cube on the traversal stack, with the remaining depth.
+struct Frame {
+    const Cube *cube;
+    std::optional<std::uint32_t> max_depth;
+};
+
+/// The rays of a packet, as one lane per ray.
+/// The vector types are kept in plain arrays, std::array would drop their alignment attributes.
+struct RayPacket {
+    Float positions[3];          // NOLINT
+    Float inverse_directions[3]; // NOLINT
+    /// The lanes whose direction is zero along an axis, which never cross the slabs of the axis.
+    Float parallel[3]; // NOLINT
+    /// Whether any lane is parallel to an axis, so the slab test only handles them if needed.
+    std::array<bool, 3> any_parallel;
+    /// The distance of the nearest hit so far, the lanes without a ray are -infinity so they never enter a cube.
+    Float nearest;
+    std::array<const Cube *, PACKET_SIZE> cubes;
+    /// The rays of the packet, for the triangle tests which are done one ray at a time.
+    std::span<const glm::vec3> position_vectors;
+    std::span<const glm::vec3> direction_vectors;
+
+    RayPacket(std::span<const glm::vec3> positions, std::span<const glm::vec3> directions);
+};
+
+RayPacket::RayPacket(const std::span<const glm::vec3> ray_positions, const std::span<const glm::vec3> directions)
+    : position_vectors(ray_positions), direction_vectors(directions) {
+    assert(ray_positions.size() <= PACKET_SIZE);
+    // The lanes without a ray repeat the first ray, so they don't produce NaN. They never enter a cube, neither do
+    // rays without a direction, like in ray_cube_collision_check().
+    std::array<std::array<float, PACKET_SIZE>, 3> position_lanes;
+    std::array<std::array<float, PACKET_SIZE>, 3> direction_lanes;
+    std::array<float, PACKET_SIZE> nearest_lanes;
+    for (std::size_t lane = 0; lane < PACKET_SIZE; lane++) {
+        const std::size_t ray = lane < ray_positions.size() ? lane : 0;
+        for (glm::vec3::length_type axis = 0; axis < 3; axis++) {
+            position_lanes[axis][lane] = ray_positions[ray][axis];
+            direction_lanes[axis][lane] = directions[ray][axis];
+        }
+        const bool valid = lane < ray_positions.size() && directions[ray] != glm::vec3(0.0f);
+        nearest_lanes[lane] = valid ? INFINITE_DISTANCE : -INFINITE_DISTANCE;
+    }
+    const Float zero = PacketLanes::set(0.0f);
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        positions[axis] = PacketLanes::load(position_lanes[axis].data());
+        const Float direction = PacketLanes::load(direction_lanes[axis].data());
+        parallel[axis] = PacketLanes::equal(direction, zero);
+        any_parallel[axis] = PacketLanes::bits(parallel[axis]) != 0;
+        // The slab test overwrites the lanes which are parallel, their inverse direction is never used.
+        std::array<float, PACKET_SIZE> inverse_lanes;
+        for (std::size_t lane = 0; lane < PACKET_SIZE; lane++) {
+            inverse_lanes[lane] = direction_lanes[axis][lane] != 0.0f ? 1.0f / direction_lanes[axis][lane] : 0.0f;
+        }
+        inverse_directions[axis] = PacketLanes::load(inverse_lanes.data());
+    }
+    nearest = PacketLanes::load(nearest_lanes.data());
+    cubes.fill(nullptr);
+}
+
+/// @brief Test all rays of a packet against the slabs of a box at once.
+/// @param entry The distance at which every ray enters the box, at least 0.
+/// @return The lanes whose ray enters the box before its nearest hit so far.
+Float enter_box(const RayPacket &packet, const std::array<glm::vec3, 2> &box_bounds, Float &entry) {
+    const Float infinity = PacketLanes::set(INFINITE_DISTANCE);
+    const Float negative_infinity = PacketLanes::set(-INFINITE_DISTANCE);
+    Float near = PacketLanes::set(0.0f);
+    Float far = packet.nearest;
+    for (glm::vec3::length_type axis = 0; axis < 3; axis++) {
+        const Float min = PacketLanes::set(box_bounds[0][axis]);
+        const Float max = PacketLanes::set(box_bounds[1][axis]);
+        const Float inverse_direction = packet.inverse_directions[axis];
+        const Float t0 = PacketLanes::mul(PacketLanes::sub(min, packet.positions[axis]), inverse_direction);
+        const Float t1 = PacketLanes::mul(PacketLanes::sub(max, packet.positions[axis]), inverse_direction);
+        Float axis_near = PacketLanes::min(t0, t1);
+        Float axis_far = PacketLanes::max(t0, t1);
+        if (packet.any_parallel[axis]) {
+            // A ray which runs parallel to the slabs is inside of them all along or never.
+            const Float inside = PacketLanes::bitwise_and(PacketLanes::less_equal(min, packet.positions[axis]),
+                                                          PacketLanes::less_equal(packet.positions[axis], max));
+            axis_near = PacketLanes::select(packet.parallel[axis],
+                                            PacketLanes::select(inside, negative_infinity, infinity), axis_near);
+            axis_far = PacketLanes::select(packet.parallel[axis],
+                                           PacketLanes::select(inside, infinity, negative_infinity), axis_far);
+        }
+        near = PacketLanes::max(near, axis_near);
+        far = PacketLanes::min(far, axis_far);
+    }
+    entry = near;
+    return PacketLanes::less_equal(near, far);
+}
+
+/// @brief Test the rays of a packet against the triangles of a Type::NORMAL cube, one ray at a time.
+/// @param candidates The lanes whose ray enters the cube before its nearest hit so far.
+void hit_triangles(const Cube &cube, RayPacket &packet, const Float candidates) {
+    std::uint32_t lanes = PacketLanes::bits(candidates);
+    if (lanes == 0) {
+        return;
+    }
+    const CubePolygons triangles = cube.triangles();
+    std::array<float, PACKET_SIZE> nearest;
+    PacketLanes::store(nearest.data(), packet.nearest);
+    for (; lanes != 0; lanes &= lanes - 1) {
+        const auto lane = static_cast<std::size_t>(std::countr_zero(lanes));
+        const auto hit =
+            ray_triangles_collision(triangles, packet.position_vectors[lane], packet.direction_vectors[lane]);
+        if (hit && hit->distance < nearest[lane]) {
+            nearest[lane] = hit->distance;
+            packet.cubes[lane] = &cube;
+        }
+    }
+    packet.nearest = PacketLanes::load(nearest.data());
+}
+
+/// Traverse the octree with a packet of rays, depth first and front to back along the first ray.
+void traverse(const Cube &cube, RayPacket &packet, const std::uint8_t mirror,
+              const std::optional<std::uint32_t> max_depth) {
+    // Up to seven siblings are waiting on every level, the stack never allocates.
+    std::array<Frame, 7 * Cube::MAX_DEPTH + Cube::SUB_CUBES> stack;
+    std::size_t stack_size = 0;
+    stack[stack_size++] = {&cube, max_depth};
+    while (stack_size > 0) {
+        const Frame frame = stack[--stack_size];
+        Float entry;
+        const Float entered = enter_box(packet, frame.cube->bounding_box(), entry);
+        if (PacketLanes::bits(entered) == 0) {
+            continue;
+        }
+        const bool octant = frame.cube->type() == Cube::Type::OCTANT;
+        // If the maximum depth is reached, the octant is treated as if it was solid.
+        if (frame.cube->type() == Cube::Type::SOLID || (octant && frame.max_depth == 0u)) {
+            const Float hit = PacketLanes::bitwise_and(entered, PacketLanes::less(entry, packet.nearest));
+            packet.nearest = PacketLanes::select(hit, entry, packet.nearest);
+            for (std::uint32_t lanes = PacketLanes::bits(hit); lanes != 0; lanes &= lanes - 1) {
+                packet.cubes[static_cast<std::size_t>(std::countr_zero(lanes))] = frame.cube;
+            }
+            continue;
+        }
+        if (frame.cube->type() == Cube::Type::NORMAL) {
+            const Float candidates = PacketLanes::bitwise_and(entered, PacketLanes::less(entry, packet.nearest));
+            hit_triangles(*frame.cube, packet, candidates);
+            continue;
+        }
+        if (!octant) {
+            continue;
+        }
+        const std::optional<std::uint32_t> next_depth =
+            frame.max_depth ? std::make_optional<std::uint32_t>(*frame.max_depth - 1) : std::nullopt;
+        assert(stack_size + Cube::SUB_CUBES <= stack.size());
+        const auto &children = frame.cube->children();
+        // The children are pushed in reverse, so the ones nearest to the start of the first ray are visited first.
+        for (std::size_t idx = Cube::SUB_CUBES; idx-- > 0;) {
+            const Cube &child = *children[idx ^ mirror];
+            if (child.type() != Cube::Type::EMPTY) {
+                stack[stack_size++] = {&child, next_depth};
+            }
+        }
+    }
+}
+
+} // namespace
+
+void ray_packet_collision_check(const Cube &cube, const std::span<const glm::vec3> positions,
+                                const std::span<const glm::vec3> directions, const std::span<const Cube *> cubes,
+                                const std::span<float> distances, const std::optional<std::uint32_t> max_depth) {
+    assert(directions.size() == positions.size());
+    assert(cubes.size() == positions.size());
+    assert(distances.size() == positions.size());
+    for (std::size_t first = 0; first < positions.size(); first += PACKET_SIZE) {
+        const std::size_t count = std::min(PACKET_SIZE, positions.size() - first);
+        RayPacket packet(positions.subspan(first, count), directions.subspan(first, count));
+        if (cube.type() != Cube::Type::EMPTY) {
+            // The children of every octant are mirrored along the axes in which the first ray goes towards the
+            // smaller coordinates, see the child index bits of Cube.
+            std::uint8_t mirror = 0;
+            for (glm::vec3::length_type axis = 0; axis < 3; axis++) {
+                if (directions[first][axis] < 0.0f) {
+                    mirror |= static_cast<std::uint8_t>(4u >> axis);
+                }
+            }
+            traverse(cube, packet, mirror, max_depth);
+        }
+        std::array<float, PACKET_SIZE> nearest;
+        PacketLanes::store(nearest.data(), packet.nearest);
+        for (std::size_t lane = 0; lane < count; lane++) {
+            cubes[first + lane] = packet.cubes[lane];
+            distances[first + lane] = packet.cubes[lane] != nullptr ? nearest[lane] : INFINITE_DISTANCE;
+        }
+    }
+}
+
+void ray_packet_collision_check(const Cube &cube, const std::span<const glm::vec3> positions,
+                                const std::span<const glm::vec3> directions, RayHits &hits,
+                                const std::optional<std::uint32_t> max_depth) {
+    hits.cubes.resize(positions.size());
+    hits.distances.resize(positions.size());
+    ray_packet_collision_check(cube, positions, directions, hits.cubes, hits.distances, max_depth);
+}
+
+void ray_packet_collision_check(tools::ThreadPool &thread_pool, const Cube &cube,
+                                const std::span<const glm::vec3> positions,
+                                const std::span<const glm::vec3> directions, RayHits &hits,
+                                const std::size_t rays_per_task, const std::optional<std::uint32_t> max_depth) {
+    assert(directions.size() == positions.size());
+    hits.cubes.resize(positions.size());
+    hits.distances.resize(positions.size());
+    // Otherwise the first task which reads an octant applies its rotation while the others read it.
+    cube.apply_pending_rotations();
+    // Whole packets per task, so no packet is split between two tasks.
+    const std::size_t packets_per_task = std::max<std::size_t>((rays_per_task + PACKET_SIZE - 1) / PACKET_SIZE, 1);
+    const std::size_t task_size = packets_per_task * PACKET_SIZE;
+    const std::size_t task_count = (positions.size() + task_size - 1) / task_size;
+    thread_pool.parallel_for(task_count, [&](const std::size_t task) {
+        const std::size_t first = task * task_size;
+        const std::size_t count = std::min(task_size, positions.size() - first);
+        ray_packet_collision_check(cube, positions.subspan(first, count), directions.subspan(first, count),
+                                   std::span(hits.cubes).subspan(first, count),
+                                   std::span(hits.distances).subspan(first, count), max_depth);
+    });
+}
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,237 @@
+#include "inexor/vulkan-renderer/world/sparse_voxel_dag.hpp"
+
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <unordered_map>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// Combine a value into a hash, like boost::hash_combine.
+void hash_combine(std::size_t &seed, const std::size_t value) {
+    seed ^= value + 0x9e3779b9 + (seed << 6u) + (seed >> 2u);
+}
+
+struct ChildrenHash {
+    std::size_t operator()(const std::array<SparseVoxelDag::NodeId, Cube::SUB_CUBES> &children) const {
+        std::size_t seed = 0;
+        for (const auto child : children) {
+            hash_combine(seed, child);
+        }
+        return seed;
+    }
+};
+
+struct IndentationsHash {
+    std::size_t operator()(const std::array<Indentation, Cube::EDGES> &indentations) const {
+        std::size_t seed = 0;
+        for (const auto &indentation : indentations) {
+            hash_combine(seed, indentation.uid());
+        }
+        return seed;
+    }
+};
+
+/// Get the distance at which the ray enters the box.
+/// @return The distance, or std::nullopt if the box is not hit in front of the start of the ray.
+std::optional<float> ray_box_entry(const std::array<glm::vec3, 2> &box, const glm::vec3 &position,
+                                   const glm::vec3 &direction) {
+    float entry = 0.0f;
+    float exit = std::numeric_limits<float>::max();
+    for (glm::vec3::length_type axis = 0; axis < 3; axis++) {
+        if (direction[axis] == 0.0f) {
+            // A ray parallel to the slab can only hit the box if it starts inside of the slab.
+            if (position[axis] < box[0][axis] || position[axis] > box[1][axis]) {
+                return std::nullopt;
+            }
+            continue;
+        }
+        float near = (box[0][axis] - position[axis]) / direction[axis];
+        float far = (box[1][axis] - position[axis]) / direction[axis];
+        if (near > far) {
+            std::swap(near, far);
+        }
+        entry = std::max(entry, near);
+        exit = std::min(exit, far);
+        if (entry > exit) {
+            return std::nullopt;
+        }
+    }
+    return entry;
+}
+
+} // namespace
+
+SparseVoxelDag::SparseVoxelDag(const Cube &cube) : m_size(cube.size()), m_position(cube.position()) {
+    std::unordered_map<std::array<NodeId, Cube::SUB_CUBES>, NodeId, ChildrenHash> octants;
+    std::unordered_map<std::array<Indentation, Cube::EDGES>, NodeId, IndentationsHash> normals;
+    std::array<NodeId, 2> empty_and_solid{INVALID_NODE, INVALID_NODE};
+
+    // Insert the children before their parent, so the parent can be looked up by the ids of its children. The ids of
+    // the visited cubes wait on a stack until their parent takes the last eight of them.
+    std::vector<NodeId> ids;
+    traverse_post_order(cube, [&](const Cube &current) {
+        m_tree_node_count++;
+        switch (current.type()) {
+        case Cube::Type::EMPTY:
+        case Cube::Type::SOLID: {
+            NodeId &id = empty_and_solid[current.type() == Cube::Type::SOLID ? 1 : 0];
+            if (id == INVALID_NODE) {
+                id = static_cast<NodeId>(m_nodes.size());
+                m_nodes.push_back({current.type(), 0});
+            }
+            ids.push_back(id);
+            break;
+        }
+        case Cube::Type::NORMAL: {
+            const auto indentations = current.indentations();
+            const auto [entry, inserted] = normals.try_emplace(indentations, static_cast<NodeId>(m_nodes.size()));
+            if (inserted) {
+                m_nodes.push_back({Cube::Type::NORMAL, static_cast<std::uint32_t>(m_indentations.size())});
+                m_indentations.push_back(indentations);
+            }
+            ids.push_back(entry->second);
+            break;
+        }
+        case Cube::Type::OCTANT: {
+            assert(ids.size() >= Cube::SUB_CUBES);
+            std::array<NodeId, Cube::SUB_CUBES> children{};
+            std::copy(ids.end() - Cube::SUB_CUBES, ids.end(), children.begin());
+            ids.resize(ids.size() - Cube::SUB_CUBES);
+            const auto [entry, inserted] = octants.try_emplace(children, static_cast<NodeId>(m_nodes.size()));
+            if (inserted) {
+                m_nodes.push_back({Cube::Type::OCTANT, static_cast<std::uint32_t>(m_children.size())});
+                m_children.push_back(children);
+            }
+            ids.push_back(entry->second);
+            break;
+        }
+        }
+    });
+    assert(ids.size() == 1);
+    m_root = ids.back();
+    assert(m_nodes.size() < INVALID_NODE && "Octree too big!");
+
+    m_nodes.shrink_to_fit();
+    m_children.shrink_to_fit();
+    m_indentations.shrink_to_fit();
+}
+
+std::size_t SparseVoxelDag::memory_usage() const noexcept {
+    return sizeof(SparseVoxelDag) + m_nodes.capacity() * sizeof(Node) +
+           m_children.capacity() * sizeof(std::array<NodeId, Cube::SUB_CUBES>) +
+           m_indentations.capacity() * sizeof(std::array<Indentation, Cube::EDGES>);
+}
+
+Cube::Type SparseVoxelDag::type(const NodeId id) const {
+    return m_nodes[id].type;
+}
+
+SparseVoxelDag::NodeId SparseVoxelDag::child(const NodeId id, const std::size_t idx) const {
+    assert(idx < Cube::SUB_CUBES);
+    const Node &node = m_nodes[id];
+    return node.type == Cube::Type::OCTANT ? m_children[node.data][idx] : INVALID_NODE;
+}
+
+SparseVoxelDag::Location SparseVoxelDag::child(const Location &location, const std::size_t idx) const {
+    const float half_size = location.size / 2;
+    return {child(location.id, idx), location.position + Cube::child_offset(idx) * half_size, half_size};
+}
+
+const std::array<Indentation, Cube::EDGES> &SparseVoxelDag::indentations(const NodeId id) const {
+    assert(m_nodes[id].type == Cube::Type::NORMAL);
+    return m_indentations[m_nodes[id].data];
+}
+
+std::size_t SparseVoxelDag::count_geometry_cubes() const {
+    // The children of a node are always inserted before the node, so the counts can be computed in id order.
+    std::vector<std::size_t> counts(m_nodes.size(), 0);
+    for (NodeId id = 0; id < m_nodes.size(); id++) {
+        const Node &node = m_nodes[id];
+        if (node.type == Cube::Type::SOLID || node.type == Cube::Type::NORMAL) {
+            counts[id] = 1;
+        } else if (node.type == Cube::Type::OCTANT) {
+            for (const auto child : m_children[node.data]) {
+                counts[id] += counts[child];
+            }
+        }
+    }
+    return counts[m_root];
+}
+
+std::optional<SparseVoxelDag::Location> SparseVoxelDag::find_leaf(const glm::vec3 &point) const {
+    Location location = root();
+    const auto bounding_box = location.bounding_box();
+    for (glm::vec3::length_type axis = 0; axis < 3; axis++) {
+        if (point[axis] < bounding_box[0][axis] || point[axis] > bounding_box[1][axis]) {
+            return std::nullopt;
+        }
+    }
+    while (type(location.id) == Cube::Type::OCTANT) {
+        const glm::vec3 center = location.center();
+        const std::size_t idx = (point.x >= center.x ? 4u : 0u) | (point.y >= center.y ? 2u : 0u) |
+                                (point.z >= center.z ? 1u : 0u);
+        location = child(location, idx);
+    }
+    return location;
+}
+
+std::vector<Polygon> SparseVoxelDag::polygons() const {
+    std::vector<Polygon> polygons;
+    polygons.reserve(count_geometry_cubes() * 12);
+
+    // Visit the children in ascending order, so the result matches Cube::polygons.
+    std::vector<Location> stack{root()};
+    while (!stack.empty()) {
+        const Location location = stack.back();
+        stack.pop_back();
+        const Node &node = m_nodes[location.id];
+        if (node.type == Cube::Type::OCTANT) {
+            for (std::size_t idx = Cube::SUB_CUBES; idx-- > 0;) {
+                stack.push_back(child(location, idx));
+            }
+        } else if (node.type == Cube::Type::SOLID || node.type == Cube::Type::NORMAL) {
+            const auto cube_polygons =
+                Cube::triangulate(node.type, location.position, location.size,
+                                  node.type == Cube::Type::NORMAL ? m_indentations[node.data]
+                                                                  : std::array<Indentation, Cube::EDGES>{});
+            polygons.insert(polygons.end(), cube_polygons.begin(), cube_polygons.end());
+        }
+    }
+    return polygons;
+}
+
+std::optional<SparseVoxelDag::RayCollision> SparseVoxelDag::ray_collision(const glm::vec3 &position,
+                                                                          const glm::vec3 &direction) const {
+    // A child is only hidden by the children whose index differs in the bits of the axes along which the ray goes,
+    // so visiting the children in the order idx ^ mirror is front to back.
+    const std::size_t mirror =
+        (direction.x < 0 ? 4u : 0u) | (direction.y < 0 ? 2u : 0u) | (direction.z < 0 ? 1u : 0u);
+
+    std::vector<Location> stack{root()};
+    while (!stack.empty()) {
+        const Location location = stack.back();
+        stack.pop_back();
+        const Cube::Type node_type = type(location.id);
+        if (node_type == Cube::Type::EMPTY) {
+            continue;
+        }
+        const auto distance = ray_box_entry(location.bounding_box(), position, direction);
+        if (!distance) {
+            continue;
+        }
+        if (node_type != Cube::Type::OCTANT) {
+            return RayCollision{location, *distance, position + *distance * direction};
+        }
+        for (std::size_t idx = Cube::SUB_CUBES; idx-- > 0;) {
+            stack.push_back(child(location, idx ^ mirror));
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,140 @@
+#include "inexor/vulkan-renderer/world/spatial_query.hpp"
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// The number of cells of the grid of the deepest level along every axis.
+constexpr std::uint32_t GRID_SIZE{1u << Cube::MAX_DEPTH};
+
+/// Integer coordinates of a cell of the grid of the deepest level.
+using GridPosition = std::array<std::uint32_t, 3>;
+
+/// A cube on the stack of collect_leaves(), with the cells it covers.
+struct Frame {
+    const Cube *cube;
+    GridPosition origin;
+    std::uint32_t extent;
+};
+
+/// Convert a coordinate into cells of the grid of the deepest level of a cube, clamped to the cube.
+std::uint32_t to_cell(const float cell) {
+    return static_cast<std::uint32_t>(std::clamp(cell, 0.0f, static_cast<float>(GRID_SIZE - 1)));
+}
+
+/// The cells of the grid of the deepest level of a cube which overlap a box, including the ones touching it.
+/// @return std::nullopt if the box is outside of the cube.
+std::optional<std::pair<GridPosition, GridPosition>> to_cells(const Cube &cube,
+                                                              const std::array<glm::vec3, 2> &box_bounds) {
+    const auto [min, max] = cube.bounding_box();
+    std::pair<GridPosition, GridPosition> cells;
+    for (glm::vec3::length_type axis = 0; axis < 3; axis++) {
+        if (!(box_bounds[1][axis] >= min[axis] && box_bounds[0][axis] <= max[axis])) {
+            return std::nullopt;
+        }
+        const float scale = static_cast<float>(GRID_SIZE) / cube.size();
+        // A box which ends on the boundary of a cell touches the cell before it, too.
+        cells.first[axis] = to_cell(std::ceil((box_bounds[0][axis] - min[axis]) * scale) - 1.0f);
+        cells.second[axis] = to_cell(std::floor((box_bounds[1][axis] - min[axis]) * scale));
+    }
+    return cells;
+}
+
+/// Collect the leaves which overlap a range of cells, of which overlaps() is true as well as of their parents.
+template <typename Overlaps>
+void collect_leaves(const Cube &cube, const std::pair<GridPosition, GridPosition> &cells, const Overlaps &overlaps,
+                    std::vector<const Cube *> &leaves) {
+    const auto &[first, last] = cells;
+    // Up to seven siblings are waiting on every level, the stack never allocates.
+    std::array<Frame, 7 * Cube::MAX_DEPTH + Cube::SUB_CUBES> stack;
+    std::size_t stack_size = 0;
+    stack[stack_size++] = {&cube, {0, 0, 0}, GRID_SIZE};
+    while (stack_size > 0) {
+        const Frame frame = stack[--stack_size];
+        if (!overlaps(*frame.cube)) {
+            continue;
+        }
+        if (frame.cube->type() != Cube::Type::OCTANT) {
+            leaves.push_back(frame.cube);
+            continue;
+        }
+        const std::uint32_t half = frame.extent / 2;
+        assert(half > 0 && "Octree too deep!");
+        const auto &children = frame.cube->children();
+        // The children are pushed in reverse, so they are visited in order.
+        for (std::size_t idx = Cube::SUB_CUBES; idx-- > 0;) {
+            GridPosition origin = frame.origin;
+            bool inside = true;
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                // The bits of the child index are x, y and z, from the most significant one.
+                origin[axis] += static_cast<std::uint32_t>((idx >> (2 - axis)) & 1u) * half;
+                inside = inside && origin[axis] <= last[axis] && origin[axis] + half - 1 >= first[axis];
+            }
+            if (inside) {
+                stack[stack_size++] = {children[idx].get(), origin, half};
+            }
+        }
+    }
+}
+
+} // namespace
+
+const Cube *find_leaf(const Cube &cube, const glm::vec3 &point) {
+    const auto [min, max] = cube.bounding_box();
+    GridPosition cell;
+    for (glm::vec3::length_type axis = 0; axis < 3; axis++) {
+        if (!(point[axis] >= min[axis] && point[axis] <= max[axis])) {
+            return nullptr;
+        }
+        cell[axis] = to_cell(std::floor((point[axis] - min[axis]) * (static_cast<float>(GRID_SIZE) / cube.size())));
+    }
+    // Every level takes the next bit of each coordinate, like the locational code.
+    const Cube *current = &cube;
+    for (std::uint32_t shift = Cube::MAX_DEPTH; current->type() == Cube::Type::OCTANT;) {
+        assert(shift > 0 && "Octree too deep!");
+        shift--;
+        const std::uint32_t idx =
+            ((cell[0] >> shift) & 1u) << 2u | ((cell[1] >> shift) & 1u) << 1u | ((cell[2] >> shift) & 1u);
+        current = current->children()[idx].get();
+    }
+    return current;
+}
+
+Cube *find_leaf(Cube &cube, const glm::vec3 &point) {
+    return const_cast<Cube *>(find_leaf(std::as_const(cube), point));
+}
+
+void query_box(const Cube &cube, const std::array<glm::vec3, 2> &box_bounds, std::vector<const Cube *> &leaves) {
+    if (const auto cells = to_cells(cube, box_bounds)) {
+        collect_leaves(cube, *cells, [](const Cube &) { return true; }, leaves);
+    }
+}
+
+void query_sphere(const Cube &cube, const glm::vec3 &center, const float radius, std::vector<const Cube *> &leaves) {
+    const auto cells = to_cells(cube, {center - radius, center + radius});
+    if (!cells) {
+        return;
+    }
+    collect_leaves(
+        cube, *cells,
+        [&](const Cube &current) {
+            const auto box_bounds = current.bounding_box();
+            const glm::vec3 offset = glm::clamp(center, box_bounds[0], box_bounds[1]) - center;
+            return glm::dot(offset, offset) <= radius * radius;
+        },
+        leaves);
+}
+
+} // namespace inexor::vulkan_renderer::world
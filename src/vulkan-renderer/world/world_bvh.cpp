@@ -0,0 +1,140 @@
+#include "inexor/vulkan-renderer/world/world_bvh.hpp"
+
+#include "inexor/vulkan-renderer/world/collision_query.hpp"
+#include "inexor/vulkan-renderer/world/cube.hpp"
+
+#include <glm/common.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// A node on the stack of WorldBvh::ray_cube_collision_check(), with the distance at which the ray enters it.
+struct Frame {
+    std::uint32_t node;
+    float entry;
+};
+
+/// The distance of a collision from the start position of the ray.
+float hit_distance(const RayCubeCollision<Cube> &collision, const glm::vec3 &pos, const glm::vec3 &dir) {
+    if (collision.triangle()) {
+        return collision.triangle()->distance;
+    }
+    // The ray hits a solid cube where it enters it. Rounding may let it barely miss the box of the cube.
+    return ray_box_entry_distance(collision.cube().bounding_box(), pos, dir).value_or(0.0f);
+}
+
+} // namespace
+
+WorldBvh::WorldBvh(std::vector<std::shared_ptr<Cube>> worlds) : m_worlds(std::move(worlds)) {
+    if (m_worlds.empty()) {
+        return;
+    }
+    std::vector<std::uint32_t> indices(m_worlds.size());
+    std::iota(indices.begin(), indices.end(), 0u);
+    // A binary tree with one world per leaf has one node less than twice the number of worlds.
+    m_nodes.reserve(2 * m_worlds.size() - 1);
+    m_nodes.emplace_back();
+    build(0, indices, 0, indices.size());
+}
+
+void WorldBvh::build(const std::size_t node, std::vector<std::uint32_t> &worlds, const std::size_t first,
+                     const std::size_t last) {
+    assert(first < last);
+    std::array<glm::vec3, 2> bounds = m_worlds[worlds[first]]->bounding_box();
+    std::array<glm::vec3, 2> centers{bounds[0] + bounds[1], bounds[0] + bounds[1]};
+    for (std::size_t idx = first + 1; idx < last; idx++) {
+        const auto box = m_worlds[worlds[idx]]->bounding_box();
+        bounds = {glm::min(bounds[0], box[0]), glm::max(bounds[1], box[1])};
+        // The doubled centers, as only their order matters.
+        centers = {glm::min(centers[0], box[0] + box[1]), glm::max(centers[1], box[0] + box[1])};
+    }
+    m_nodes[node].bounds = bounds;
+    if (last - first == 1) {
+        m_nodes[node].index = worlds[first];
+        m_nodes[node].leaf = true;
+        return;
+    }
+    glm::vec3::length_type axis = 0;
+    const glm::vec3 spread = centers[1] - centers[0];
+    for (glm::vec3::length_type other = 1; other < 3; other++) {
+        if (spread[other] > spread[axis]) {
+            axis = other;
+        }
+    }
+    const std::size_t middle = first + (last - first) / 2;
+    std::nth_element(worlds.begin() + static_cast<std::ptrdiff_t>(first),
+                     worlds.begin() + static_cast<std::ptrdiff_t>(middle),
+                     worlds.begin() + static_cast<std::ptrdiff_t>(last), [&](const auto lhs, const auto rhs) {
+                         const auto lhs_box = m_worlds[lhs]->bounding_box();
+                         const auto rhs_box = m_worlds[rhs]->bounding_box();
+                         return lhs_box[0][axis] + lhs_box[1][axis] < rhs_box[0][axis] + rhs_box[1][axis];
+                     });
+    const std::size_t children = m_nodes.size();
+    m_nodes[node].index = static_cast<std::uint32_t>(children);
+    m_nodes.resize(children + 2);
+    build(children, worlds, first, middle);
+    build(children + 1, worlds, middle, last);
+}
+
+std::optional<RayCubeCollision<Cube>> WorldBvh::ray_cube_collision_check(const glm::vec3 &pos,
+                                                                         const glm::vec3 &dir,
+                                                                         const std::optional<std::uint32_t> max_depth)
+    const {
+    if (m_nodes.empty()) {
+        return std::nullopt;
+    }
+    const auto root_entry = ray_box_entry_distance(m_nodes[0].bounds, pos, dir);
+    if (!root_entry) {
+        return std::nullopt;
+    }
+    std::optional<RayCubeCollision<Cube>> nearest;
+    float nearest_distance = std::numeric_limits<float>::infinity();
+    // The tree is balanced, so its depth is at most 64 and one sibling waits on every level.
+    std::array<Frame, 64> stack;
+    std::size_t stack_size = 0;
+    stack[stack_size++] = {0, *root_entry};
+    while (stack_size > 0) {
+        const Frame frame = stack[--stack_size];
+        // Everything in this node is behind the nearest hit.
+        if (frame.entry >= nearest_distance) {
+            continue;
+        }
+        const Node &node = m_nodes[frame.node];
+        if (node.leaf) {
+            auto collision = world::ray_cube_collision_check(*m_worlds[node.index], pos, dir, max_depth);
+            if (collision) {
+                const float distance = hit_distance(*collision, pos, dir);
+                if (distance < nearest_distance) {
+                    nearest_distance = distance;
+                    nearest.emplace(std::move(*collision));
+                }
+            }
+            continue;
+        }
+        std::array<Frame, 2> children;
+        std::size_t hit_children = 0;
+        for (std::uint32_t child = node.index; child < node.index + 2; child++) {
+            if (const auto entry = ray_box_entry_distance(m_nodes[child].bounds, pos, dir)) {
+                children[hit_children++] = {child, *entry};
+            }
+        }
+        // The nearer child is pushed last, so it is visited first.
+        if (hit_children == 2 && children[0].entry < children[1].entry) {
+            std::swap(children[0], children[1]);
+        }
+        assert(stack_size + hit_children <= stack.size());
+        for (std::size_t idx = 0; idx < hit_children; idx++) {
+            stack[stack_size++] = children[idx];
+        }
+    }
+    return nearest;
+}
+
+} // namespace inexor::vulkan_renderer::world
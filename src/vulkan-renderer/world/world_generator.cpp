@@ -0,0 +1,174 @@
+#include "inexor/vulkan-renderer/world/world_generator.hpp"
+
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// The finalizer of SplitMix64, every bit of the input affects every bit of the output.
+constexpr std::uint64_t mix(std::uint64_t value) noexcept {
+    value ^= value >> 30u;
+    value *= 0xbf58476d1ce4e5b9ull;
+    value ^= value >> 27u;
+    value *= 0x94d049bb133111ebull;
+    value ^= value >> 31u;
+    return value;
+}
+
+/// Map a random number to [0, 1).
+constexpr float to_unit(const std::uint64_t value) noexcept {
+    return static_cast<float>(value >> 40u) / static_cast<float>(1u << 24u);
+}
+
+} // namespace
+
+WorldGenerator::WorldGenerator(const std::uint64_t seed, const std::uint32_t max_depth,
+                               std::optional<Heightfield> heightfield)
+    : m_seed(seed), m_max_depth(max_depth), m_heightfield(heightfield) {}
+
+std::uint64_t WorldGenerator::random(const std::uint64_t seed, const std::uint64_t key,
+                                     const std::uint64_t counter) noexcept {
+    return mix(mix(mix(seed) + key) + counter);
+}
+
+float WorldGenerator::height(const float x, const float z) const {
+    float noise = 0.0f;
+    float amplitude = 1.0f;
+    float amplitude_sum = 0.0f;
+    float wavelength = m_heightfield->wavelength;
+    for (std::uint32_t octave = 0; octave < m_heightfield->octaves; octave++) {
+        const float lattice_x = std::floor(x / wavelength);
+        const float lattice_z = std::floor(z / wavelength);
+        const auto value = [&](const float offset_x, const float offset_z) {
+            // The lattice coordinates are packed into the key, the octave is the counter.
+            const auto key = (static_cast<std::uint64_t>(static_cast<std::int32_t>(lattice_x + offset_x)) << 32u) |
+                             static_cast<std::uint32_t>(static_cast<std::int32_t>(lattice_z + offset_z));
+            return to_unit(random(m_seed, key, octave));
+        };
+        const auto smooth = [](const float t) { return t * t * (3.0f - 2.0f * t); };
+        const float tx = smooth(x / wavelength - lattice_x);
+        const float tz = smooth(z / wavelength - lattice_z);
+        const float near_z = value(0, 0) + (value(1, 0) - value(0, 0)) * tx;
+        const float far_z = value(0, 1) + (value(1, 1) - value(0, 1)) * tx;
+        noise += amplitude * (2.0f * (near_z + (far_z - near_z) * tz) - 1.0f);
+        amplitude_sum += amplitude;
+        amplitude *= 0.5f;
+        wavelength *= 0.5f;
+    }
+    return m_heightfield->base_height + m_heightfield->amplitude * noise / std::max(amplitude_sum, 1.0f);
+}
+
+void WorldGenerator::fill(Cube &cube, const std::size_t depth) const {
+    if (m_heightfield) {
+        fill_heightfield(cube, depth);
+    } else if (depth <= m_max_depth) {
+        cube.set_type(Cube::Type::OCTANT);
+    } else {
+        fill_random(cube);
+    }
+}
+
+void WorldGenerator::fill_random(Cube &cube) const {
+    const std::uint64_t code = cube.locational_code();
+    const auto type = random(m_seed, code, 0) % 100;
+    if (type < 30) {
+        cube.set_type(Cube::Type::EMPTY);
+        return;
+    }
+    if (type < 60) {
+        cube.set_type(Cube::Type::SOLID);
+        return;
+    }
+    cube.set_type(Cube::Type::NORMAL);
+    for (std::uint8_t edge = 0; edge < Cube::EDGES; edge++) {
+        cube.set_indent(edge, Indentation(static_cast<std::uint8_t>(random(m_seed, code, 1 + edge) % 45)));
+    }
+}
+
+void WorldGenerator::fill_heightfield(Cube &cube, const std::size_t depth) const {
+    const glm::vec3 position = cube.position();
+    const float size = cube.size();
+    // Cubes which can't be reached by the terrain are not subdivided.
+    if (position.y >= m_heightfield->base_height + m_heightfield->amplitude) {
+        cube.set_type(Cube::Type::EMPTY);
+        return;
+    }
+    if (position.y + size <= m_heightfield->base_height - m_heightfield->amplitude) {
+        cube.set_type(Cube::Type::SOLID);
+        return;
+    }
+    if (depth <= m_max_depth) {
+        cube.set_type(Cube::Type::OCTANT);
+        return;
+    }
+    // The height of the top corners in steps of the indentation, the corners are shared with the neighbors.
+    const auto steps = [&](const float x, const float z) {
+        const float relative = (height(x, z) - position.y) / size * Indentation::MAX;
+        return static_cast<std::uint8_t>(std::clamp(std::round(relative), 0.0f, static_cast<float>(Indentation::MAX)));
+    };
+    const std::uint8_t x0_z0 = steps(position.x, position.z);
+    const std::uint8_t x0_z1 = steps(position.x, position.z + size);
+    const std::uint8_t x1_z0 = steps(position.x + size, position.z);
+    const std::uint8_t x1_z1 = steps(position.x + size, position.z + size);
+    if (std::max({x0_z0, x0_z1, x1_z0, x1_z1}) == 0) {
+        cube.set_type(Cube::Type::EMPTY);
+        return;
+    }
+    if (std::min({x0_z0, x0_z1, x1_z0, x1_z1}) == Indentation::MAX) {
+        cube.set_type(Cube::Type::SOLID);
+        return;
+    }
+    // The edges along the y axis, see Cube::vertices().
+    cube.set_type(Cube::Type::NORMAL);
+    cube.set_indent(1, Indentation(0, x0_z0));
+    cube.set_indent(4, Indentation(0, x0_z1));
+    cube.set_indent(10, Indentation(0, x1_z0));
+    cube.set_indent(7, Indentation(0, x1_z1));
+}
+
+void WorldGenerator::generate_subtree(Cube &cube, const std::size_t depth) const {
+    // The children of an octant are created by set_type, before the traversal visits them.
+    traverse_pre_order(cube,
+                       [&](Cube &current, const std::size_t relative_depth) { fill(current, depth + relative_depth); });
+}
+
+std::shared_ptr<Cube> WorldGenerator::generate(const glm::vec3 &position, const float size) const {
+    auto cube = std::make_shared<Cube>(size, position);
+    generate_subtree(*cube, 0);
+    return cube;
+}
+
+std::shared_ptr<Cube> WorldGenerator::generate(tools::ThreadPool &thread_pool, const std::size_t split_depth,
+                                               const glm::vec3 &position, const float size) const {
+    auto cube = std::make_shared<Cube>(size, position);
+    std::vector<Cube *> subtrees;
+    traverse_pre_order(*cube, [&](Cube &current, const std::size_t depth) {
+        if (depth == split_depth) {
+            subtrees.push_back(&current);
+            return TraversalAction::SKIP_CHILDREN;
+        }
+        fill(current, depth);
+        return TraversalAction::CONTINUE;
+    });
+    // Filling the subtrees would write the statistics of the octants above them, so they are filled while detached.
+    std::vector<Cube::DetachedSubtree> detached;
+    detached.reserve(subtrees.size());
+    for (Cube *subtree : subtrees) {
+        detached.emplace_back(*subtree);
+    }
+    thread_pool.parallel_for(subtrees.size(),
+                             [&](const std::size_t idx) { generate_subtree(*subtrees[idx], split_depth); });
+    // Attach the subtrees again.
+    detached.clear();
+    return cube;
+}
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,50 @@
+#include <inexor/vulkan-renderer/io/byte_stream.hpp>
+#include <inexor/vulkan-renderer/io/exception.hpp>
+#include <inexor/vulkan-renderer/io/nxoc_parser.hpp>
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/linear_octree.hpp>
+
+#include <gtest/gtest.h>
+
+namespace {
+using namespace inexor::vulkan_renderer;
+
+/// A stream of octants nested in their first child, with empty cubes in all other children.
+io::ByteStream nested_octants(const std::size_t octants) {
+    io::ByteStreamWriter writer;
+    writer.write<std::string>("Inexor Octree");
+    writer.write<std::uint32_t>(0);
+    for (std::size_t idx = 0; idx < octants; idx++) {
+        writer.write(world::Cube::Type::OCTANT);
+    }
+    for (std::size_t idx = 0; idx < 7 * octants + 1; idx++) {
+        writer.write(world::Cube::Type::EMPTY);
+    }
+    return writer;
+}
+
+TEST(NXOCParser, max_depth) {
+    // The leaves of the deepest octant are at Cube::MAX_DEPTH.
+    const auto world = io::NXOCParser().deserialize(nested_octants(world::Cube::MAX_DEPTH));
+    const world::Cube *cube = world.get();
+    while (cube->type() == world::Cube::Type::OCTANT) {
+        cube = cube->children()[0].get();
+    }
+    EXPECT_EQ(cube->grid_level(), world::Cube::MAX_DEPTH);
+
+    EXPECT_THROW(static_cast<void>(io::NXOCParser().deserialize(nested_octants(world::Cube::MAX_DEPTH + 1))),
+                 io::IoException);
+    EXPECT_THROW(static_cast<void>(io::NXOCParser().deserialize_linear(
+                     nested_octants(world::Cube::MAX_DEPTH + 1), 1.0f, {0.0f, 0.0f, 0.0f})),
+                 io::IoException);
+}
+
+TEST(NXOCParser, linear_octree) {
+    const auto world = world::create_random_world(3, {1.0f, 2.0f, 3.0f}, 42);
+    const auto stream = io::NXOCParser().serialize(world, 0);
+    const auto octree = io::NXOCParser().deserialize_linear(stream, world->size(), world->position());
+    EXPECT_EQ(io::NXOCParser().serialize(octree, 0).buffer(), stream.buffer());
+    EXPECT_EQ(octree.polygons(), world::LinearOctree(*world).polygons());
+}
+
+} // namespace
@@ -0,0 +1,108 @@
+#include <inexor/vulkan-renderer/io/nxoc_parser.hpp>
+#include <inexor/vulkan-renderer/tools/thread_pool.hpp>
+#include <inexor/vulkan-renderer/world/chunk_manager.hpp>
+#include <inexor/vulkan-renderer/world/cube.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+namespace {
+using namespace inexor::vulkan_renderer;
+using namespace inexor::vulkan_renderer::world;
+
+TEST(ChunkManager, paging) {
+    tools::ThreadPool thread_pool(2);
+    // A map which is ten chunks long in x direction.
+    const auto serialized = io::NXOCParser().serialize(create_random_world(2, {0.0f, 0.0f, 0.0f}, 42), 0);
+    std::atomic<std::size_t> loads{0};
+    const auto loader = [&](const ChunkManager::GridPosition &grid_position) -> std::optional<io::ByteStream> {
+        loads++;
+        if (grid_position[0] < 0 || grid_position[0] >= 10 || grid_position[1] != 0 || grid_position[2] != 0) {
+            return std::nullopt;
+        }
+        return serialized;
+    };
+    ChunkManager chunk_manager(thread_pool, loader, 4.0f, 8);
+    EXPECT_EQ(chunk_manager.grid_position({-0.5f, 4.0f, 7.9f}), (ChunkManager::GridPosition{-1, 1, 1}));
+
+    // Only the chunks within the view distance are loaded.
+    const glm::vec3 camera{2.0f, 2.0f, 2.0f};
+    chunk_manager.update(camera, 1.0f);
+    EXPECT_TRUE(chunk_manager.wait());
+    auto chunks = chunk_manager.resident_chunks();
+    ASSERT_EQ(chunks.size(), 1);
+    EXPECT_EQ(chunks[0]->position(), glm::vec3(0.0f, 0.0f, 0.0f));
+    EXPECT_EQ(chunks[0]->size(), 4.0f);
+    EXPECT_EQ(chunks[0]->polygons().size(), create_random_world(2, {0.0f, 0.0f, 0.0f}, 42)->polygons(true).size());
+    EXPECT_EQ(loads, 1);
+
+    // The budget takes the closest chunks only, among them are positions without a chunk.
+    chunk_manager.update(camera, 6.0f);
+    chunk_manager.wait();
+    EXPECT_EQ(chunk_manager.pending_chunks(), 0);
+    EXPECT_EQ(loads, 8);
+    chunks = chunk_manager.resident_chunks();
+    ASSERT_EQ(chunks.size(), 2);
+    EXPECT_EQ(chunks[1]->position(), glm::vec3(4.0f, 0.0f, 0.0f));
+
+    // Positions without a chunk do not count against the budget, so the following updates load the rest of the view.
+    while (chunk_manager.update(camera, 6.0f) || chunk_manager.pending_chunks() > 0) {
+        chunk_manager.wait();
+    }
+    chunks = chunk_manager.resident_chunks();
+    ASSERT_EQ(chunks.size(), 3);
+    EXPECT_EQ(chunks[2]->position(), glm::vec3(8.0f, 0.0f, 0.0f));
+    const std::size_t view_loads = loads;
+    EXPECT_FALSE(chunk_manager.update(camera, 6.0f));
+    EXPECT_EQ(loads, view_loads);
+
+    // Moving along the map keeps the chunks which were loaded last and evicts the ones behind the camera.
+    for (float x = 10.0f; x < 40.0f; x += 4.0f) {
+        chunk_manager.update({x, 2.0f, 2.0f}, 1.0f);
+        chunk_manager.wait();
+        chunks = chunk_manager.resident_chunks();
+        ASSERT_LE(chunks.size(), 8);
+        EXPECT_EQ(chunks.back()->position(), glm::vec3(x - 2.0f, 0.0f, 0.0f));
+    }
+    EXPECT_EQ(chunks.front()->position(), glm::vec3(8.0f, 0.0f, 0.0f));
+    EXPECT_FALSE(chunk_manager.update({38.0f, 2.0f, 2.0f}, 1.0f));
+}
+
+TEST(ChunkManager, pending_out_of_view) {
+    const auto serialized = io::NXOCParser().serialize(create_random_world(1, {0.0f, 0.0f, 0.0f}, 42), 0);
+    std::atomic<std::size_t> loads{0};
+    std::atomic<bool> released{false};
+    const auto loader = [&](const ChunkManager::GridPosition &) -> std::optional<io::ByteStream> {
+        loads++;
+        while (!released) {
+            std::this_thread::yield();
+        }
+        return serialized;
+    };
+    // Evicted loads still run, so the pool is destroyed before the variables which the loader uses.
+    tools::ThreadPool thread_pool(1);
+    ChunkManager chunk_manager(thread_pool, loader, 4.0f, 8);
+
+    // Crossing a chunk border back and forth while the chunks are loading does not load them again.
+    chunk_manager.update({2.0f, 2.0f, 2.0f}, 1.0f);
+    chunk_manager.update({6.0f, 2.0f, 2.0f}, 1.0f);
+    chunk_manager.update({2.0f, 2.0f, 2.0f}, 1.0f);
+    EXPECT_EQ(chunk_manager.pending_chunks(), 2);
+    released = true;
+    EXPECT_TRUE(chunk_manager.wait());
+    EXPECT_EQ(chunk_manager.resident_chunks().size(), 2);
+    EXPECT_EQ(loads, 2);
+
+    // Loads in flight count against the budget, so the farthest ones are evicted.
+    ChunkManager small(thread_pool, loader, 4.0f, 1);
+    small.update({2.0f, 2.0f, 2.0f}, 1.0f);
+    small.update({6.0f, 2.0f, 2.0f}, 1.0f);
+    EXPECT_EQ(small.pending_chunks(), 1);
+    small.wait();
+    ASSERT_EQ(small.resident_chunks().size(), 1);
+    EXPECT_EQ(small.resident_chunks()[0]->position(), glm::vec3(4.0f, 0.0f, 0.0f));
+}
+
+} // namespace
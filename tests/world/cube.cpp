@@ -1,7 +1,16 @@
+#include <inexor/vulkan-renderer/exception.hpp>
+#include <inexor/vulkan-renderer/tools/thread_pool.hpp>
 #include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/octree_traversal.hpp>
+
+#include "polygons.hpp"
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <functional>
+#include <limits>
+
 namespace {
 using namespace inexor::vulkan_renderer::world;
 
@@ -27,4 +36,376 @@ TEST(Cube, neighbor) {
               root->children()[0]->children()[3]);
 }
 
+TEST(Cube, locational_code) {
+    std::shared_ptr<Cube> root = std::make_shared<Cube>(2.0f, glm::vec3{0, 0, 0});
+    root->set_type(Cube::Type::OCTANT);
+    root->children()[6]->set_type(Cube::Type::OCTANT);
+    root->children()[6]->children()[3]->set_type(Cube::Type::OCTANT);
+    EXPECT_EQ(root->locational_code(), 1);
+    EXPECT_EQ(root->children()[6]->locational_code(), 0b1'110);
+    EXPECT_EQ(root->children()[6]->children()[3]->children()[5]->locational_code(), 0b1'110'011'101);
+
+    // Rotating moves the children to other slots, which changes their path.
+    root->rotate(Cube::RotationAxis::Z, 1);
+    for (std::size_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+        EXPECT_EQ(root->children()[idx]->locational_code(), 0b1'000 | idx);
+    }
+
+    // The octant moved from slot 6 to 2, its child octant from slot 3 to 1.
+    const auto &octant = root->children()[2]->children()[1];
+    ASSERT_EQ(octant->type(), Cube::Type::OCTANT);
+    EXPECT_EQ(octant->children()[6]->locational_code(), 0b1'010'001'110);
+
+    // Neighbors across several levels, including larger ones and ones outside of the octree.
+    const auto cube = octant->children()[6];
+    EXPECT_EQ(cube->neighbor(Cube::NeighborAxis::X, Cube::NeighborDirection::POSITIVE),
+              root->children()[2]->children()[5]);
+    EXPECT_EQ(cube->neighbor(Cube::NeighborAxis::X, Cube::NeighborDirection::NEGATIVE), octant->children()[2]);
+    EXPECT_EQ(cube->neighbor(Cube::NeighborAxis::Y, Cube::NeighborDirection::POSITIVE),
+              root->children()[2]->children()[3]);
+    EXPECT_EQ(cube->neighbor(Cube::NeighborAxis::Y, Cube::NeighborDirection::NEGATIVE), octant->children()[4]);
+    EXPECT_EQ(cube->neighbor(Cube::NeighborAxis::Z, Cube::NeighborDirection::POSITIVE), octant->children()[7]);
+    EXPECT_EQ(cube->neighbor(Cube::NeighborAxis::Z, Cube::NeighborDirection::NEGATIVE),
+              root->children()[2]->children()[0]);
+    EXPECT_EQ(root->children()[7]->neighbor(Cube::NeighborAxis::X, Cube::NeighborDirection::POSITIVE), nullptr);
+    EXPECT_EQ(root->neighbor(Cube::NeighborAxis::X, Cube::NeighborDirection::NEGATIVE), nullptr);
+}
+
+TEST(Cube, swap_and_move) {
+    auto source = std::make_shared<Cube>(2.0f, glm::vec3{0, 0, 0});
+    source->set_type(Cube::Type::OCTANT);
+    source->children()[0]->set_type(Cube::Type::OCTANT);
+    const auto moved = std::make_shared<Cube>();
+    swap(*moved, *source);
+    // The children must not refer to the cube they were swapped out of.
+    source.reset();
+
+    const auto child = moved->children()[0];
+    EXPECT_FALSE(child->is_root());
+    EXPECT_EQ(child->neighbor(Cube::NeighborAxis::X, Cube::NeighborDirection::POSITIVE), moved->children()[4]);
+    EXPECT_EQ(child->children()[7]->neighbor(Cube::NeighborAxis::X, Cube::NeighborDirection::POSITIVE),
+              moved->children()[4]);
+    // Edits of the children reach their new parent.
+    static_cast<void>(moved->polygons(true));
+    child->children()[7]->set_type(Cube::Type::SOLID);
+    EXPECT_TRUE(moved->subtree_dirty());
+    EXPECT_EQ(moved->statistics().solid_cubes, 1);
+
+    Cube constructed(std::move(*moved));
+    EXPECT_EQ(constructed.children()[0]->neighbor(Cube::NeighborAxis::Y, Cube::NeighborDirection::POSITIVE),
+              constructed.children()[2]);
+    EXPECT_FALSE(constructed.children()[0]->is_root());
+}
+
+TEST(Cube, clone) {
+    const auto world = create_random_world(2, {0.0f, 0.0f, 0.0f}, 42);
+    // Without updated polygon caches.
+    const auto clone = world->clone();
+    EXPECT_EQ(clone->count_geometry_cubes(), world->count_geometry_cubes());
+    EXPECT_EQ(clone->children()[7]->children()[7]->locational_code(), 0b1'111'111);
+
+    const auto polygons = flatten(world->polygons(true));
+    const auto updated_clone = world->clone();
+    EXPECT_EQ(flatten(updated_clone->polygons()), polygons);
+    EXPECT_EQ(flatten(world->children()[3]->clone()->polygons()), flatten(world->children()[3]->polygons()));
+    updated_clone->children()[0]->set_type(Cube::Type::EMPTY);
+    EXPECT_EQ(flatten(world->polygons()), polygons);
+    // A clone of a changed subtree takes over the slots, which are moved by its next update.
+    world->children()[2]->set_type(Cube::Type::SOLID);
+    const auto changed_clone = world->clone();
+    EXPECT_EQ(flatten(changed_clone->polygons(true)), flatten(world->polygons(true)));
+}
+
+TEST(Cube, parallel_polygons) {
+    inexor::vulkan_renderer::tools::ThreadPool thread_pool(4);
+    const auto expected = flatten(create_random_world(3, {0.0f, 0.0f, 0.0f}, 42)->polygons(true));
+
+    for (std::size_t split_depth = 0; split_depth <= 4; split_depth++) {
+        const auto world = create_random_world(3, {0.0f, 0.0f, 0.0f}, 42);
+        EXPECT_EQ(flatten(world->polygons(thread_pool, split_depth)), expected);
+    }
+}
+
+TEST(Cube, polygon_arena) {
+    const auto world = create_random_world(2, {0.0f, 0.0f, 0.0f}, 42);
+    const auto polygons = world->polygons(true);
+    ASSERT_EQ(polygons.size(), world->statistics().triangles());
+    // Every subtree is one range of the arena.
+    std::size_t offset = 0;
+    for (const auto &child : world->children()) {
+        EXPECT_EQ(child->polygons().data(), polygons.data() + offset);
+        offset += child->statistics().triangles();
+    }
+
+    // The slots are moved by edits which add and remove cubes, the arena built from scratch has to be the same.
+    const auto reference = create_random_world(2, {0.0f, 0.0f, 0.0f}, 42);
+    const auto edit = [&](const std::function<void(Cube &)> &change) {
+        change(*world);
+        change(*reference);
+        static_cast<void>(world->polygons(true));
+    };
+    edit([](Cube &cube) {
+        cube.children()[1]->set_type(Cube::Type::OCTANT);
+        cube.children()[1]->children()[3]->set_type(Cube::Type::SOLID);
+    });
+    edit([](Cube &cube) { cube.children()[6]->set_type(Cube::Type::EMPTY); });
+    edit([](Cube &cube) { cube.children()[2]->rotate(Cube::RotationAxis::Y, 1); });
+    edit([](Cube &cube) {
+        cube.children()[5]->set_type(Cube::Type::NORMAL);
+        cube.children()[5]->indent(4, true, 2);
+    });
+    EXPECT_EQ(flatten(world->polygons()), flatten(reference->polygons(true)));
+
+    // A removed subtree gets its own arena.
+    world->children()[0]->set_type(Cube::Type::OCTANT);
+    const auto removed = world->children()[0]->children()[7];
+    removed->set_type(Cube::Type::SOLID);
+    static_cast<void>(world->polygons(true));
+    world->children()[0]->set_type(Cube::Type::EMPTY);
+    ASSERT_TRUE(removed->is_root());
+    Cube solid(removed->size(), removed->position());
+    solid.set_type(Cube::Type::SOLID);
+    EXPECT_EQ(flatten(removed->polygons(true)), flatten(solid.polygons(true)));
+}
+
+TEST(Cube, dirty_tracking) {
+    const auto world = create_random_world(3, {0.0f, 0.0f, 0.0f}, 42);
+    EXPECT_TRUE(world->subtree_dirty());
+    EXPECT_EQ(world->update_polygon_caches().size(), 8 * 8 * 8 * 8);
+    EXPECT_FALSE(world->subtree_dirty());
+    EXPECT_TRUE(world->update_polygon_caches().empty());
+
+    const auto octant = world->children()[2]->children()[5];
+    const auto leaf = octant->children()[1]->children()[6];
+    leaf->set_type(Cube::Type::SOLID);
+    EXPECT_TRUE(world->subtree_dirty());
+    EXPECT_TRUE(octant->subtree_dirty());
+    EXPECT_FALSE(world->children()[3]->subtree_dirty());
+
+    const auto changed = world->update_polygon_caches();
+    ASSERT_EQ(changed.size(), 1);
+    EXPECT_EQ(changed[0], leaf);
+    EXPECT_FALSE(world->subtree_dirty());
+
+    octant->rotate(Cube::RotationAxis::Z, 1);
+    EXPECT_EQ(world->update_polygon_caches().size(), 8 * 8);
+}
+
+TEST(Cube, visible_polygons) {
+    std::shared_ptr<Cube> root = std::make_shared<Cube>(2.0f, glm::vec3{0, 0, 0});
+    root->set_type(Cube::Type::OCTANT);
+    for (const auto &child : root->children()) {
+        child->set_type(Cube::Type::SOLID);
+    }
+    // Every cube of a filled octant has three inner and three outer faces.
+    EXPECT_EQ(root->visible_polygons(true).size(), 8 * 3 * 2);
+    EXPECT_EQ(root->children()[0]->hidden_faces(), 0b101010);
+
+    // A normal cube does not hide its neighbors, but its own flat faces are hidden by solid neighbors.
+    root->children()[7]->set_type(Cube::Type::NORMAL);
+    EXPECT_EQ(root->visible_polygons(true).size(), 8 * 3 * 2 + 3 * 2);
+    // Indenting moves one corner, so two of its inner faces are no longer flat on the boundary of the cube.
+    root->children()[7]->indent(0, true, 3);
+    EXPECT_GT(root->visible_polygons(true).size(), 8 * 3 * 2 + 3 * 2);
+}
+
+TEST(Cube, compact) {
+    std::shared_ptr<Cube> root = std::make_shared<Cube>(2.0f, glm::vec3{0, 0, 0});
+    root->set_type(Cube::Type::OCTANT);
+    for (const auto &child : root->children()) {
+        child->set_type(Cube::Type::OCTANT);
+        for (const auto &grandchild : child->children()) {
+            grandchild->set_type(Cube::Type::SOLID);
+        }
+    }
+    root->children()[1]->children()[4]->set_type(Cube::Type::EMPTY);
+    root->children()[2]->children()[2]->set_type(Cube::Type::OCTANT);
+    for (const auto &cube : root->children()[2]->children()[2]->children()) {
+        cube->set_type(Cube::Type::SOLID);
+    }
+    // The merged octant makes its parent uniform, which is merged too.
+    EXPECT_EQ(root->compact(), 7 * 8 + 8);
+    EXPECT_EQ(root->children()[0]->type(), Cube::Type::SOLID);
+    EXPECT_EQ(root->children()[1]->type(), Cube::Type::OCTANT);
+    EXPECT_EQ(root->children()[2]->type(), Cube::Type::SOLID);
+    EXPECT_EQ(root->compact(), 0);
+
+    root->children()[1]->children()[4]->set_type(Cube::Type::SOLID);
+    EXPECT_EQ(root->compact(), 2 * 8);
+    EXPECT_EQ(root->type(), Cube::Type::SOLID);
+    EXPECT_EQ(root->polygons(true).size(), 12);
+}
+
+TEST(Cube, auto_compaction) {
+    std::shared_ptr<Cube> root = std::make_shared<Cube>(2.0f, glm::vec3{0, 0, 0});
+    root->set_auto_compaction(true);
+    root->set_type(Cube::Type::OCTANT);
+    root->children()[5]->set_type(Cube::Type::OCTANT);
+    EXPECT_TRUE(root->children()[5]->children()[0]->auto_compaction());
+
+    for (std::size_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+        root->children()[5]->children()[idx]->set_type(Cube::Type::SOLID);
+        EXPECT_EQ(root->children()[5]->type(), idx + 1 < Cube::SUB_CUBES ? Cube::Type::OCTANT : Cube::Type::SOLID);
+    }
+    // The last edit collapses all parents whose children became uniform.
+    root->children()[5]->set_type(Cube::Type::EMPTY);
+    EXPECT_EQ(root->type(), Cube::Type::EMPTY);
+}
+
+TEST(Cube, detached_subtree) {
+    std::shared_ptr<Cube> root = std::make_shared<Cube>(2.0f, glm::vec3{0, 0, 0});
+    root->set_auto_compaction(true);
+    root->set_type(Cube::Type::OCTANT);
+    for (std::size_t idx = 1; idx < Cube::SUB_CUBES; idx++) {
+        root->children()[idx]->set_type(Cube::Type::SOLID);
+    }
+    root->update_polygon_caches();
+    const auto subtree = root->children()[3];
+    {
+        const Cube::DetachedSubtree detached(*subtree);
+        EXPECT_TRUE(subtree->is_root());
+        subtree->set_type(Cube::Type::OCTANT);
+        for (const auto &child : subtree->children()) {
+            child->set_type(Cube::Type::SOLID);
+        }
+        // The parents are neither collapsed, nor written to.
+        EXPECT_EQ(subtree->type(), Cube::Type::SOLID);
+        EXPECT_EQ(root->type(), Cube::Type::OCTANT);
+        EXPECT_FALSE(root->subtree_dirty());
+        EXPECT_EQ(root->statistics().octants, 1);
+        subtree->set_type(Cube::Type::OCTANT);
+        for (std::size_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+            if (idx != 4) {
+                subtree->children()[idx]->set_type(Cube::Type::SOLID);
+            }
+        }
+    }
+    EXPECT_FALSE(subtree->is_root());
+    EXPECT_TRUE(root->subtree_dirty());
+    EXPECT_EQ(root->statistics().octants, 2);
+    EXPECT_EQ(root->statistics().solid_cubes, 6 + 7);
+    EXPECT_EQ(root->statistics().empty_cubes, 1 + 1);
+    EXPECT_EQ(root->statistics().depth, 2);
+    EXPECT_EQ(subtree->children()[4]->neighbor(Cube::NeighborAxis::X, Cube::NeighborDirection::POSITIVE),
+              root->children()[7]);
+}
+
+TEST(Cube, level_of_detail) {
+    std::shared_ptr<Cube> root = std::make_shared<Cube>(2.0f, glm::vec3{0, 0, 0});
+    root->set_type(Cube::Type::OCTANT);
+    root->children()[0]->set_type(Cube::Type::OCTANT);
+    for (std::size_t idx = 0; idx < 6; idx++) {
+        root->children()[idx + 1]->set_type(Cube::Type::SOLID);
+        root->children()[0]->children()[idx]->set_type(Cube::Type::NORMAL);
+    }
+    EXPECT_FLOAT_EQ(root->children()[0]->occupancy(), 6.0f / 8.0f);
+    EXPECT_FLOAT_EQ(root->occupancy(), (6.0f + 6.0f / 8.0f) / 8.0f);
+
+    // Close by, every cube is drawn like polygons() does, as one range of the arena.
+    const auto polygons = root->polygons(true);
+    const auto close = root->lod_polygons({1.0f, 1.0f, 1.0f}, 0.1f);
+    ASSERT_EQ(close.size(), 1);
+    EXPECT_EQ(close[0].data(), polygons.data());
+    EXPECT_EQ(close[0].size(), polygons.size());
+    // Far away, the whole octree is a single box.
+    const auto far = root->lod_polygons({100.0f, 0.0f, 0.0f}, 0.1f);
+    ASSERT_EQ(far.size(), 1);
+    Cube box(2.0f, {0, 0, 0});
+    box.set_type(Cube::Type::SOLID);
+    EXPECT_EQ(flatten(far[0]), flatten(box.polygons(true)));
+    EXPECT_TRUE(root->lod_polygons({100.0f, 0.0f, 0.0f}, 0.1f, 0.9f).empty());
+    // In between, only the small octant is replaced.
+    EXPECT_EQ(flatten(root->lod_polygons({20.0f, 0.0f, 0.0f}, 0.1f)).size(), (6 + 1) * 12);
+
+    // Only camera movements which replace an octant by its proxy or the other way round change the polygons.
+    EXPECT_TRUE(root->lod_selection_changed({1.0f, 1.0f, 1.0f}, {20.0f, 0.0f, 0.0f}, 0.1f));
+    EXPECT_TRUE(root->lod_selection_changed({20.0f, 0.0f, 0.0f}, {100.0f, 0.0f, 0.0f}, 0.1f));
+    EXPECT_FALSE(root->lod_selection_changed({20.0f, 0.0f, 0.0f}, {21.0f, 0.0f, 0.0f}, 0.1f));
+    EXPECT_FALSE(root->lod_selection_changed({100.0f, 0.0f, 0.0f}, {200.0f, 0.0f, 0.0f}, 0.1f));
+    EXPECT_FALSE(root->children()[1]->lod_selection_changed({1.0f, 1.0f, 1.0f}, {100.0f, 0.0f, 0.0f}, 0.1f));
+
+    // Edits release the cached proxies.
+    root->children()[0]->children()[6]->set_type(Cube::Type::SOLID);
+    EXPECT_FLOAT_EQ(root->children()[0]->occupancy(), 7.0f / 8.0f);
+    root->children()[0]->set_type(Cube::Type::EMPTY);
+    EXPECT_FLOAT_EQ(root->occupancy(), 6.0f / 8.0f);
+}
+
+TEST(Cube, statistics) {
+    const auto world = create_random_world(2, {0.0f, 0.0f, 0.0f}, 42);
+    const auto expected = [](const Cube &root) {
+        SubtreeStatistics statistics;
+        traverse_pre_order(root, [&](const Cube &cube, const std::size_t depth) {
+            statistics.empty_cubes += cube.type() == Cube::Type::EMPTY ? 1 : 0;
+            statistics.solid_cubes += cube.type() == Cube::Type::SOLID ? 1 : 0;
+            statistics.normal_cubes += cube.type() == Cube::Type::NORMAL ? 1 : 0;
+            statistics.octants += cube.type() == Cube::Type::OCTANT ? 1 : 0;
+            statistics.depth = std::max(statistics.depth, depth);
+        });
+        return statistics;
+    };
+    const auto check = [&](const Cube &cube) {
+        const auto statistics = expected(cube);
+        EXPECT_EQ(cube.statistics().empty_cubes, statistics.empty_cubes);
+        EXPECT_EQ(cube.statistics().solid_cubes, statistics.solid_cubes);
+        EXPECT_EQ(cube.statistics().normal_cubes, statistics.normal_cubes);
+        EXPECT_EQ(cube.statistics().octants, statistics.octants);
+        EXPECT_EQ(cube.statistics().depth, statistics.depth);
+    };
+    check(*world);
+    EXPECT_EQ(world->statistics().depth, 3);
+    EXPECT_EQ(world->statistics().triangles(), world->polygons(true).size());
+
+    // A deeper subtree, an octant which is replaced and an octant which is collapsed.
+    const auto octant = world->children()[4]->children()[2]->children()[6];
+    octant->set_type(Cube::Type::OCTANT);
+    octant->children()[1]->set_type(Cube::Type::SOLID);
+    world->children()[7]->set_type(Cube::Type::NORMAL);
+    check(*world);
+    EXPECT_EQ(world->statistics().depth, 4);
+    check(*world->children()[4]);
+    octant->set_type(Cube::Type::EMPTY);
+    for (const auto &cube : world->children()[1]->children()[3]->children()) {
+        cube->set_type(Cube::Type::SOLID);
+    }
+    world->compact();
+    check(*world);
+    EXPECT_EQ(world->statistics().depth, 3);
+    check(*world->clone());
+}
+
+TEST(Cube, grid_level) {
+    const auto world = create_random_world(2, {0.0f, 0.0f, 0.0f}, 42);
+    EXPECT_EQ(world->grid_level(), 0);
+    EXPECT_EQ(world->children()[3]->grid_level(), 1);
+    EXPECT_EQ(world->children()[3]->children()[5]->children()[0]->grid_level(), 3);
+}
+
+TEST(Cube, max_depth) {
+    const auto world = std::make_shared<Cube>(8.0f, glm::vec3{0.0f, 0.0f, 0.0f});
+    std::shared_ptr<Cube> cube = world;
+    for (std::size_t level = 0; level < Cube::MAX_DEPTH; level++) {
+        cube->set_type(Cube::Type::OCTANT);
+        cube = (*cube)[7];
+    }
+    EXPECT_EQ(cube->grid_level(), Cube::MAX_DEPTH);
+    EXPECT_EQ(cube->locational_code(), std::numeric_limits<std::uint64_t>::max());
+    EXPECT_EQ(world->statistics().depth, Cube::MAX_DEPTH);
+
+    // The children would not fit into the locational code, the cube stays as it is.
+    EXPECT_THROW(cube->set_type(Cube::Type::OCTANT), inexor::vulkan_renderer::InexorException);
+    EXPECT_EQ(cube->type(), Cube::Type::EMPTY);
+    EXPECT_EQ(world->statistics().depth, Cube::MAX_DEPTH);
+
+    // The traversal stack holds the deepest octree.
+    std::size_t deepest = 0;
+    traverse_pre_order(*world, [&](const Cube &, const std::size_t depth) { deepest = std::max(deepest, depth); });
+    EXPECT_EQ(deepest, Cube::MAX_DEPTH);
+
+    const auto neighbor = cube->neighbor(Cube::NeighborAxis::X, Cube::NeighborDirection::NEGATIVE);
+    ASSERT_NE(neighbor, nullptr);
+    EXPECT_EQ(neighbor->grid_level(), Cube::MAX_DEPTH);
+    EXPECT_EQ(neighbor->position() + neighbor->size() * glm::vec3(1.0f, 0.0f, 0.0f), cube->position());
+}
+
 } // namespace
@@ -2,6 +2,13 @@
 
 #include <inexor/vulkan-renderer/world/collision_query.hpp>
 #include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/octree_traversal.hpp>
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <random>
 
 namespace inexor::vulkan_renderer {
 
@@ -28,4 +35,149 @@ TEST(CubeCollision, CollisionCheck) {
     EXPECT_TRUE(collision_found);
 }
 
+/// The parameter at which the ray enters the box, or 0 if it starts inside. Brute force reference for the traversal.
+std::optional<float> entry_parameter(const std::array<glm::vec3, 2> &box_bounds, const glm::vec3 &pos,
+                                     const glm::vec3 &dir) {
+    float near = 0.0f;
+    float far = std::numeric_limits<float>::infinity();
+    for (glm::vec3::length_type axis = 0; axis < 3; axis++) {
+        if (dir[axis] == 0.0f) {
+            if (pos[axis] < box_bounds[0][axis] || pos[axis] > box_bounds[1][axis]) {
+                return std::nullopt;
+            }
+            continue;
+        }
+        const float t0 = (box_bounds[0][axis] - pos[axis]) / dir[axis];
+        const float t1 = (box_bounds[1][axis] - pos[axis]) / dir[axis];
+        near = std::max(near, std::min(t0, t1));
+        far = std::min(far, std::max(t0, t1));
+    }
+    return near <= far ? std::make_optional(near) : std::nullopt;
+}
+
+/// The distance at which a ray hits a triangle, from the plane of the triangle. Brute force reference for the
+/// vectorised triangle test.
+std::optional<float> triangle_distance(const world::Polygon &triangle, const glm::vec3 &pos, const glm::vec3 &dir) {
+    const glm::vec3 normal = glm::cross(triangle[1] - triangle[0], triangle[2] - triangle[0]);
+    const float denominator = glm::dot(normal, dir);
+    if (denominator == 0.0f) {
+        return std::nullopt;
+    }
+    const float distance = glm::dot(normal, triangle[0] - pos) / denominator;
+    if (distance < 0.0f) {
+        return std::nullopt;
+    }
+    // The intersection must be on the inner side of every edge.
+    const glm::vec3 intersection = pos + distance * dir;
+    for (std::size_t vertex = 0; vertex < 3; vertex++) {
+        const glm::vec3 &start = triangle[vertex];
+        const glm::vec3 &end = triangle[(vertex + 1) % 3];
+        if (glm::dot(glm::cross(end - start, intersection - start), normal) < 0.0f) {
+            return std::nullopt;
+        }
+    }
+    return distance;
+}
+
+TEST(CubeCollision, NearestLeaf) {
+    const auto world = world::create_random_world(4, {-2.0f, 3.0f, 1.0f}, 42);
+    std::vector<const world::Cube *> leaves;
+    world::traverse_pre_order(*world, [&](const world::Cube &cube) {
+        if (cube.type() == world::Cube::Type::SOLID || cube.type() == world::Cube::Type::NORMAL) {
+            leaves.push_back(&cube);
+        }
+    });
+
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> position(-4.0f, 8.0f);
+    std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+    std::uniform_int_distribution<int> zero_axis(0, 5);
+    std::size_t normal_hits = 0;
+    for (int idx = 0; idx < 1000; idx++) {
+        const glm::vec3 cam_pos = glm::vec3(position(generator), position(generator), position(generator)) +
+                                  world->position();
+        glm::vec3 cam_direction{direction(generator), direction(generator), direction(generator)};
+        // Axis aligned rays run along the faces between the cubes.
+        if (const int axis = zero_axis(generator); axis < 3) {
+            cam_direction[axis] = 0.0f;
+        }
+
+        std::optional<float> nearest;
+        for (const auto *leaf : leaves) {
+            std::optional<float> distance;
+            if (leaf->type() == world::Cube::Type::SOLID) {
+                distance = entry_parameter(leaf->bounding_box(), cam_pos, cam_direction);
+            } else {
+                for (const auto &triangle : leaf->triangles()) {
+                    const auto triangle_hit = triangle_distance(triangle, cam_pos, cam_direction);
+                    if (triangle_hit && (!distance || *triangle_hit < *distance)) {
+                        distance = triangle_hit;
+                    }
+                }
+            }
+            if (distance && (!nearest || *distance < *nearest)) {
+                nearest = distance;
+            }
+        }
+
+        const auto collision = ray_cube_collision_check(*world, cam_pos, cam_direction);
+        ASSERT_EQ(collision.has_value(), nearest.has_value());
+        if (!collision) {
+            continue;
+        }
+        if (collision->cube().type() == world::Cube::Type::NORMAL) {
+            ASSERT_TRUE(collision->triangle().has_value());
+            EXPECT_NEAR(collision->triangle()->distance, *nearest, 1e-4f);
+            normal_hits++;
+            continue;
+        }
+        EXPECT_EQ(collision->cube().type(), world::Cube::Type::SOLID);
+        EXPECT_FALSE(collision->triangle().has_value());
+        const auto entry = entry_parameter(collision->cube().bounding_box(), cam_pos, cam_direction);
+        ASSERT_TRUE(entry.has_value());
+        EXPECT_NEAR(*entry, *nearest, 1e-4f);
+    }
+    EXPECT_GT(normal_hits, 0);
+}
+
+TEST(CubeCollision, NormalCubeTriangle) {
+    world::Cube cube(1.0f, {0.0f, 0.0f, 0.0f});
+    cube.set_type(world::Cube::Type::NORMAL);
+
+    // The ray misses the bounding box.
+    EXPECT_FALSE(world::ray_normal_cube_collision(cube, {2.0f, 0.5f, 2.0f}, {0.0f, 0.0f, -1.0f}));
+
+    // The face at z = 1 consists of the triangles 10 and 11, of which the first one has the vertices (0, 0, 1),
+    // (0, 1, 1) and (1, 0, 1).
+    const auto hit = world::ray_normal_cube_collision(cube, {0.25f, 0.5f, 2.0f}, {0.0f, 0.0f, -1.0f});
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(hit->triangle, 10);
+    EXPECT_FLOAT_EQ(hit->distance, 1.0f);
+    EXPECT_FLOAT_EQ(hit->u, 0.5f);
+    EXPECT_FLOAT_EQ(hit->v, 0.25f);
+
+    const auto collision = ray_cube_collision_check(cube, {0.25f, 0.5f, 2.0f}, {0.0f, 0.0f, -1.0f});
+    ASSERT_TRUE(collision.has_value());
+    ASSERT_TRUE(collision->triangle().has_value());
+    EXPECT_EQ(collision->triangle()->triangle, 10);
+    EXPECT_FLOAT_EQ(collision->intersection().z, 1.0f);
+}
+
+TEST(CubeCollision, TriangleFace) {
+    world::Cube cube(1.0f, {0.0f, 0.0f, 0.0f});
+    cube.set_type(world::Cube::Type::NORMAL);
+
+    // The ray enters the bounding box through the face at x = 1.
+    const world::RayCubeCollision<world::Cube> box_collision(cube, {2.0f, 0.5f, 0.5f}, {-1.0f, 0.0f, 0.0f});
+    EXPECT_EQ(box_collision.face(), glm::vec3(1.0f, 0.5f, 0.5f));
+
+    // But it hits triangle 10, which belongs to the face at z = 1, like an indented face would be hit.
+    const world::RayTriangleHit hit{.triangle = 10, .distance = 1.5f};
+    const world::RayCubeCollision<world::Cube> collision(cube, {2.0f, 0.5f, 0.5f}, {-1.0f, 0.0f, 0.0f}, hit);
+    EXPECT_EQ(collision.intersection(), glm::vec3(0.5f, 0.5f, 0.5f));
+    EXPECT_EQ(collision.face(), glm::vec3(0.5f, 0.5f, 1.0f));
+    EXPECT_FLOAT_EQ(collision.corner().z, 1.0f);
+    EXPECT_FLOAT_EQ(collision.edge().z, 1.0f);
+}
+
 } // namespace inexor::vulkan_renderer
@@ -0,0 +1,172 @@
+#include <inexor/vulkan-renderer/exception.hpp>
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/edit_transaction.hpp>
+#include <inexor/vulkan-renderer/world/octree_traversal.hpp>
+
+#include <gtest/gtest.h>
+
+#include <bit>
+#include <limits>
+#include <random>
+#include <tuple>
+
+namespace {
+using namespace inexor::vulkan_renderer::world;
+
+/// Locational code, type and indentations of every cube in pre-order.
+std::vector<std::tuple<std::uint64_t, Cube::Type, std::vector<std::uint8_t>>> describe(const Cube &root) {
+    std::vector<std::tuple<std::uint64_t, Cube::Type, std::vector<std::uint8_t>>> cubes;
+    traverse_pre_order(root, [&](const Cube &cube) {
+        std::vector<std::uint8_t> indentations;
+        if (cube.type() == Cube::Type::NORMAL) {
+            for (const auto &indentation : cube.indentations()) {
+                indentations.push_back(indentation.uid());
+            }
+        }
+        cubes.emplace_back(cube.locational_code(), cube.type(), std::move(indentations));
+    });
+    return cubes;
+}
+
+std::shared_ptr<Cube> find(const std::shared_ptr<Cube> &root, const std::uint64_t code) {
+    auto cube = root;
+    for (std::size_t level = (std::bit_width(code) - 1) / 3; level-- > 0;) {
+        if (cube->type() != Cube::Type::OCTANT) {
+            return nullptr;
+        }
+        cube = cube->children()[(code >> (3 * level)) & 0b111u];
+    }
+    return cube;
+}
+
+TEST(EditTransaction, same_result_as_single_edits) {
+    constexpr std::array TYPES{Cube::Type::EMPTY, Cube::Type::SOLID, Cube::Type::NORMAL, Cube::Type::OCTANT};
+    constexpr std::array AXES{Cube::RotationAxis::X, Cube::RotationAxis::Y, Cube::RotationAxis::Z};
+
+    for (std::uint32_t seed = 0; seed < 20; seed++) {
+        const auto expected = create_random_world(2, {0.0f, 0.0f, 0.0f}, seed);
+        const auto world = create_random_world(2, {0.0f, 0.0f, 0.0f}, seed);
+        EditTransaction transaction(world);
+
+        // Few distinct targets, so many edits overlap.
+        std::mt19937 mt(seed);
+        std::uniform_int_distribution<std::uint32_t> random(0, 1000);
+        for (std::size_t edit = 0; edit < 200; edit++) {
+            std::uint64_t code = 1;
+            for (std::size_t level = random(mt) % 4; level > 0; level--) {
+                code = (code << 3u) | (random(mt) % 2 == 0 ? 0 : 7);
+            }
+            const auto cube = find(expected, code);
+            const auto edge = static_cast<std::uint8_t>(random(mt) % Cube::EDGES);
+            switch (random(mt) % 8) {
+            case 0: {
+                const auto &axis = AXES[random(mt) % AXES.size()];
+                const int rotations = static_cast<int>(random(mt) % 4);
+                if (cube != nullptr) {
+                    cube->rotate(axis, rotations);
+                }
+                transaction.rotate(code, axis, rotations);
+                break;
+            }
+            case 1:
+            case 2: {
+                const auto steps = static_cast<std::uint8_t>(random(mt) % 3);
+                if (cube != nullptr) {
+                    cube->indent(edge, true, steps);
+                }
+                transaction.indent(code, edge, true, steps);
+                break;
+            }
+            case 3: {
+                const Indentation indentation(static_cast<std::uint8_t>(random(mt) % 3), Indentation::MAX);
+                if (cube != nullptr) {
+                    cube->set_indent(edge, indentation);
+                }
+                transaction.set_indent(code, edge, indentation);
+                break;
+            }
+            default: {
+                const auto type = TYPES[random(mt) % TYPES.size()];
+                if (cube != nullptr) {
+                    cube->set_type(type);
+                }
+                transaction.set_type(code, type);
+                break;
+            }
+            }
+        }
+        EXPECT_LE(transaction.pending_edits(), 200);
+        const auto region = transaction.commit();
+        EXPECT_EQ(region.queued_edits, 200);
+        EXPECT_EQ(transaction.pending_edits(), 0);
+        EXPECT_EQ(describe(*world), describe(*expected)) << "seed " << seed;
+    }
+}
+
+TEST(EditTransaction, coalesce) {
+    const auto world = std::make_shared<Cube>(2.0f, glm::vec3{0, 0, 0});
+    world->set_type(Cube::Type::OCTANT);
+    EditTransaction transaction(world);
+
+    // A brush fills an octant, which is overwritten afterwards.
+    transaction.set_type(0b1'001, Cube::Type::OCTANT);
+    for (std::uint64_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+        transaction.set_type((0b1'001 << 3u) | idx, Cube::Type::NORMAL);
+        transaction.indent((0b1'001 << 3u) | idx, 0, true, 2);
+    }
+    transaction.set_type(0b1'001, Cube::Type::SOLID);
+    // Indentations of the same edge are overwritten.
+    transaction.set_type(0b1'110, Cube::Type::NORMAL);
+    transaction.set_indent(0b1'110, 3, Indentation(1, 8));
+    transaction.set_indent(0b1'110, 3, Indentation(2, 8));
+    // Consecutive rotations are merged.
+    transaction.rotate(0b1'110, Cube::RotationAxis::X, 1);
+    transaction.rotate(0b1'110, Cube::RotationAxis::X, 3);
+    EXPECT_EQ(transaction.pending_edits(), 3);
+
+    const auto region = transaction.commit();
+    EXPECT_EQ(region.queued_edits, 23);
+    EXPECT_EQ(region.applied_edits, 3);
+    EXPECT_EQ(world->children()[1]->type(), Cube::Type::SOLID);
+    EXPECT_EQ(world->children()[6]->indentations()[3], Indentation(2, 8));
+
+    ASSERT_EQ(region.subtrees.size(), 2);
+    EXPECT_EQ(region.subtrees[0], world->children()[1]);
+    EXPECT_EQ(region.subtrees[1], world->children()[6]);
+    EXPECT_EQ(region.bounding_box[0], glm::vec3(0.0f, 0.0f, 0.0f));
+    EXPECT_EQ(region.bounding_box[1], glm::vec3(2.0f, 2.0f, 2.0f));
+    EXPECT_TRUE(region.subtrees[0]->subtree_dirty());
+    EXPECT_TRUE(transaction.commit().empty());
+}
+
+TEST(EditTransaction, auto_compaction) {
+    const auto world = std::make_shared<Cube>(2.0f, glm::vec3{0, 0, 0});
+    world->set_type(Cube::Type::OCTANT);
+    world->children()[5]->set_type(Cube::Type::OCTANT);
+    world->set_auto_compaction(true);
+
+    // Every single edit would collapse the octant, the transaction only collapses the final state.
+    EditTransaction transaction(world);
+    for (std::uint64_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+        transaction.set_type((0b1'101 << 3u) | idx, Cube::Type::SOLID);
+    }
+    transaction.set_type(0b1'101'000, Cube::Type::EMPTY);
+    transaction.set_type(0b1'101'000, Cube::Type::SOLID);
+    const auto region = transaction.commit();
+    EXPECT_EQ(world->children()[5]->type(), Cube::Type::SOLID);
+    ASSERT_EQ(region.subtrees.size(), 1);
+    EXPECT_EQ(region.subtrees[0], world->children()[5]);
+}
+
+TEST(EditTransaction, max_depth) {
+    const auto world = std::make_shared<Cube>(2.0f, glm::vec3{0, 0, 0});
+    EditTransaction transaction(world);
+    // The deepest cube, whose children would not fit into the locational code.
+    EXPECT_THROW(transaction.set_type(std::numeric_limits<std::uint64_t>::max(), Cube::Type::OCTANT),
+                 inexor::vulkan_renderer::InexorException);
+    EXPECT_EQ(transaction.pending_edits(), 0);
+    transaction.set_type(std::numeric_limits<std::uint64_t>::max(), Cube::Type::SOLID);
+    EXPECT_EQ(transaction.pending_edits(), 1);
+}
+
+} // namespace
@@ -0,0 +1,57 @@
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/frustum.hpp>
+#include <inexor/vulkan-renderer/world/octree_traversal.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <gtest/gtest.h>
+
+namespace {
+using namespace inexor::vulkan_renderer::world;
+
+// Looking from the origin along the negative z axis with a field of view of 90 degrees.
+const Frustum FRUSTUM(glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f)),
+                      glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f));
+
+TEST(Frustum, classify) {
+    EXPECT_EQ(FRUSTUM.classify({glm::vec3(-1.0f, -1.0f, -10.0f), glm::vec3(1.0f, 1.0f, -8.0f)}),
+              Frustum::Containment::INSIDE);
+    // Behind the camera, beyond the far plane and left of the left plane.
+    EXPECT_EQ(FRUSTUM.classify({glm::vec3(-1.0f, -1.0f, 1.0f), glm::vec3(1.0f, 1.0f, 3.0f)}),
+              Frustum::Containment::OUTSIDE);
+    EXPECT_EQ(FRUSTUM.classify({glm::vec3(-1.0f, -1.0f, -120.0f), glm::vec3(1.0f, 1.0f, -110.0f)}),
+              Frustum::Containment::OUTSIDE);
+    EXPECT_EQ(FRUSTUM.classify({glm::vec3(-20.0f, -1.0f, -10.0f), glm::vec3(-12.0f, 1.0f, -8.0f)}),
+              Frustum::Containment::OUTSIDE);
+    // Crossing the left plane and the near plane.
+    EXPECT_EQ(FRUSTUM.classify({glm::vec3(-12.0f, -1.0f, -10.0f), glm::vec3(-8.0f, 1.0f, -8.0f)}),
+              Frustum::Containment::INTERSECTING);
+    EXPECT_EQ(FRUSTUM.classify({glm::vec3(-1.0f, -1.0f, -1.0f), glm::vec3(1.0f, 1.0f, 1.0f)}),
+              Frustum::Containment::INTERSECTING);
+}
+
+TEST(Frustum, visible_subtrees) {
+    const auto world = create_random_world(3, {-6.0f, -2.0f, -6.0f}, 42);
+    world->update_polygon_caches();
+
+    // Test every subtree on its own.
+    std::vector<const Cube *> expected;
+    std::size_t subtrees = 0;
+    traverse_pre_order(*world, [&](const Cube &cube, const std::size_t depth) {
+        if (cube.type() == Cube::Type::OCTANT && depth < 2) {
+            return TraversalAction::CONTINUE;
+        }
+        subtrees++;
+        if (cube.type() != Cube::Type::EMPTY &&
+            FRUSTUM.classify(cube.bounding_box()) != Frustum::Containment::OUTSIDE) {
+            expected.push_back(&cube);
+        }
+        return TraversalAction::SKIP_CHILDREN;
+    });
+
+    const auto visible = visible_subtrees(*world, FRUSTUM, 2);
+    EXPECT_EQ(visible, expected);
+    EXPECT_GT(visible.size(), 0);
+    EXPECT_LT(visible.size(), subtrees);
+}
+
+} // namespace
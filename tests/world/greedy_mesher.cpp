@@ -0,0 +1,99 @@
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/greedy_mesher.hpp>
+
+#include <gtest/gtest.h>
+
+namespace {
+using namespace inexor::vulkan_renderer::world;
+
+TEST(GreedyMesher, solid_octant) {
+    const auto root = std::make_shared<Cube>(2.0f, glm::vec3{1.0f, 0.0f, 0.0f});
+    root->set_type(Cube::Type::OCTANT);
+    for (const auto &child : root->children()) {
+        child->set_type(Cube::Type::SOLID);
+    }
+    // The eight solid children look like one solid cube.
+    const auto polygons = greedy_mesh(*root, true);
+    ASSERT_EQ(polygons.size(), 12);
+    for (const auto &polygon : polygons) {
+        for (const auto &vertex : polygon) {
+            EXPECT_TRUE(vertex.x == 1.0f || vertex.x == 3.0f);
+            EXPECT_TRUE(vertex.y == 0.0f || vertex.y == 2.0f);
+            EXPECT_TRUE(vertex.z == 0.0f || vertex.z == 2.0f);
+        }
+    }
+
+    // Removing one child leaves three rectangles on every side which touches it.
+    root->children()[7]->set_type(Cube::Type::EMPTY);
+    EXPECT_LT(greedy_mesh(*root, true).size(), 12 * 7 - 3 * 2 * 2);
+}
+
+TEST(GreedyMesher, surface) {
+    // A world of solid cubes only, on a grid of 8 x 8 x 8 cells.
+    constexpr int RESOLUTION = 8;
+    const auto world = create_random_world(2, {0.0f, 0.0f, 0.0f}, 42);
+    const float cell_size = world->size() / RESOLUTION;
+    std::array<std::array<std::array<bool, RESOLUTION>, RESOLUTION>, RESOLUTION> solid{};
+    std::vector<std::shared_ptr<Cube>> stack{world};
+    while (!stack.empty()) {
+        const auto cube = stack.back();
+        stack.pop_back();
+        if (cube->type() == Cube::Type::OCTANT) {
+            stack.insert(stack.end(), cube->children().begin(), cube->children().end());
+            continue;
+        }
+        if (cube->type() == Cube::Type::NORMAL) {
+            cube->set_type(Cube::Type::SOLID);
+        }
+        const auto cell = cube->position() / cell_size;
+        solid[static_cast<int>(cell.x)][static_cast<int>(cell.y)][static_cast<int>(cell.z)] =
+            cube->type() == Cube::Type::SOLID;
+    }
+
+    // Count the faces between a solid and a non-solid cell by the direction of their triangle normals, which point
+    // into the cube like the ones of the polygon cache.
+    std::array<float, 6> expected_area{};
+    const auto is_solid = [&](const std::array<int, 3> &cell) {
+        for (const int coordinate : cell) {
+            if (coordinate < 0 || coordinate >= RESOLUTION) {
+                return false;
+            }
+        }
+        return solid[cell[0]][cell[1]][cell[2]];
+    };
+    for (int x = 0; x < RESOLUTION; x++) {
+        for (int y = 0; y < RESOLUTION; y++) {
+            for (int z = 0; z < RESOLUTION; z++) {
+                if (!solid[x][y][z]) {
+                    continue;
+                }
+                for (int axis = 0; axis < 3; axis++) {
+                    for (const int direction : {-1, 1}) {
+                        std::array<int, 3> neighbor{x, y, z};
+                        neighbor[axis] += direction;
+                        if (!is_solid(neighbor)) {
+                            expected_area[axis * 2 + (direction < 0 ? 1 : 0)] += cell_size * cell_size;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    const auto polygons = greedy_mesh(*world, true);
+    std::array<float, 6> area{};
+    for (const auto &polygon : polygons) {
+        const glm::vec3 normal = glm::cross(polygon[1] - polygon[0], polygon[2] - polygon[0]);
+        for (int axis = 0; axis < 3; axis++) {
+            if (normal[axis] != 0.0f) {
+                area[axis * 2 + (normal[axis] > 0.0f ? 1 : 0)] += std::abs(normal[axis]) / 2;
+            }
+        }
+    }
+    for (std::size_t idx = 0; idx < area.size(); idx++) {
+        EXPECT_FLOAT_EQ(area[idx], expected_area[idx]);
+    }
+    EXPECT_LT(polygons.size(), world->visible_polygons(true).size());
+}
+
+} // namespace
@@ -0,0 +1,172 @@
+#include <inexor/vulkan-renderer/exception.hpp>
+#include <inexor/vulkan-renderer/world/collision_query.hpp>
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/linear_octree.hpp>
+
+#include "polygons.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+using namespace inexor::vulkan_renderer::world;
+
+TEST(LinearOctree, conversion) {
+    const auto world = create_random_world(3, {1.0f, 2.0f, 3.0f}, 42);
+    const LinearOctree octree(*world);
+
+    EXPECT_EQ(octree.count_geometry_cubes(), world->count_geometry_cubes());
+    EXPECT_EQ(octree.polygons(), flatten(world->polygons(true)));
+    EXPECT_EQ(octree.to_cube()->polygons(true).size(), world->polygons(true).size());
+    EXPECT_EQ(flatten(octree.to_cube()->polygons(true)), flatten(world->polygons(true)));
+}
+
+TEST(LinearOctree, neighbor) {
+    const auto world = create_random_world(2, {0.0f, 0.0f, 0.0f}, 7);
+    const LinearOctree octree(*world);
+
+    constexpr std::array AXES{Cube::NeighborAxis::X, Cube::NeighborAxis::Y, Cube::NeighborAxis::Z};
+    constexpr std::array DIRECTIONS{Cube::NeighborDirection::POSITIVE, Cube::NeighborDirection::NEGATIVE};
+
+    // Walk both trees in parallel and compare the position of every neighbor.
+    std::vector<std::pair<std::shared_ptr<Cube>, LinearOctree::NodeId>> stack{{world, LinearOctree::ROOT}};
+    while (!stack.empty()) {
+        const auto [cube, id] = stack.back();
+        stack.pop_back();
+        EXPECT_EQ(cube->position(), octree.position(id));
+        EXPECT_EQ(cube->size(), octree.size(id));
+        for (const auto axis : AXES) {
+            for (const auto direction : DIRECTIONS) {
+                const auto expected = cube->neighbor(axis, direction);
+                const auto actual = octree.neighbor(id, axis, direction);
+                ASSERT_EQ(expected == nullptr, actual == LinearOctree::INVALID_NODE);
+                if (expected != nullptr) {
+                    EXPECT_EQ(expected->position(), octree.position(actual));
+                    EXPECT_EQ(expected->size(), octree.size(actual));
+                }
+            }
+        }
+        for (std::size_t idx = 0; idx < Cube::SUB_CUBES && cube->type() == Cube::Type::OCTANT; idx++) {
+            stack.emplace_back(cube->children()[idx], octree.child(id, idx));
+        }
+    }
+}
+
+TEST(LinearOctree, rotate) {
+    const auto world = create_random_world(2, {0.0f, 0.0f, 0.0f}, 3);
+    LinearOctree octree(*world);
+
+    world->rotate(Cube::RotationAxis::Y, 1);
+    octree.rotate(LinearOctree::ROOT, Cube::RotationAxis::Y, 1);
+    world->children()[5]->rotate(Cube::RotationAxis::X, 3);
+    octree.rotate(octree.child(LinearOctree::ROOT, 5), Cube::RotationAxis::X, 3);
+
+    EXPECT_EQ(octree.polygons(), flatten(world->polygons(true)));
+
+    // The nodes which were moved by the rotations take over the locational codes of their new slots.
+    std::vector<std::pair<std::shared_ptr<Cube>, LinearOctree::NodeId>> stack{{world, LinearOctree::ROOT}};
+    while (!stack.empty()) {
+        const auto [cube, id] = stack.back();
+        stack.pop_back();
+        EXPECT_EQ(cube->locational_code(), octree.locational_code(id));
+        EXPECT_EQ(cube->position(), octree.position(id));
+        for (std::size_t idx = 0; idx < Cube::SUB_CUBES && cube->type() == Cube::Type::OCTANT; idx++) {
+            stack.emplace_back(cube->children()[idx], octree.child(id, idx));
+        }
+    }
+}
+
+// The linear octree rotates eagerly, while the rotations of octants are only recorded until their children are read.
+TEST(LinearOctree, lazy_rotation) {
+    const auto world = create_random_world(2, {0.0f, 0.0f, 0.0f}, 7);
+    world->children()[6]->set_type(Cube::Type::OCTANT);
+    world->children()[6]->children()[1]->set_type(Cube::Type::NORMAL);
+    world->children()[6]->children()[1]->set_indent(3, Indentation(2, 7));
+    LinearOctree octree(*world);
+    const auto octant = world->children()[6];
+    const auto leaf = octant->children()[1];
+    const glm::vec3 position = leaf->position();
+
+    // The rotations of the root are combined, nothing below it is touched.
+    world->rotate(Cube::RotationAxis::X, 1);
+    world->rotate(Cube::RotationAxis::Y, 2);
+    octree.rotate(LinearOctree::ROOT, Cube::RotationAxis::X, 1);
+    octree.rotate(LinearOctree::ROOT, Cube::RotationAxis::Y, 2);
+    EXPECT_EQ(leaf->position(), position);
+
+    // Reading the children of the root passes the rotation on to the octant, which is rotated again before its
+    // children are read.
+    const std::size_t slot = std::find(world->children().begin(), world->children().end(), octant) -
+                             world->children().begin();
+    EXPECT_EQ(octant->locational_code(), 0b1'000 | slot);
+    octant->rotate(Cube::RotationAxis::Z, 3);
+    octree.rotate(octree.child(LinearOctree::ROOT, slot), Cube::RotationAxis::Z, 3);
+    // Rotations which cancel each other out still move the children of the octant along with it.
+    world->rotate(Cube::RotationAxis::X, 1);
+    world->rotate(Cube::RotationAxis::X, 3);
+    EXPECT_EQ(leaf->position(), position);
+
+    EXPECT_EQ(octree.polygons(), flatten(world->polygons(true)));
+    EXPECT_NE(leaf->position(), position);
+}
+
+TEST(LinearOctree, ray_cube_collision_check) {
+    const auto world = create_random_world(3, {0.0f, 0.0f, 0.0f}, 11);
+    const LinearOctree octree(*world);
+
+    std::mt19937 generator(5);
+    std::uniform_real_distribution<float> coordinate(-4.0f, world->size() + 4.0f);
+    std::size_t hits = 0;
+    for (std::size_t ray = 0; ray < 500; ray++) {
+        const glm::vec3 pos{coordinate(generator), coordinate(generator), -1.0f};
+        const glm::vec3 target{coordinate(generator), coordinate(generator), world->size() + 1.0f};
+        for (const std::optional<std::uint32_t> max_depth : {std::optional<std::uint32_t>{}, std::optional(1u)}) {
+            const auto expected = ray_cube_collision_check(*world, pos, target - pos, max_depth);
+            const auto actual = ray_cube_collision_check(octree, pos, target - pos, max_depth);
+            ASSERT_EQ(expected.has_value(), actual.has_value());
+            if (!expected) {
+                continue;
+            }
+            hits++;
+            EXPECT_EQ(expected->cube().position(), actual->cube().position());
+            EXPECT_EQ(expected->cube().size(), actual->cube().size());
+            EXPECT_EQ(expected->cube().type(), actual->cube().type());
+            EXPECT_EQ(expected->intersection(), actual->intersection());
+            EXPECT_EQ(expected->face(), actual->face());
+            EXPECT_EQ(expected->triangle().has_value(), actual->triangle().has_value());
+        }
+    }
+    EXPECT_GT(hits, 0);
+}
+
+TEST(LinearOctree, reuse_nodes) {
+    LinearOctree octree(1.0f, {0.0f, 0.0f, 0.0f});
+    octree.set_type(LinearOctree::ROOT, Cube::Type::OCTANT);
+    octree.set_type(octree.child(LinearOctree::ROOT, 3), Cube::Type::OCTANT);
+    EXPECT_EQ(octree.node_count(), 17);
+    EXPECT_EQ(octree.grid_level(octree.child(octree.child(LinearOctree::ROOT, 3), 0)), 2);
+
+    octree.set_type(octree.child(LinearOctree::ROOT, 3), Cube::Type::SOLID);
+    EXPECT_EQ(octree.node_count(), 9);
+    octree.set_type(octree.child(LinearOctree::ROOT, 6), Cube::Type::OCTANT);
+    EXPECT_EQ(octree.node_count(), 17);
+}
+
+TEST(LinearOctree, max_depth) {
+    LinearOctree octree(8.0f, {0.0f, 0.0f, 0.0f});
+    LinearOctree::NodeId id = LinearOctree::ROOT;
+    for (std::size_t level = 0; level < LinearOctree::MAX_DEPTH; level++) {
+        octree.set_type(id, Cube::Type::OCTANT);
+        id = octree.child(id, 7);
+    }
+    EXPECT_EQ(octree.grid_level(id), Cube::MAX_DEPTH);
+    EXPECT_EQ(octree.size(id), std::ldexp(8.0f, -static_cast<int>(Cube::MAX_DEPTH)));
+    EXPECT_EQ(octree.position(id) + octree.size(id), glm::vec3(8.0f, 8.0f, 8.0f));
+    EXPECT_THROW(octree.set_type(id, Cube::Type::OCTANT), inexor::vulkan_renderer::InexorException);
+    EXPECT_EQ(octree.type(id), Cube::Type::EMPTY);
+}
+
+} // namespace
@@ -0,0 +1,49 @@
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/normal_cube_batch.hpp>
+#include <inexor/vulkan-renderer/world/octree_traversal.hpp>
+
+#include <gtest/gtest.h>
+
+namespace {
+using namespace inexor::vulkan_renderer::world;
+
+TEST(NormalCubeBatch, same_polygons_as_cube) {
+    const auto world = create_random_world(3, {-3.0f, 1.5f, 7.0f}, 42);
+    std::vector<const Cube *> normal_cubes;
+    NormalCubeBatch batch;
+    traverse_pre_order(std::as_const(*world), [&](const Cube &cube) {
+        if (cube.type() == Cube::Type::NORMAL) {
+            normal_cubes.push_back(&cube);
+            batch.add(cube);
+        }
+    });
+    // Some cubes don't fill all lanes, so the scalar kernel is tested too.
+    ASSERT_NE(normal_cubes.size() % NormalCubeBatch::lanes(), 0);
+    ASSERT_EQ(batch.size(), normal_cubes.size());
+    batch.compute();
+
+    for (std::size_t idx = 0; idx < normal_cubes.size(); idx++) {
+        normal_cubes[idx]->update_polygon_cache();
+        EXPECT_EQ(batch.polygons(idx), normal_cubes[idx]->triangles());
+    }
+}
+
+TEST(NormalCubeBatch, face_splits) {
+    Cube cube(2.0f, {0.0f, 0.0f, 0.0f});
+    cube.set_type(Cube::Type::NORMAL);
+    NormalCubeBatch batch;
+    batch.add(cube);
+    // Indent an edge at the end of the diagonal of the face x = 0, which would make it concave.
+    cube.set_indent(3, Indentation(4, 8));
+    batch.add(cube);
+    batch.compute();
+    EXPECT_EQ(batch.face_splits(0), 0);
+    EXPECT_EQ(batch.face_splits(1), 0b1);
+    EXPECT_EQ(batch.vertices(0)[2], glm::vec3(0.0f, 2.0f, 0.0f));
+    EXPECT_EQ(batch.vertices(1)[2], glm::vec3(1.0f, 2.0f, 0.0f));
+
+    batch.clear();
+    EXPECT_EQ(batch.size(), 0);
+}
+
+} // namespace
@@ -0,0 +1,69 @@
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/octree_snapshot.hpp>
+
+#include "polygons.hpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace {
+using namespace inexor::vulkan_renderer::world;
+
+TEST(OctreeSnapshot, structural_sharing) {
+    const auto world = create_random_world(2, {1.0f, 0.0f, 0.0f}, 42);
+    const OctreeSnapshot first = world->snapshot();
+    EXPECT_EQ(first.count_geometry_cubes(), world->count_geometry_cubes());
+    EXPECT_EQ(flatten(first.polygons()), flatten(world->polygons(true)));
+    const auto old_polygons = flatten(first.polygons());
+
+    // Nothing changed, so the same nodes are returned.
+    EXPECT_EQ(world->snapshot().root(), first.root());
+
+    // Only the path to the edited cube is copied.
+    world->children()[3]->children()[5]->set_type(Cube::Type::SOLID);
+    const OctreeSnapshot second = world->snapshot();
+    ASSERT_NE(second.root(), first.root());
+    for (std::size_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+        EXPECT_EQ(second.root()->children[idx] == first.root()->children[idx], idx != 3);
+        EXPECT_EQ(second.root()->children[3]->children[idx] == first.root()->children[3]->children[idx], idx != 5);
+    }
+    EXPECT_EQ(second.root()->children[3]->children[5]->type, Cube::Type::SOLID);
+    EXPECT_EQ(flatten(second.polygons()), flatten(world->polygons(true)));
+    EXPECT_EQ(flatten(first.polygons()), old_polygons);
+
+    // Rotations move all cubes of the subtree.
+    world->children()[6]->rotate(Cube::RotationAxis::Y, 1);
+    const OctreeSnapshot third = world->snapshot();
+    EXPECT_EQ(third.root()->children[3], second.root()->children[3]);
+    EXPECT_NE(third.root()->children[6], second.root()->children[6]);
+    EXPECT_EQ(flatten(third.polygons()), flatten(world->polygons(true)));
+
+    // A restored octree shares the nodes of the snapshot.
+    const auto restored = third.to_cube();
+    EXPECT_EQ(restored->snapshot().root(), third.root());
+    EXPECT_EQ(flatten(restored->polygons(true)), flatten(world->polygons()));
+    restored->children()[0]->set_type(Cube::Type::EMPTY);
+    EXPECT_EQ(restored->snapshot().root()->children[1], third.root()->children[1]);
+}
+
+TEST(OctreeSnapshot, concurrent_editing) {
+    const auto world = create_random_world(3, {0.0f, 0.0f, 0.0f}, 42);
+    const OctreeSnapshot snapshot = world->snapshot();
+    const auto expected = flatten(snapshot.polygons());
+
+    std::thread reader([&] {
+        for (std::size_t iteration = 0; iteration < 20; iteration++) {
+            EXPECT_EQ(flatten(snapshot.polygons()), expected);
+        }
+    });
+    for (std::size_t iteration = 0; iteration < 20; iteration++) {
+        const auto &child = world->children()[iteration % Cube::SUB_CUBES];
+        child->set_type(iteration % 2 == 0 ? Cube::Type::SOLID : Cube::Type::OCTANT);
+        static_cast<void>(world->polygons(true));
+        static_cast<void>(world->snapshot());
+    }
+    reader.join();
+}
+
+} // namespace
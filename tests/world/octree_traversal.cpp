@@ -0,0 +1,70 @@
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/octree_traversal.hpp>
+
+#include <gtest/gtest.h>
+
+namespace {
+using namespace inexor::vulkan_renderer::world;
+
+TEST(OctreeTraversal, order) {
+    const auto root = std::make_shared<Cube>(2.0f, glm::vec3{0, 0, 0});
+    root->set_type(Cube::Type::OCTANT);
+    root->children()[1]->set_type(Cube::Type::OCTANT);
+
+    std::vector<std::uint64_t> pre_order;
+    std::vector<std::uint64_t> post_order;
+    std::vector<std::size_t> depths;
+    EXPECT_TRUE(traverse(
+        std::as_const(*root),
+        [&](const Cube &cube, const std::size_t depth) {
+            pre_order.push_back(cube.locational_code());
+            depths.push_back(depth);
+        },
+        [&](const Cube &cube) { post_order.push_back(cube.locational_code()); }));
+
+    ASSERT_EQ(pre_order.size(), 1 + 8 + 8);
+    EXPECT_EQ(pre_order[0], 1);
+    EXPECT_EQ(pre_order[1], 0b1'000);
+    EXPECT_EQ(pre_order[2], 0b1'001);
+    EXPECT_EQ(pre_order[3], 0b1'001'000);
+    EXPECT_EQ(pre_order[11], 0b1'010);
+    EXPECT_EQ(depths[3], 2);
+    EXPECT_EQ(post_order[0], 0b1'000);
+    EXPECT_EQ(post_order[9], 0b1'001);
+    EXPECT_EQ(post_order.back(), 1);
+}
+
+TEST(OctreeTraversal, prune_and_stop) {
+    const auto world = create_random_world(2, {0.0f, 0.0f, 0.0f}, 42);
+
+    // Skipping the children of every octant below the root only visits the root and its children.
+    std::size_t visited = 0;
+    traverse_pre_order(*world, [&](const Cube &, const std::size_t depth) {
+        visited++;
+        return depth == 0 ? TraversalAction::CONTINUE : TraversalAction::SKIP_CHILDREN;
+    });
+    EXPECT_EQ(visited, 1 + 8);
+
+    // Stop at the first geometry cube.
+    visited = 0;
+    const Cube *found = nullptr;
+    EXPECT_FALSE(traverse_pre_order(*world, [&](const Cube &cube) {
+        visited++;
+        if (cube.type() == Cube::Type::SOLID || cube.type() == Cube::Type::NORMAL) {
+            found = &cube;
+            return TraversalAction::STOP;
+        }
+        return TraversalAction::CONTINUE;
+    }));
+    ASSERT_NE(found, nullptr);
+    EXPECT_EQ(found->polygons(true).size(), 12);
+    EXPECT_LE(visited, 1 + 8 + 8 + 8 * 8);
+
+    std::size_t geometry_cubes = 0;
+    EXPECT_TRUE(traverse_post_order(*world, [&](Cube &cube) {
+        geometry_cubes += cube.type() == Cube::Type::SOLID || cube.type() == Cube::Type::NORMAL ? 1 : 0;
+    }));
+    EXPECT_EQ(geometry_cubes, world->count_geometry_cubes());
+}
+
+} // namespace
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <inexor/vulkan-renderer/world/cube.hpp>
+
+#include <span>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Copy the polygons of Cube::polygons(), for comparisons which outlive the next update of the polygon arena.
+inline std::vector<Polygon> flatten(const std::span<const Polygon> polygons) {
+    return {polygons.begin(), polygons.end()};
+}
+
+/// Concatenate the ranges of Cube::lod_polygons() in order.
+inline std::vector<Polygon> flatten(const std::vector<std::span<const Polygon>> &ranges) {
+    std::vector<Polygon> polygons;
+    for (const auto &range : ranges) {
+        polygons.insert(polygons.end(), range.begin(), range.end());
+    }
+    return polygons;
+}
+
+/// Concatenate the polygon caches of OctreeSnapshot::polygons() in order, for comparisons with flat polygon lists.
+inline std::vector<Polygon> flatten(const std::vector<PolygonCache> &caches) {
+    std::vector<Polygon> polygons;
+    for (const auto &cache : caches) {
+        polygons.insert(polygons.end(), cache->begin(), cache->end());
+    }
+    return polygons;
+}
+
+} // namespace inexor::vulkan_renderer::world
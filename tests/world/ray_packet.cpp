@@ -0,0 +1,122 @@
+#include <inexor/vulkan-renderer/tools/thread_pool.hpp>
+#include <inexor/vulkan-renderer/world/collision_query.hpp>
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/ray_packet.hpp>
+
+#include <glm/geometric.hpp>
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace {
+using namespace inexor::vulkan_renderer::world;
+
+/// Compare every ray of a batch with ray_cube_collision_check().
+void expect_same_hits(const Cube &world, const std::vector<glm::vec3> &positions,
+                      const std::vector<glm::vec3> &directions, const std::optional<std::uint32_t> max_depth) {
+    RayHits hits;
+    ray_packet_collision_check(world, positions, directions, hits, max_depth);
+    ASSERT_EQ(hits.size(), positions.size());
+    for (std::size_t idx = 0; idx < positions.size(); idx++) {
+        const auto collision = ray_cube_collision_check(world, positions[idx], directions[idx], max_depth);
+        ASSERT_EQ(hits.cubes[idx] != nullptr, collision.has_value()) << idx;
+        if (!collision) {
+            EXPECT_EQ(hits.distances[idx], std::numeric_limits<float>::infinity());
+            continue;
+        }
+        // The hit point lies on the hit cube and both cubes are entered at the same distance.
+        const glm::vec3 intersection = positions[idx] + hits.distances[idx] * directions[idx];
+        const auto [min, max] = hits.cubes[idx]->bounding_box();
+        for (glm::vec3::length_type axis = 0; axis < 3; axis++) {
+            EXPECT_GE(intersection[axis], min[axis] - 1e-4f);
+            EXPECT_LE(intersection[axis], max[axis] + 1e-4f);
+        }
+        const auto [other_min, other_max] = collision->cube().bounding_box();
+        for (glm::vec3::length_type axis = 0; axis < 3; axis++) {
+            EXPECT_GE(intersection[axis], other_min[axis] - 1e-4f);
+            EXPECT_LE(intersection[axis], other_max[axis] + 1e-4f);
+        }
+    }
+}
+
+TEST(RayPacket, random_rays) {
+    const auto world = create_random_world(4, {-2.0f, 3.0f, 1.0f}, 42);
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> position(-4.0f, 8.0f);
+    std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+    std::uniform_int_distribution<int> zero_axis(0, 5);
+    // Not a multiple of the packet size.
+    std::vector<glm::vec3> positions(1001);
+    std::vector<glm::vec3> directions(positions.size());
+    for (std::size_t idx = 0; idx < positions.size(); idx++) {
+        positions[idx] = glm::vec3(position(generator), position(generator), position(generator)) + world->position();
+        directions[idx] = {direction(generator), direction(generator), direction(generator)};
+        if (const int axis = zero_axis(generator); axis < 3) {
+            directions[idx][axis] = 0.0f;
+        }
+    }
+    directions[0] = glm::vec3(0.0f);
+    expect_same_hits(*world, positions, directions, std::nullopt);
+    expect_same_hits(*world, positions, directions, 2);
+}
+
+TEST(RayPacket, coherent_rays) {
+    const auto world = create_random_world(5, {0.0f, 0.0f, 0.0f}, 13);
+    // The rays of a camera in front of the world, one per pixel. The camera is off center, so no ray passes exactly
+    // through the edges between the cubes, where the hits depend on rounding.
+    const glm::vec3 camera{0.53f, 0.41f, -1.1f};
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> directions;
+    for (int y = 0; y < 32; y++) {
+        for (int x = 0; x < 32; x++) {
+            const glm::vec3 target{(static_cast<float>(x) + 0.5f) / 32.0f, (static_cast<float>(y) + 0.5f) / 32.0f,
+                                   0.0f};
+            positions.push_back(camera);
+            directions.push_back(glm::normalize(target - camera));
+        }
+    }
+    expect_same_hits(*world, positions, directions, std::nullopt);
+}
+
+TEST(RayPacket, parallel) {
+    const auto world = create_random_world(4, {-2.0f, 3.0f, 1.0f}, 42);
+    // The pending rotations are applied before the threads read the octree.
+    (*world)[3]->rotate(Cube::RotationAxis::Y, 2);
+    world->rotate(Cube::RotationAxis::X, 1);
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> position(-4.0f, 8.0f);
+    std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+    std::vector<glm::vec3> positions(3001);
+    std::vector<glm::vec3> directions(positions.size());
+    for (std::size_t idx = 0; idx < positions.size(); idx++) {
+        positions[idx] = glm::vec3(position(generator), position(generator), position(generator)) + world->position();
+        directions[idx] = {direction(generator), direction(generator), direction(generator)};
+    }
+
+    inexor::vulkan_renderer::tools::ThreadPool thread_pool(4);
+    for (const std::size_t rays_per_task : {1, 100, 1024, 4096}) {
+        RayHits parallel_hits;
+        ray_packet_collision_check(thread_pool, *world, positions, directions, parallel_hits, rays_per_task);
+        RayHits hits;
+        ray_packet_collision_check(*world, positions, directions, hits);
+        EXPECT_EQ(parallel_hits.cubes, hits.cubes);
+        EXPECT_EQ(parallel_hits.distances, hits.distances);
+    }
+}
+
+TEST(RayPacket, empty_world) {
+    Cube world(1.0f, {0.0f, 0.0f, 0.0f});
+    const std::vector<glm::vec3> positions{{0.5f, 0.5f, 2.0f}};
+    const std::vector<glm::vec3> directions{{0.0f, 0.0f, -1.0f}};
+    RayHits hits;
+    ray_packet_collision_check(world, positions, directions, hits);
+    ASSERT_EQ(hits.size(), 1);
+    EXPECT_EQ(hits.cubes[0], nullptr);
+
+    world.set_type(Cube::Type::SOLID);
+    ray_packet_collision_check(world, positions, directions, hits);
+    EXPECT_EQ(hits.cubes[0], &world);
+    EXPECT_FLOAT_EQ(hits.distances[0], 1.0f);
+}
+
+} // namespace
@@ -0,0 +1,121 @@
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/sparse_voxel_dag.hpp>
+
+#include "polygons.hpp"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+
+namespace {
+using namespace inexor::vulkan_renderer::world;
+
+/// Create a world whose octants all contain the same random subtree.
+std::shared_ptr<Cube> create_repeated_world() {
+    auto world = std::make_shared<Cube>(8.0f, glm::vec3{0.0f, 0.0f, 0.0f});
+    world->set_type(Cube::Type::OCTANT);
+    for (const auto &child : world->children()) {
+        child->set_type(Cube::Type::OCTANT);
+        const auto pattern = create_random_world(1, {0.0f, 0.0f, 0.0f}, 42);
+        for (std::size_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+            const auto &source = pattern->children()[idx];
+            child->children()[idx]->set_type(source->type());
+            for (std::size_t grandchild = 0; grandchild < Cube::SUB_CUBES && source->type() == Cube::Type::OCTANT;
+                 grandchild++) {
+                const auto &source_grandchild = source->children()[grandchild];
+                child->children()[idx]->children()[grandchild]->set_type(source_grandchild->type());
+                for (std::uint8_t edge = 0; edge < Cube::EDGES && source_grandchild->type() == Cube::Type::NORMAL;
+                     edge++) {
+                    child->children()[idx]->children()[grandchild]->set_indent(
+                        edge, source_grandchild->indentations()[edge]);
+                }
+            }
+        }
+    }
+    return world;
+}
+
+TEST(SparseVoxelDag, deduplication) {
+    const auto world = create_repeated_world();
+    const SparseVoxelDag dag(*world);
+
+    EXPECT_EQ(dag.tree_node_count(), 1 + 8 + 8 * 8 + 8 * 8 * 8);
+    // The eight copies of the subtree are stored once.
+    EXPECT_LT(dag.node_count(), 1 + 8 + 8 * 8);
+    EXPECT_EQ(dag.count_geometry_cubes(), world->count_geometry_cubes());
+    EXPECT_EQ(dag.polygons(), flatten(world->polygons(true)));
+}
+
+TEST(SparseVoxelDag, find_leaf) {
+    const auto world = create_random_world(2, {1.0f, 2.0f, 3.0f}, 7);
+    const SparseVoxelDag dag(*world);
+
+    EXPECT_FALSE(dag.find_leaf({0.0f, 0.0f, 0.0f}));
+    std::vector<std::shared_ptr<Cube>> stack{world};
+    while (!stack.empty()) {
+        const auto cube = stack.back();
+        stack.pop_back();
+        if (cube->type() == Cube::Type::OCTANT) {
+            stack.insert(stack.end(), cube->children().begin(), cube->children().end());
+            continue;
+        }
+        const auto leaf = dag.find_leaf(cube->center());
+        ASSERT_TRUE(leaf);
+        EXPECT_EQ(dag.type(leaf->id), cube->type());
+        EXPECT_EQ(leaf->position, cube->position());
+        EXPECT_EQ(leaf->size, cube->size());
+    }
+}
+
+TEST(SparseVoxelDag, ray_collision) {
+    const auto world = create_random_world(2, {0.0f, 0.0f, 0.0f}, 11);
+    const SparseVoxelDag dag(*world);
+
+    // Compare with the nearest hit among all geometry cubes.
+    const std::array<std::pair<glm::vec3, glm::vec3>, 4> rays{{{{-1.0f, 0.3f, 0.7f}, {1.0f, 0.1f, 0.2f}},
+                                                               {{5.0f, 3.9f, 2.1f}, {-1.0f, -0.4f, 0.0f}},
+                                                               {{2.2f, 2.2f, 9.0f}, {0.0f, 0.0f, -1.0f}},
+                                                               {{2.0f, 2.0f, 2.0f}, {0.3f, -1.0f, 0.5f}}}};
+    for (const auto &[position, direction] : rays) {
+        float nearest = std::numeric_limits<float>::max();
+        std::vector<std::shared_ptr<Cube>> stack{world};
+        while (!stack.empty()) {
+            const auto cube = stack.back();
+            stack.pop_back();
+            if (cube->type() == Cube::Type::OCTANT) {
+                stack.insert(stack.end(), cube->children().begin(), cube->children().end());
+                continue;
+            }
+            if (cube->type() == Cube::Type::EMPTY) {
+                continue;
+            }
+            const auto box = cube->bounding_box();
+            float entry = 0.0f;
+            float exit = std::numeric_limits<float>::max();
+            for (glm::vec3::length_type axis = 0; axis < 3; axis++) {
+                if (direction[axis] == 0.0f) {
+                    if (position[axis] < box[0][axis] || position[axis] > box[1][axis]) {
+                        exit = -1.0f;
+                    }
+                    continue;
+                }
+                const float t0 = (box[0][axis] - position[axis]) / direction[axis];
+                const float t1 = (box[1][axis] - position[axis]) / direction[axis];
+                entry = std::max(entry, std::min(t0, t1));
+                exit = std::min(exit, std::max(t0, t1));
+            }
+            if (entry <= exit) {
+                nearest = std::min(nearest, entry);
+            }
+        }
+
+        const auto collision = dag.ray_collision(position, direction);
+        ASSERT_EQ(collision.has_value(), nearest != std::numeric_limits<float>::max());
+        if (collision) {
+            EXPECT_FLOAT_EQ(collision->distance, nearest);
+            EXPECT_NE(dag.type(collision->location.id), Cube::Type::EMPTY);
+        }
+    }
+}
+
+} // namespace
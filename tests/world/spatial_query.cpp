@@ -0,0 +1,109 @@
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/octree_traversal.hpp>
+#include <inexor/vulkan-renderer/world/spatial_query.hpp>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+namespace {
+using namespace inexor::vulkan_renderer::world;
+
+std::vector<const Cube *> leaves(const Cube &world) {
+    std::vector<const Cube *> leaves;
+    traverse_pre_order(world, [&](const Cube &cube) {
+        if (cube.type() != Cube::Type::OCTANT) {
+            leaves.push_back(&cube);
+        }
+    });
+    return leaves;
+}
+
+/// Whether the boxes overlap or touch.
+bool overlaps(const std::array<glm::vec3, 2> &lhs, const std::array<glm::vec3, 2> &rhs) {
+    for (glm::vec3::length_type axis = 0; axis < 3; axis++) {
+        if (lhs[0][axis] > rhs[1][axis] || rhs[0][axis] > lhs[1][axis]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool contains(const std::array<glm::vec3, 2> &box_bounds, const glm::vec3 &point) {
+    return overlaps(box_bounds, {point, point});
+}
+
+TEST(SpatialQuery, find_leaf) {
+    const auto world = create_random_world(4, {-3.0f, 1.0f, 5.0f}, 42);
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> distribution(-0.5f, 4.5f);
+    for (int idx = 0; idx < 1000; idx++) {
+        const glm::vec3 point = glm::vec3(distribution(generator), distribution(generator), distribution(generator)) +
+                                world->position();
+        const Cube *leaf = find_leaf(std::as_const(*world), point);
+        if (!contains(world->bounding_box(), point)) {
+            EXPECT_EQ(leaf, nullptr);
+            continue;
+        }
+        ASSERT_NE(leaf, nullptr);
+        EXPECT_NE(leaf->type(), Cube::Type::OCTANT);
+        EXPECT_TRUE(contains(leaf->bounding_box(), point));
+    }
+    // The far corner of the world belongs to the last leaf.
+    EXPECT_EQ(find_leaf(*world, world->bounding_box()[1]), leaves(*world).back());
+}
+
+TEST(SpatialQuery, query_box_and_sphere) {
+    const auto world = create_random_world(4, {-3.0f, 1.0f, 5.0f}, 42);
+    const auto all_leaves = leaves(*world);
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> distribution(-0.5f, 4.5f);
+    std::vector<const Cube *> result;
+    for (int idx = 0; idx < 100; idx++) {
+        const glm::vec3 a = glm::vec3(distribution(generator), distribution(generator), distribution(generator));
+        const glm::vec3 b = glm::vec3(distribution(generator), distribution(generator), distribution(generator));
+        const std::array<glm::vec3, 2> box_bounds{world->position() + glm::min(a, b) * 0.5f,
+                                                  world->position() + glm::max(a, b) * 0.5f};
+        std::vector<const Cube *> expected;
+        for (const Cube *leaf : all_leaves) {
+            if (overlaps(leaf->bounding_box(), box_bounds)) {
+                expected.push_back(leaf);
+            }
+        }
+        result.clear();
+        query_box(*world, box_bounds, result);
+        EXPECT_EQ(result, expected);
+
+        const glm::vec3 center = world->position() + a;
+        const float radius = std::abs(b.x) * 0.25f;
+        expected.clear();
+        for (const Cube *leaf : all_leaves) {
+            const auto leaf_bounds = leaf->bounding_box();
+            const glm::vec3 offset = glm::clamp(center, leaf_bounds[0], leaf_bounds[1]) - center;
+            if (glm::dot(offset, offset) <= radius * radius) {
+                expected.push_back(leaf);
+            }
+        }
+        result.clear();
+        query_sphere(*world, center, radius, result);
+        EXPECT_EQ(result, expected);
+    }
+}
+
+TEST(SpatialQuery, touching) {
+    std::shared_ptr<Cube> root = std::make_shared<Cube>(2.0f, glm::vec3{0, 0, 0});
+    root->set_type(Cube::Type::OCTANT);
+    std::vector<const Cube *> result;
+    // A box on the boundary between the children touches both sides.
+    query_box(*root, {glm::vec3{1.0f, 0.5f, 0.5f}, glm::vec3{1.0f, 0.5f, 0.5f}}, result);
+    EXPECT_EQ(result, (std::vector<const Cube *>{root->children()[0].get(), root->children()[4].get()}));
+    result.clear();
+    query_box(*root, {glm::vec3{2.5f, 0.0f, 0.0f}, glm::vec3{3.0f, 1.0f, 1.0f}}, result);
+    EXPECT_TRUE(result.empty());
+    EXPECT_EQ(find_leaf(*root, {1.0f, 0.5f, 0.5f}), root->children()[4].get());
+}
+
+} // namespace
@@ -0,0 +1,74 @@
+#include <inexor/vulkan-renderer/world/collision_query.hpp>
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/world_bvh.hpp>
+
+#include <glm/geometric.hpp>
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+
+namespace {
+using namespace inexor::vulkan_renderer::world;
+
+/// The distance of a collision from the start position of the ray.
+float distance(const RayCubeCollision<Cube> &collision, const glm::vec3 &pos, const glm::vec3 &dir) {
+    if (collision.triangle()) {
+        return collision.triangle()->distance;
+    }
+    return ray_box_entry_distance(collision.cube().bounding_box(), pos, dir).value_or(0.0f);
+}
+
+TEST(WorldBvh, nearest_hit) {
+    // Overlapping worlds of different sizes on a grid.
+    std::vector<std::shared_ptr<Cube>> worlds;
+    for (std::uint32_t idx = 0; idx < 27; idx++) {
+        const glm::vec3 position{static_cast<float>(idx % 3) * 1.5f, static_cast<float>(idx / 3 % 3) * 1.5f,
+                                 static_cast<float>(idx / 9) * 1.5f};
+        auto world = create_random_world(2, position, idx);
+        if (idx % 4 == 0) {
+            // A larger world with a single solid octant.
+            world = std::make_shared<Cube>(2.0f, position);
+            world->set_type(Cube::Type::OCTANT);
+            world->children()[3]->set_type(Cube::Type::SOLID);
+        }
+        worlds.push_back(std::move(world));
+    }
+    const WorldBvh bvh(worlds);
+    EXPECT_EQ(bvh.size(), worlds.size());
+
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> position(-3.0f, 7.0f);
+    std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+    std::size_t hits = 0;
+    for (std::size_t ray = 0; ray < 500; ray++) {
+        const glm::vec3 pos{position(generator), position(generator), position(generator)};
+        const glm::vec3 dir =
+            glm::normalize(glm::vec3{direction(generator), direction(generator), direction(generator)});
+        float nearest = std::numeric_limits<float>::infinity();
+        for (const auto &world : worlds) {
+            if (const auto collision = ray_cube_collision_check(*world, pos, dir)) {
+                nearest = std::min(nearest, distance(*collision, pos, dir));
+            }
+        }
+        const auto collision = bvh.ray_cube_collision_check(pos, dir);
+        ASSERT_EQ(collision.has_value(), nearest != std::numeric_limits<float>::infinity()) << ray;
+        if (collision) {
+            EXPECT_FLOAT_EQ(distance(*collision, pos, dir), nearest) << ray;
+            hits++;
+        }
+    }
+    // Both rays which hit and rays which miss are checked.
+    EXPECT_GT(hits, 0);
+    EXPECT_LT(hits, 500);
+}
+
+TEST(WorldBvh, empty) {
+    const WorldBvh bvh;
+    EXPECT_EQ(bvh.size(), 0);
+    EXPECT_FALSE(bvh.ray_cube_collision_check({0, 0, 0}, {1, 0, 0}).has_value());
+    const WorldBvh empty_worlds({std::make_shared<Cube>(1.0f, glm::vec3{2, 0, 0})});
+    EXPECT_FALSE(empty_worlds.ray_cube_collision_check({0, 0.5f, 0.5f}, {1, 0, 0}).has_value());
+}
+
+} // namespace
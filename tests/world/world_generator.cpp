@@ -0,0 +1,80 @@
+#include <inexor/vulkan-renderer/io/byte_stream.hpp>
+#include <inexor/vulkan-renderer/io/nxoc_parser.hpp>
+#include <inexor/vulkan-renderer/tools/thread_pool.hpp>
+#include <inexor/vulkan-renderer/world/cube.hpp>
+#include <inexor/vulkan-renderer/world/octree_traversal.hpp>
+#include <inexor/vulkan-renderer/world/world_generator.hpp>
+
+#include <gtest/gtest.h>
+
+namespace {
+using namespace inexor::vulkan_renderer;
+using namespace inexor::vulkan_renderer::world;
+
+std::vector<std::uint8_t> serialize(const std::shared_ptr<Cube> &world) {
+    return io::NXOCParser().serialize(world, 0).buffer();
+}
+
+TEST(WorldGenerator, same_result_for_any_thread_count) {
+    for (const auto &heightfield : {std::optional<Heightfield>(), std::optional(Heightfield{})}) {
+        const WorldGenerator generator(42, 3, heightfield);
+        const auto world = generator.generate({-3.0f, 0.0f, 5.0f});
+        const auto expected = serialize(world);
+        for (const std::size_t thread_count : {1, 2, 4}) {
+            tools::ThreadPool thread_pool(thread_count);
+            for (std::size_t split_depth = 0; split_depth <= 5; split_depth++) {
+                const auto parallel_world = generator.generate(thread_pool, split_depth, {-3.0f, 0.0f, 5.0f});
+                EXPECT_EQ(serialize(parallel_world), expected);
+                // The statistics of the subtrees which were filled in parallel reach the root.
+                EXPECT_EQ(parallel_world->statistics().empty_cubes, world->statistics().empty_cubes);
+                EXPECT_EQ(parallel_world->statistics().solid_cubes, world->statistics().solid_cubes);
+                EXPECT_EQ(parallel_world->statistics().normal_cubes, world->statistics().normal_cubes);
+                EXPECT_EQ(parallel_world->statistics().octants, world->statistics().octants);
+                EXPECT_EQ(parallel_world->statistics().depth, world->statistics().depth);
+            }
+        }
+        EXPECT_NE(serialize(WorldGenerator(43, 3, heightfield).generate({-3.0f, 0.0f, 5.0f})), expected);
+    }
+}
+
+TEST(WorldGenerator, random) {
+    std::array<std::size_t, 4> types{};
+    traverse_pre_order(*WorldGenerator(7, 3).generate({0.0f, 0.0f, 0.0f}),
+                       [&](const Cube &cube) { types[static_cast<std::size_t>(cube.type())]++; });
+    EXPECT_EQ(types[static_cast<std::size_t>(Cube::Type::OCTANT)], 1 + 8 + 8 * 8 + 8 * 8 * 8);
+    const std::size_t leaves = 8 * 8 * 8 * 8;
+    EXPECT_NEAR(static_cast<double>(types[static_cast<std::size_t>(Cube::Type::EMPTY)]) / leaves, 0.3, 0.03);
+    EXPECT_NEAR(static_cast<double>(types[static_cast<std::size_t>(Cube::Type::SOLID)]) / leaves, 0.3, 0.03);
+    EXPECT_NEAR(static_cast<double>(types[static_cast<std::size_t>(Cube::Type::NORMAL)]) / leaves, 0.4, 0.03);
+}
+
+TEST(WorldGenerator, heightfield) {
+    const Heightfield heightfield{.base_height = 2.0f, .amplitude = 1.0f};
+    const auto world = WorldGenerator(7, 3, heightfield).generate({0.0f, 0.0f, 0.0f});
+    std::size_t normal_cubes = 0;
+    traverse_pre_order(*world, [&](const Cube &cube) {
+        const float bottom = cube.position().y;
+        const float top = bottom + cube.size();
+        switch (cube.type()) {
+        case Cube::Type::EMPTY:
+            EXPECT_GE(bottom, 1.0f - cube.size());
+            break;
+        case Cube::Type::SOLID:
+            EXPECT_LE(top, 3.0f + cube.size());
+            break;
+        case Cube::Type::NORMAL:
+            // The terrain passes through the leaves.
+            normal_cubes++;
+            EXPECT_EQ(cube.size(), 4.0f / 16.0f);
+            EXPECT_GE(top, 1.0f);
+            EXPECT_LE(bottom, 3.0f);
+            break;
+        case Cube::Type::OCTANT:
+            break;
+        }
+    });
+    // Every column of leaves has the terrain passing through it.
+    EXPECT_GE(normal_cubes, 16 * 16 / 2);
+}
+
+} // namespace